@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rendering/RenderingSubsystem.hpp"
+
+// Textures de la partie R-Type, chargees avant ASSETS_READY.
+// L'ordre compte : la premiere entree d'une cle gagne.
+inline const std::vector<std::pair<std::string, std::string>>&
+GameTextureManifest() {
+  static const std::vector<std::pair<std::string, std::string>> manifest = {
+      {"player", "../assets/player.png"},
+      {"background", "../assets/bg.jpg"},
+      {"enemy1", "../assets/enemy1.png"},
+      {"enemy2", "../assets/enemy2.png"},
+      {"enemy3", "../assets/enemy3.png"},
+      {"enemy4", "../assets/enemy4.png"},
+      {"boom3", "../assets/boom.png"},
+      {"projectile_mini_green", "../assets/shootUp.png"},
+      {"projectile_player", "../assets/bigShoot.png"},
+      {"charged_projectil_palyer", "../assets/charged.png"},
+      {"projectile_enemy", "../assets/bigShoot.png"},
+      {"explosion", "../assets/explosion.png"},
+      {"force", "../assets/force.png"},
+      {"boss2", "../assets/boss2.png"},
+      {"boss3", "../assets/boss3.png"},
+      {"head_boss", "../assets/boss_head.png"},
+      {"enemy5", "../assets/enemy5.png"},
+  };
+  return manifest;
+}
+
+// Charge les textures manquantes du manifeste
+inline void LoadGameTextureManifest(RenderingSubsystem* rendering) {
+  if (!rendering) return;
+  for (const auto& [key, path] : GameTextureManifest()) {
+    if (!rendering->GetTexture(key)) {
+      rendering->LoadTexture(key, path);
+    }
+  }
+}
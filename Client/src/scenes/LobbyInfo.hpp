@@ -12,6 +12,7 @@
 #include "network/NetworkSubsystem.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
+#include "scenes/GameAssets.hpp"
 #include "ui/UIButton.hpp"
 #include "ui/UIImage.hpp"
 #include "ui/UIManager.hpp"
@@ -315,6 +316,15 @@ class LobbyInfoPlayer : public Scene {
         GetSceneData().Set("mapTiles", mapData->tiles);
       }
     }
+    if (e.type == EventType::LOBBY_START) {
+      // Chargement pendant que le serveur attend tous les joueurs
+      if (m_lobbyName != "secondgame") {
+        LoadGameTextureManifest(GetRendering());
+      }
+      uint16_t pId = GetSceneData().Get<uint16_t>("playerId", 0);
+      Action readyAc{ActionType::ASSETS_READY, AssetsReady{pId}};
+      GetNetwork()->SendAction(readyAc);
+    }
     if (e.type == EventType::GAME_START) {
       const auto* data = std::get_if<GAME_START>(&e.data);
       GetSceneData().Set("posX", data->playerSpawnX);
@@ -16,6 +16,7 @@
 #include "rendering/RenderingSubsystem.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
+#include "scenes/GameAssets.hpp"
 #include "settings/MultiplayerSkinManager.hpp"
 #include "systems/BoundsSystem.hpp"
 #include "systems/InputSystem.hpp"
@@ -137,6 +138,7 @@ class MyGameScene : public Scene {
         tilemap.scrollSpeed = m_mapScrollSpeed;
         tilemap.tiles = m_mapTiles;
         tilemap.tileSize = 32;
+        tilemap.rebuildSolidMasks();
         tilemap.scrollOffset = 0.0f;
         tilemap.isLoaded = true;
 
@@ -312,73 +314,7 @@ class MyGameScene : public Scene {
     // }
   }
 
-  void LoadGameTextures() {
-    if (!GetRendering()->GetTexture("player")) {
-      GetRendering()->LoadTexture("player", "../assets/player.png");
-    }
-
-    if (!GetRendering()->GetTexture("background")) {
-      GetRendering()->LoadTexture("background", "../assets/bg.jpg");
-    }
-
-    if (!GetRendering()->GetTexture("enemy1")) {
-      GetRendering()->LoadTexture("enemy1", "../assets/enemy1.png");
-    }
-    if (!GetRendering()->GetTexture("enemy2")) {
-      GetRendering()->LoadTexture("enemy2", "../assets/enemy2.png");
-    }
-    if (!GetRendering()->GetTexture("enemy3")) {
-      GetRendering()->LoadTexture("enemy3", "../assets/enemy3.png");
-    }
-    if (!GetRendering()->GetTexture("enemy4")) {
-      GetRendering()->LoadTexture("enemy4", "../assets/enemy4.png");
-    }
-    if (!GetRendering()->GetTexture("boom3")) {
-      GetRendering()->LoadTexture("boom3", "../assets/boom.png");
-    }
-    if (!GetRendering()->GetTexture("projectile_mini_green")) {
-      GetRendering()->LoadTexture("projectile_mini_green",
-                                  "../assets/shootUp.png");
-    }
-    if (!GetRendering()->GetTexture("projectile_player")) {
-      GetRendering()->LoadTexture("projectile_player",
-                                  "../assets/bigShoot.png");
-    }
-    if (!GetRendering()->GetTexture("charged_projectile_palyer")) {
-      GetRendering()->LoadTexture("charged_projectil_palyer",
-                                  "../assets/charged.png");
-    }
-    if (!GetRendering()->GetTexture("projectile_enemy")) {
-      GetRendering()->LoadTexture("projectile_enemy", "../assets/bigShoot.png");
-    }
-
-    if (!GetRendering()->GetTexture("projectile_player")) {
-      GetRendering()->LoadTexture("projectile_player",
-                                  "../assets/blueShoot.png");
-    }
-    if (!GetRendering()->GetTexture("projectile_enemy")) {
-      GetRendering()->LoadTexture("projectile_enemy",
-                                  "../assets/projectile_enemy.png");
-    }
-    if (!GetRendering()->GetTexture("explosion")) {
-      GetRendering()->LoadTexture("explosion", "../assets/explosion.png");
-    }
-    if (!GetRendering()->GetTexture("force")) {
-      GetRendering()->LoadTexture("force", "../assets/force.png");
-    }
-    if (!GetRendering()->GetTexture("boss2")) {
-      GetRendering()->LoadTexture("boss2", "../assets/boss2.png");
-    }
-    if (!GetRendering()->GetTexture("boss3")) {
-      GetRendering()->LoadTexture("boss3", "../assets/boss3.png");
-    }
-    if (!GetRendering()->GetTexture("head_boss")) {
-      GetRendering()->LoadTexture("head_boss", "../assets/boss_head.png");
-    }
-    if (!GetRendering()->GetTexture("enemy5")) {
-      GetRendering()->LoadTexture("enemy5", "../assets/enemy5.png");
-    }
-  }
+  void LoadGameTextures() { LoadGameTextureManifest(GetRendering()); }
 
   void CreateGameAnimations() {
     GetRendering()->CreateAnimation("enemy1_anim", "enemy1",
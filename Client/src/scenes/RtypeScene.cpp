@@ -2,12 +2,14 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Collision/Collision.hpp"
 #include "Movement/Movement.hpp"
 #include "ecs/Zipper.hpp"
 #include "network/DataMask.hpp"
+#include "scene/SceneKeys.hpp"
 #include "systems/BoundsSystem.hpp"
 #include "systems/ChargedShoot.hpp"
 #include "systems/ForceCtrl.hpp"
@@ -31,6 +33,7 @@ void RtypeScene::OnEnter() {
   }
 
   m_players.clear();
+  m_inputs = data.Get<PlayerInputBuffers*>("player_inputs", nullptr);
   currentLevelIndex = 0;
   waitingForNextLevel = false;
   levelTransitionTimer = 0.0f;
@@ -68,6 +71,7 @@ void RtypeScene::OnEnter() {
   mapEntity =
       createMapEntity(GetRegistry(), currentMap.width, currentMap.height,
                       currentMap.scrollSpeed, currentMap.tiles);
+  m_activeMap = ActiveTileMap{};
   mapSent = false;
 
   MapData mapData;
@@ -120,11 +124,10 @@ void RtypeScene::OnExit() {
   SceneData& data = GetSceneData();
   data.Remove("game_ended");
   data.Remove("victory");
-  data.Remove("game_state");
-  data.Remove("force_state");
+  data.Remove(SceneKeys::GAME_STATE);
+  data.Remove(SceneKeys::FORCE_STATE);
   data.Remove("send_map");
-  data.Remove("last_input_event");
-  data.Remove("last_input_player");
+  m_inputs = nullptr;
 
   std::cout << "[RtypeScene] OnExit complete" << std::endl;
 }
@@ -136,33 +139,30 @@ void RtypeScene::Update(float deltaTime) {
 }
 
 void RtypeScene::ReceivePlayerInputs() {
-  SceneData& data = GetSceneData();
-
-  if (data.Has("last_input_event")) {
-    Event event = data.Get<Event>("last_input_event");
-    uint16_t playerId = data.Get<uint16_t>("last_input_player");
-
-    if (event.type == EventType::PLAYER_INPUT) {
-      const PLAYER_INPUT& input = std::get<PLAYER_INPUT>(event.data);
-
-      auto& players = GetRegistry().get_components<PlayerEntity>();
-      auto& states = GetRegistry().get_components<InputState>();
-
-      for (auto&& [player, state] : Zipper(players, states)) {
-        if (player.player_id != playerId) continue;
+  if (!m_inputs) return;
 
-        state.moveLeft = input.left;
-        state.moveRight = input.right;
-        state.moveDown = input.down;
-        state.moveUp = input.up;
-        state.action1 = input.fire;
-        break;
-      }
-    }
+  auto& states = GetRegistry().get_components<InputState>();
 
-    data.Remove("last_input_event");
-    data.Remove("last_input_player");
-  }
+  // Toutes les entrees dues a ce tick sont appliquees dans l'ordre : la
+  // derniere fixe la direction, un tir dans n'importe laquelle est garde
+  bool firstOfPlayer = true;
+  uint16_t lastPlayer = 0;
+  m_inputs->consume([&](uint16_t playerId, const StampedInput& in) {
+    bool sameTick = !firstOfPlayer && playerId == lastPlayer;
+    firstOfPlayer = false;
+    lastPlayer = playerId;
+
+    auto it = m_players.find(playerId);
+    if (it == m_players.end()) return;
+    auto& state = states[it->second];
+    if (!state) return;
+
+    state->moveLeft = in.input.left;
+    state->moveRight = in.input.right;
+    state->moveDown = in.input.down;
+    state->moveUp = in.input.up;
+    state->action1 = in.input.fire || (sameTick && state->action1);
+  });
 }
 
 void RtypeScene::UpdateGameState(float deltaTime) {
@@ -274,8 +274,10 @@ void RtypeScene::UpdateGameState(float deltaTime) {
   charged_shoot_system(GetRegistry(), deltaTime);
   physics_movement_system(GetRegistry(), transforms, rigidbodies, deltaTime,
                           {0, 0});
+  m_playerGrid.Rebuild(transforms, players,
+                       [](const PlayerEntity& p) { return p.isAlive; });
   enemy_movement_system(GetRegistry(), transforms, rigidbodies, enemies,
-                        players, deltaTime);
+                        m_playerGrid, deltaTime);
   uint8_t diff = data.Get<uint8_t>("difficulty", 1);
   boss_movement_system(GetRegistry(), transforms, rigidbodies, bosses,
                        deltaTime, diff);
@@ -298,8 +300,14 @@ void RtypeScene::UpdateGameState(float deltaTime) {
       },
       deltaTime);
 
+  // Le decor defile comme chez le client, pour que les tirs touchent les
+  // tuiles la ou elles sont affichees
+  if (TileMap* map = resolve_active_tilemap(GetRegistry(), m_activeMap)) {
+    map->update(deltaTime);
+  }
+  tilemap_projectile_collision_system(GetRegistry(), m_activeMap, deltaTime);
   projectile_collision_system(GetRegistry(), transforms, colliders,
-                              projectiles);
+                              projectiles, deltaTime);
   projectile_lifetime_system(GetRegistry(), projectiles, deltaTime);
   gamePlay_Collision_system(GetRegistry(), transforms, colliders, players,
                             enemies, bosses);
@@ -430,9 +438,9 @@ void RtypeScene::BuildCurrentState() {
     fs.posX = transform.position.x;
     fs.posY = transform.position.y;
     fs.state = static_cast<uint8_t>(force.state);
-    data.Set("force_state", fs);
+    data.Set(SceneKeys::FORCE_STATE, fs);
   }
-  data.Set("game_state", gs);
+  data.Set(SceneKeys::GAME_STATE, std::move(gs));
 }
 
 void RtypeScene::HandleEvent(SDL_Event& event) {}
@@ -1,6 +1,4 @@
 #pragma once
-#include <SDL2/SDL.h>
-
 #include <iostream>
 #include <memory>
 #include <string>
@@ -8,21 +6,18 @@
 #include <unordered_set>
 #include <vector>
 
+#include "Collision/MapCollisionSystem.hpp"
 #include "Helpers/EntityHelper.hpp"
 #include "Player/PlayerEntity.hpp"
-#include "audio/AudioSubsystem.hpp"
 #include "components/TileMap.hpp"
-#include "network/NetworkSubsystem.hpp"
-#include "rendering/RenderingSubsystem.hpp"
+#include "network/Action.hpp"
+#include "network/Event.hpp"
+#include "network/PlayerInputBuffer.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
-#include "settings/MultiplayerSkinManager.hpp"
-#include "systems/InputSystem.hpp"
 #include "systems/ProjectileSystem.hpp"
+#include "systems/SpatialQuery.hpp"
 #include "systems/WeaponSystem.hpp"
-#include "ui/UIManager.hpp"
-#include "ui/UISolidColor.hpp"
-#include "ui/UIText.hpp"
 
 class RtypeScene : public Scene {
  private:
@@ -39,6 +34,9 @@ class RtypeScene : public Scene {
   std::unordered_map<uint16_t, uint32_t> playerScores;
   std::unordered_map<uint16_t, std::shared_ptr<GameState>> lastStates;
   std::unordered_map<uint16_t, int> playerStateCount;
+  SpatialGrid m_playerGrid;
+  ActiveTileMap m_activeMap;
+  PlayerInputBuffers* m_inputs = nullptr;
 
   void ReceivePlayerInputs();
   void UpdateGameState(float deltaTime);
@@ -3,9 +3,10 @@
 #include "scene/SceneManager.hpp"
 #include "ecs/Registry.hpp"
 #include "network/DataMask.hpp"
-#include "input/InputSubsystem.hpp"
+#include "input/InputState.hpp"
 #include "network/Action.hpp"
 #include "network/Event.hpp"
+#include "scene/SceneKeys.hpp"
 
 SecondGame::SecondGame() { 
     m_name = "secondgame"; 
@@ -17,6 +18,7 @@ void SecondGame::OnEnter() {
         "players_list",
         std::vector<std::tuple<uint16_t, bool, std::string>>()
     );
+    m_inputs = data.Get<PlayerInputBuffers*>("player_inputs", nullptr);
     
     GetRegistry().register_component<Transform>();
     GetRegistry().register_component<RigidBody>();
@@ -89,6 +91,7 @@ void SecondGame::OnEnter() {
 
 void SecondGame::OnExit() {
     m_players.clear();
+    m_inputs = nullptr;
     roundWins.clear();
 }
 
@@ -122,32 +125,21 @@ void SecondGame::Update(float deltaTime) {
 }
 
 void SecondGame::ReceivePlayerInputs() {
-    SceneData& data = GetSceneData();
-    
-    if (data.Has("last_input_event")) {
-        Event event = data.Get<Event>("last_input_event");
-        uint16_t playerId = data.Get<uint16_t>("last_input_player");
-        
-        if (event.type == EventType::PLAYER_INPUT) {
-            const PLAYER_INPUT& input = std::get<PLAYER_INPUT>(event.data);
-            
-            auto& players = GetRegistry().get_components<PlayerEntity>();
-            auto& states = GetRegistry().get_components<InputState>();
-            
-            for (auto&& [player, state] : Zipper(players, states)) {
-                if (player.player_id != playerId) continue;
-                
-                state.moveLeft = input.left;
-                state.moveRight = input.right;
-                state.moveUp = input.up;
-                state.action1 = input.fire;
-                break;
-            }
-        }
-        
-        data.Remove("last_input_event");
-        data.Remove("last_input_player");
-    }
+    if (!m_inputs) return;
+
+    auto& states = GetRegistry().get_components<InputState>();
+
+    m_inputs->consume([&](uint16_t playerId, const StampedInput& in) {
+        auto it = m_players.find(playerId);
+        if (it == m_players.end()) return;
+        auto& state = states[it->second];
+        if (!state) return;
+
+        state->moveLeft = in.input.left;
+        state->moveRight = in.input.right;
+        state->moveUp = in.input.up;
+        state->action1 = in.input.fire;
+    });
 }
 
 void SecondGame::UpdateFighterStates(float deltaTime) {
@@ -459,7 +451,7 @@ void SecondGame::BuildCurrentState() {
     }
     
     SceneData& data = GetSceneData();
-    data.Set("game_state", gs);
+    data.Set(SceneKeys::GAME_STATE, std::move(gs));
 }
 
 void SecondGame::HandleEvent(SDL_Event& event) {}
@@ -1,11 +1,11 @@
 #pragma once
-#include <SDL2/SDL.h>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "scene/Scene.hpp"
 #include "Player/PlayerEntity.hpp"
+#include "network/PlayerInputBuffer.hpp"
 #include "physics/Physics2D.hpp"
 
 // Simplified fighter states
@@ -44,6 +44,7 @@ struct HitBox {
 class SecondGame : public Scene {
 private:
     std::unordered_map<uint16_t, Entity> m_players;
+    PlayerInputBuffers* m_inputs = nullptr;
     
     const float ARENA_LEFT = 50.0f;
     const float ARENA_RIGHT = 750.0f;
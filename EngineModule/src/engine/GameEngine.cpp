@@ -1,5 +1,7 @@
 #include "engine/GameEngine.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -13,9 +15,8 @@
 #include "Player/PlayerEntity.hpp"
 #include "Player/Projectile.hpp"
 #include "Player/Weapon.hpp"
-#include "input/InputSubsystem.hpp"
+#include "input/InputState.hpp"
 #include "physics/Physics2D.hpp"
-#include "rendering/RenderingSubsystem.hpp"
 
 GameEngine::GameEngine()
     : m_running(false),
@@ -128,6 +129,31 @@ bool GameEngine::HasSubsystem(SubsystemType type) const {
   return m_subsystems.find(type) != m_subsystems.end();
 }
 
+#ifdef ENGINE_HEADLESS
+// Build serveur : pas de SDL, la boucle se cadence sur steady_clock et il n'y
+// a aucun evenement fenetre/clavier a traiter
+void GameEngine::Run() {
+  m_running = true;
+  auto lastTime = std::chrono::steady_clock::now();
+
+  std::cout << "Starting headless main loop..." << std::endl;
+
+  while (m_running) {
+    auto currentTime = std::chrono::steady_clock::now();
+    m_deltaTime =
+        std::chrono::duration<float>(currentTime - lastTime).count();
+    lastTime = currentTime;
+
+    if (m_deltaTime > 0.05f) {
+      m_deltaTime = 0.05f;
+    }
+
+    Update(m_deltaTime);
+  }
+
+  std::cout << "Main loop ended" << std::endl;
+}
+#else
 void GameEngine::Run() {
   m_running = true;
   Uint32 lastTime = SDL_GetTicks();
@@ -149,6 +175,7 @@ void GameEngine::Run() {
 
   std::cout << "Main loop ended" << std::endl;
 }
+#endif
 
 void GameEngine::Update(float deltaTime) {
   for (SubsystemType type : m_updateOrder) {
@@ -164,6 +191,7 @@ void GameEngine::Update(float deltaTime) {
 }
 
 void GameEngine::HandleEvents() {
+#ifndef ENGINE_HEADLESS
   SDL_Event event;
   while (SDL_PollEvent(&event)) {
     if (event.type == SDL_QUIT) {
@@ -176,6 +204,7 @@ void GameEngine::HandleEvents() {
       m_sceneManager->HandleEvent(event);
     }
   }
+#endif
 }
 
 void GameEngine::Shutdown() {
@@ -2,15 +2,25 @@
 
 #include <string>
 
-#include "audio/AudioSubsystem.hpp"
 #include "engine/GameEngine.hpp"
+#include "scene/SceneManager.hpp"
+#ifndef ENGINE_HEADLESS
+#include "audio/AudioSubsystem.hpp"
 #include "input/InputSubsystem.hpp"
 #include "network/NetworkSubsystem.hpp"
 #include "rendering/RenderingSubsystem.hpp"
-#include "scene/SceneManager.hpp"
+#endif
 
 Registry& Scene::GetRegistry() { return m_engine->GetRegistry(); }
 
+#ifdef ENGINE_HEADLESS
+// Le build headless ne charge aucun subsystem client
+RenderingSubsystem* Scene::GetRendering() { return nullptr; }
+AudioSubsystem* Scene::GetAudio() { return nullptr; }
+InputSubsystem* Scene::GetInput() { return nullptr; }
+NetworkSubsystem* Scene::GetNetwork() { return nullptr; }
+UIManager* Scene::GetUI() { return nullptr; }
+#else
 RenderingSubsystem* Scene::GetRendering() {
   return dynamic_cast<RenderingSubsystem*>(
       m_engine->GetSubsystem(SubsystemType::RENDERING));
@@ -35,6 +45,7 @@ UIManager* Scene::GetUI() {
   auto* rendering = GetRendering();
   return rendering ? rendering->GetUIManager() : nullptr;
 }
+#endif
 
 SceneData& Scene::GetSceneData() { return m_sceneManager->GetSceneData(); }
 
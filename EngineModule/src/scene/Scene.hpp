@@ -1,5 +1,9 @@
 #pragma once
+#ifdef ENGINE_HEADLESS
+union SDL_Event;
+#else
 #include <SDL2/SDL.h>
+#endif
 
 #include <string>
 #include <unordered_map>
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "network/Action.hpp"
+#include "scene/SceneManager.hpp"
+
+/**
+ * @brief Typed SceneData keys shared by the server and the game scenes
+ */
+namespace SceneKeys {
+/// Snapshot of the world published by the game scene once per tick
+inline constexpr SceneKey<GameState> GAME_STATE{"game_state"};
+/// Last Force state built by the game scene
+inline constexpr SceneKey<ForceState> FORCE_STATE{"force_state"};
+}  // namespace SceneKeys
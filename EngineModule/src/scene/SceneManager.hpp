@@ -1,5 +1,9 @@
 #pragma once
+#ifdef ENGINE_HEADLESS
+union SDL_Event;
+#else
 #include <SDL2/SDL.h>
+#endif
 
 #ifdef _WIN32
     #include <winsock2.h>
@@ -9,10 +13,14 @@
 #endif
 
 #include <any>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <typeindex>
 #include <unordered_map>
+#include <utility>
 
 #include "dynamicLibLoader/DLLoader.hpp"
 #include "ecs/Registry.hpp"
@@ -21,11 +29,102 @@ class GameEngine;
 class Scene;
 class RenderingSubsystem;
 
+/**
+ * @brief FNV-1a hash of a SceneData key, evaluated at compile time for
+ * SceneKey constants
+ */
+constexpr uint64_t HashSceneKey(std::string_view name) {
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Typed handle of a SceneData slot
+ *
+ * The key is hashed once at compile time, lookups never hash a string and
+ * the value type is carried by the handle.
+ */
+template <typename T>
+struct SceneKey {
+  constexpr explicit SceneKey(std::string_view keyName)
+      : name(keyName), hash(HashSceneKey(keyName)) {}
+
+  std::string_view name;
+  uint64_t hash;
+};
+
 class SceneData {
  private:
+  struct Slot {
+    std::shared_ptr<const void> value;
+    std::type_index type = typeid(void);
+  };
+
   std::unordered_map<std::string, std::any> m_data;
+  std::unordered_map<uint64_t, Slot> m_slots;
+
+  template <typename T>
+  const Slot* FindSlot(const SceneKey<T>& key) const {
+    auto it = m_slots.find(key.hash);
+    if (it == m_slots.end()) return nullptr;
+    if (it->second.type != typeid(T)) {
+      std::cerr << "SceneData: Type mismatch for key '" << key.name << "'"
+                << std::endl;
+      return nullptr;
+    }
+    return &it->second;
+  }
 
  public:
+  /**
+   * @brief Publish an immutable value, readers holding the previous one keep
+   * it alive
+   */
+  template <typename T>
+  void Publish(const SceneKey<T>& key, std::shared_ptr<const T> value) {
+    m_slots[key.hash] = Slot{std::move(value), typeid(T)};
+  }
+
+  template <typename T>
+  void Set(const SceneKey<T>& key, T value) {
+    Publish(key, std::make_shared<const T>(std::move(value)));
+  }
+
+  /**
+   * @brief Shared handle on the current value, nullptr if absent
+   */
+  template <typename T>
+  std::shared_ptr<const T> GetShared(const SceneKey<T>& key) const {
+    const Slot* slot = FindSlot(key);
+    if (!slot) return nullptr;
+    return std::static_pointer_cast<const T>(slot->value);
+  }
+
+  /**
+   * @brief Reference to the current value without copy, valid until the key
+   * is set again. Returns a default value if absent.
+   */
+  template <typename T>
+  const T& GetRef(const SceneKey<T>& key) const {
+    static const T empty{};
+    const Slot* slot = FindSlot(key);
+    return slot ? *static_cast<const T*>(slot->value.get()) : empty;
+  }
+
+  template <typename T>
+  bool Has(const SceneKey<T>& key) const {
+    return m_slots.find(key.hash) != m_slots.end();
+  }
+
+  template <typename T>
+  void Remove(const SceneKey<T>& key) {
+    m_slots.erase(key.hash);
+  }
+
   template <typename T>
   void Set(const std::string& key, const T& value) {
     m_data[key] = value;
@@ -49,7 +148,10 @@ class SceneData {
     return m_data.find(key) != m_data.end();
   }
 
-  void Clear() { m_data.clear(); }
+  void Clear() {
+    m_data.clear();
+    m_slots.clear();
+  }
   void Remove(const std::string& key) { m_data.erase(key); }
 };
 
@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @brief Movement and action flags of a player, independent of SDL so the
+ * headless server simulation can use it
+ */
+struct InputState {
+  bool moveLeft;
+  bool moveRight;
+  bool moveUp;
+  bool moveDown;
+  bool action1;
+  bool action2;
+
+  InputState()
+      : moveLeft(false),
+        moveRight(false),
+        moveUp(false),
+        moveDown(false),
+        action1(false),
+        action2(false) {}
+};
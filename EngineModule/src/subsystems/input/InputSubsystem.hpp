@@ -6,26 +6,10 @@
 #include <unordered_map>
 
 #include "engine/ISubsystem.hpp"
+#include "input/InputState.hpp"
 #include "input/KeyBindings.hpp"
 #include "input/input_export.hpp"
 
-struct InputState {
-  bool moveLeft;
-  bool moveRight;
-  bool moveUp;
-  bool moveDown;
-  bool action1;
-  bool action2;
-
-  InputState()
-      : moveLeft(false),
-        moveRight(false),
-        moveUp(false),
-        moveDown(false),
-        action1(false),
-        action2(false) {}
-};
-
 struct InputBinding {
   std::string action;
   SDL_Keycode key;
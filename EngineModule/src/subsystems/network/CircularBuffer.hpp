@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <utility>
 #include <vector>
 
 template <typename T>
@@ -21,8 +22,8 @@ class CircularBuffer {
 
   bool isFull() { return m_nbItem == m_maxItem; }
 
-  void push(const T &item) {
-    m_buffer[m_lastItemIndex] = item;
+  void push(T item) {
+    m_buffer[m_lastItemIndex] = std::move(item);
     m_lastItemIndex++;
     if (m_lastItemIndex == m_maxItem) {
       m_lastItemIndex = 0;
@@ -43,7 +44,7 @@ class CircularBuffer {
       return std::nullopt;
     }
 
-    T item = m_buffer[m_firstItemIndex];
+    T item = std::move(m_buffer[m_firstItemIndex]);
     m_firstItemIndex++;
     if (m_firstItemIndex == m_maxItem) {
       m_firstItemIndex = 0;
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstring>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -138,7 +139,7 @@ int NetworkSubsystem::ConnectUDP() {
   }
 }
 
-Event NetworkSubsystem::DecodePacket(std::vector<uint8_t>& packet) {
+Event NetworkSubsystem::DecodePacket(ByteView packet) {
   return decoder.decode(packet);
 }
 
@@ -170,17 +171,25 @@ void NetworkSubsystem::ProcessTCPRecvBuffer() {
       return;
     }
 
-    std::vector<uint8_t> packet(recvTcpBuffer.begin(),
-                                recvTcpBuffer.begin() + 6 + packetSize);
+    // Decode sur place, avant de retirer le paquet du buffer
+    Event evt =
+        DecodePacket(ByteView(recvTcpBuffer.data(), 6 + packetSize));
 
     recvTcpBuffer.erase(recvTcpBuffer.begin(),
                         recvTcpBuffer.begin() + 6 + packetSize);
 
-    Event evt = DecodePacket(packet);
-
     std::cout << "[TCP DEBUG] Decoded event type: "
               << static_cast<int>(evt.type) << std::endl;
 
+    if (evt.type == EventType::GAME_START || evt.type == EventType::GAME_END) {
+      snapshots.Reset();
+    }
+    if (auto* state = std::get_if<GAME_STATE>(&evt.data)) {
+      if (snapshots.Receive(*state) != SnapshotReceiver::Result::DISPLAY) {
+        continue;
+      }
+    }
+
     if (evt.type == EventType::LOGIN_RESPONSE) {
       const auto* input = std::get_if<LOGIN_RESPONSE>(&evt.data);
       if (!input) return;
@@ -193,7 +202,7 @@ void NetworkSubsystem::ProcessTCPRecvBuffer() {
     }
 
     std::lock_guard<std::mutex> lock(mut);
-    eventBuffer.push(evt);
+    eventBuffer.push(std::move(evt));
   }
 }
 
@@ -247,48 +256,33 @@ void NetworkSubsystem::ReadTCP() {
 }*/
 
 void NetworkSubsystem::ReadUDP() {
-  char tempBuffer[2048];
+  uint8_t tempBuffer[2048];
 
   asio::error_code error;
   size_t bytesReceived =
       udpSocket.receive(asio::buffer(tempBuffer, sizeof(tempBuffer)), 0, error);
 
   if (!error && bytesReceived > 0) {
-    std::vector<uint8_t> packet(tempBuffer, tempBuffer + bytesReceived);
+    ByteView packet(tempBuffer, bytesReceived);
+    if (fragment::isFragment(packet)) {
+      ReadFragment(packet);
+      return;
+    }
     Event evt = DecodePacket(packet);
     std::lock_guard<std::mutex> lock(mut);
-    uint16_t newSeq = evt.seqNum;
-    bool isDuplicate = false;
-
-    if (newSeq == ack) {
-      isDuplicate = true;
-    } else if (static_cast<uint16_t>(newSeq - ack) < 32768) {
-      uint16_t shift = newSeq - ack;
-      if (shift < 32) {
-        ack_bits <<= shift;
-        ack_bits |= (1 << (shift - 1));
-      } else {
-        ack_bits = 0;
-      }
-      ack = newSeq;
-    } else {
-      uint16_t shift = ack - newSeq;
-      if (shift > 0 && shift <= 32) {
-        if (ack_bits & (1 << (shift - 1))) {
-          isDuplicate = true;
-        }
-        ack_bits |= (1 << (shift - 1));
-      } else {
-        isDuplicate = true;
-      }
+    if (evt.type == EventType::GAME_START || evt.type == EventType::GAME_END) {
+      snapshots.Reset();
     }
-    clientHistory.erase(evt.ack);
-    for (int i = 0; i < 32; ++i) {
-      if (evt.ack_bits & (1 << i)) {
-        clientHistory.erase(static_cast<uint16_t>(evt.ack - (i + 1)));
-      }
+    // Un delta dont la reference manque n'est pas acquitte : le serveur
+    // repassera a un etat complet
+    bool display = true;
+    if (auto* state = std::get_if<GAME_STATE>(&evt.data)) {
+      SnapshotReceiver::Result res = snapshots.Receive(*state);
+      if (res == SnapshotReceiver::Result::MISSING_BASELINE) return;
+      display = res == SnapshotReceiver::Result::DISPLAY;
     }
-    if (!isDuplicate) eventBuffer.push(evt);
+    bool isDuplicate = RecordReceived(evt.seqNum, evt.ack, evt.ack_bits);
+    if (!isDuplicate && display) eventBuffer.push(std::move(evt));
   } else if (error == asio::error::eof) {
     std::cout << "UDP server disconnected" << std::endl;
     udpConnected = false;
@@ -301,6 +295,105 @@ void NetworkSubsystem::ReadUDP() {
   }
 }
 
+void NetworkSubsystem::ReadFragment(ByteView packet) {
+  fragment::Header header;
+  if (!fragment::parse(packet, header)) return;
+
+  std::lock_guard<std::mutex> lock(mut);
+  // Chaque fragment est acquitte : seuls les manquants seront renvoyes
+  RecordReceived(header.seq, header.ack, header.ackBits);
+
+  auto now = std::chrono::steady_clock::now();
+  fragments.expire(now);
+  std::optional<std::vector<uint8_t>> whole = fragments.add(packet, now);
+  if (!whole) return;
+
+  Event evt = DecodePacket(*whole);
+  if (evt.type == EventType::GAME_START || evt.type == EventType::GAME_END) {
+    snapshots.Reset();
+  }
+  if (auto* state = std::get_if<GAME_STATE>(&evt.data)) {
+    if (snapshots.Receive(*state) != SnapshotReceiver::Result::DISPLAY) return;
+  }
+  eventBuffer.push(std::move(evt));
+}
+
+bool NetworkSubsystem::RecordReceived(uint16_t seq, uint16_t peerAck,
+                                      uint32_t peerAckBits) {
+  bool isDuplicate = false;
+
+  if (seq == ack) {
+    isDuplicate = true;
+  } else if (static_cast<uint16_t>(seq - ack) < 32768) {
+    uint16_t shift = seq - ack;
+    if (shift < 32) {
+      ack_bits <<= shift;
+      ack_bits |= (1 << (shift - 1));
+    } else {
+      ack_bits = 0;
+    }
+    ack = seq;
+  } else {
+    uint16_t shift = ack - seq;
+    if (shift > 0 && shift <= 32) {
+      if (ack_bits & (1 << (shift - 1))) {
+        isDuplicate = true;
+      }
+      ack_bits |= (1 << (shift - 1));
+    } else {
+      isDuplicate = true;
+    }
+  }
+  clientHistory.erase(peerAck);
+  for (int i = 0; i < 32; ++i) {
+    if (peerAckBits & (1 << i)) {
+      clientHistory.erase(static_cast<uint16_t>(peerAck - (i + 1)));
+    }
+  }
+  return isDuplicate;
+}
+
+void NetworkSubsystem::SendUdpMessage(std::vector<uint8_t>& packet,
+                                      bool reliable) {
+  size_t count = fragment::countFor(packet);
+  if (count == 0) {
+    std::cerr << "UDP packet of " << packet.size()
+              << " bytes too big to be fragmented, dropped\n";
+    return;
+  }
+  if (count == 1) {
+    if (reliable) {
+      uint16_t s = fragment::readU16(&packet[6]);
+      std::lock_guard<std::mutex> lock(mut);
+      clientHistory[s] = {s, packet, std::chrono::steady_clock::now(), 0};
+    }
+    SendUdp(packet);
+    return;
+  }
+
+  // Un numero de sequence par fragment, le premier reprend celui du paquet
+  uint16_t s = fragment::readU16(&packet[6]);
+  uint16_t id;
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    id = messageId++;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      std::lock_guard<std::mutex> lock(mut);
+      s = ++seqNum;
+    }
+    fragment::make(packet, id, static_cast<uint8_t>(i),
+                   static_cast<uint8_t>(count), s, fragmentBuffer);
+    if (reliable) {
+      std::lock_guard<std::mutex> lock(mut);
+      clientHistory[s] = {s, fragmentBuffer, std::chrono::steady_clock::now(),
+                          0};
+    }
+    SendUdp(fragmentBuffer);
+  }
+}
+
 void NetworkSubsystem::SendUdp(std::vector<uint8_t>& packet) {
   if (!udpConnected || !udpSocket.is_open()) return;
 
@@ -374,16 +467,12 @@ void NetworkSubsystem::SendActionServer() {
         a = ack;
         ab = ack_bits;
       }
-      std::vector<uint8_t> packet = encoder.encode(action, protocol, s, a, ab);
-      if (protocol == 1) {
-        std::lock_guard<std::mutex> lock(mut);
-        clientHistory[s] = {s, packet, std::chrono::steady_clock::now(), 0};
-      }
-      SendUdp(packet);
+      encoder.encodeInto(action, action.type, protocol, s, a, ab, sendBuffer);
+      SendUdpMessage(sendBuffer, protocol == 1);
       sent = true;
     } else if (protocol == 2 && tcpConnected) {
-      std::vector<uint8_t> packet = encoder.encode(action, protocol, 0, 0, 0);
-      SendTcp(packet);
+      encoder.encodeInto(action, action.type, protocol, 0, 0, 0, sendBuffer);
+      SendTcp(sendBuffer);
       sent = true;
     }
 
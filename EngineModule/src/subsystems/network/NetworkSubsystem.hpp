@@ -15,6 +15,8 @@
 #include "network/Decoder.hpp"
 #include "network/Encoder.hpp"
 #include "network/Event.hpp"
+#include "network/Fragment.hpp"
+#include "network/SnapshotReceiver.hpp"
 #include "network/network_export.hpp"
 
 class NETWORK_API NetworkSubsystem : public ISubsystem {
@@ -82,8 +84,24 @@ class NETWORK_API NetworkSubsystem : public ISubsystem {
 
   void ReadTCP();
   void ReadUDP();
+  /**
+   * @brief Store a received fragment, deliver its message once complete
+   */
+  void ReadFragment(ByteView packet);
+  /**
+   * @brief Update the acks with a received sequence number and drop the
+   * reliable packets acknowledged by the server, mut held
+   * @return true if the sequence number was already received
+   */
+  bool RecordReceived(uint16_t seq, uint16_t peerAck, uint32_t peerAckBits);
 
   void SendUdp(std::vector<uint8_t>& packet);
+  /**
+   * @brief Send an encoded UDP packet, split in fragments when it does not
+   * fit in one datagram
+   * @param reliable Keep each datagram for resending until acknowledged
+   */
+  void SendUdpMessage(std::vector<uint8_t>& packet, bool reliable);
   // void SendACK(std::vector<uint8_t>& evt);
   void SendTcp(std::vector<uint8_t>& packet);
 
@@ -92,15 +110,21 @@ class NETWORK_API NetworkSubsystem : public ISubsystem {
   void ProcessTCPRecvBuffer();
 
   Decoder decoder;
-  Event DecodePacket(std::vector<uint8_t>& packet);
+  Event DecodePacket(ByteView packet);
   void HandleRetransmission();
 
   std::vector<uint8_t> recvTcpBuffer;
   CircularBuffer<Event> eventBuffer;
+  SnapshotReceiver snapshots;  ///< Rebuilds GAME_STATE from its baseline
+  FragmentAssembler fragments;  ///< Fragmented messages being received
+  uint16_t messageId = 0;       ///< Id of the next fragmented message
 
   CircularBuffer<Action> actionBuffer;
 
   Encoder encoder;
+  /// Reused by each send, the sockets are written synchronously
+  std::vector<uint8_t> sendBuffer;
+  std::vector<uint8_t> fragmentBuffer;
   // uint32_t sequenceNumUdp = 0;
   // uint32_t sequenceNumTcp = 0;
   void SendActionServer();
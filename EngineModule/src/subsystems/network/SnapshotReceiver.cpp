@@ -0,0 +1,192 @@
+#include "network/SnapshotReceiver.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "network/DataMask.hpp"
+
+namespace {
+
+bool Newer(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+
+/**
+ * @brief Apply the entities of a delta to those of its baseline
+ *
+ * Known entities get the masked fields of the delta, new ones are added as
+ * received and M_DELETE entries remove them. The mask of a rebuilt entity
+ * lists every field known so far.
+ */
+template <typename T, typename IdOf, typename Merge>
+std::vector<T> ApplyDelta(const std::vector<T>& base,
+                          const std::vector<T>& delta, IdOf idOf,
+                          Merge merge) {
+  std::vector<T> result = base;
+  std::vector<bool> removed(result.size(), false);
+  std::unordered_map<uint16_t, size_t> index;
+  index.reserve(result.size() + delta.size());
+  for (size_t i = 0; i < result.size(); ++i) index.emplace(idOf(result[i]), i);
+
+  for (const T& d : delta) {
+    auto it = index.find(idOf(d));
+    if (d.mask & M_DELETE) {
+      if (it != index.end()) {
+        removed[it->second] = true;
+        index.erase(it);
+      }
+    } else if (it != index.end()) {
+      merge(result[it->second], d);
+      result[it->second].mask |= d.mask;
+    } else {
+      index.emplace(idOf(d), result.size());
+      result.push_back(d);
+      removed.push_back(false);
+    }
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < result.size(); ++i) {
+    if (!removed[i]) result[kept++] = result[i];
+  }
+  result.resize(kept);
+  return result;
+}
+
+/**
+ * @brief Append a M_DELETE entry for every displayed entity that is gone
+ */
+template <typename T, typename IdOf, typename Deleted>
+void AppendDeleted(const std::vector<T>& displayed, std::vector<T>& next,
+                   IdOf idOf, Deleted deleted) {
+  std::unordered_set<uint16_t> alive;
+  alive.reserve(next.size());
+  for (const T& e : next) alive.insert(idOf(e));
+  for (const T& e : displayed) {
+    if (!alive.count(idOf(e))) next.push_back(deleted(idOf(e)));
+  }
+}
+
+}  // namespace
+
+SnapshotReceiver::Result SnapshotReceiver::Receive(GAME_STATE& state) {
+  if (Find(state.tick)) return Result::STALE;
+
+  static const GAME_STATE empty;
+  const GAME_STATE* base = &empty;
+  if (state.baseTick != state.tick) {
+    base = Find(state.baseTick);
+    if (!base) return Result::MISSING_BASELINE;
+  }
+
+  GAME_STATE rebuilt;
+  rebuilt.tick = state.tick;
+  rebuilt.baseTick = state.tick;
+  rebuilt.players = ApplyDelta(
+      base->players, state.players,
+      [](const GAME_STATE::PlayerState& p) { return p.playerId; },
+      [](GAME_STATE::PlayerState& p, const GAME_STATE::PlayerState& d) {
+        if (d.mask & M_POS_X) p.posX = d.posX;
+        if (d.mask & M_POS_Y) p.posY = d.posY;
+        if (d.mask & M_HP) p.hp = d.hp;
+        if (d.mask & M_STATE) p.state = d.state;
+        if (d.mask & M_SHIELD) p.shield = d.shield;
+        if (d.mask & M_WEAPON) p.weapon = d.weapon;
+        if (d.mask & M_SPRITE) p.sprite = d.sprite;
+        if (d.mask & M_SCORE) p.score = d.score;
+      });
+  rebuilt.enemies = ApplyDelta(
+      base->enemies, state.enemies,
+      [](const GAME_STATE::EnemyState& e) { return e.enemyId; },
+      [](GAME_STATE::EnemyState& e, const GAME_STATE::EnemyState& d) {
+        if (d.mask & M_POS_X) e.posX = d.posX;
+        if (d.mask & M_POS_Y) e.posY = d.posY;
+        if (d.mask & M_HP) e.hp = d.hp;
+        if (d.mask & M_STATE) e.state = d.state;
+        if (d.mask & M_TYPE) e.enemyType = d.enemyType;
+        if (d.mask & M_DIR) e.direction = d.direction;
+      });
+  rebuilt.projectiles = ApplyDelta(
+      base->projectiles, state.projectiles,
+      [](const GAME_STATE::ProjectileState& pr) { return pr.projectileId; },
+      [](GAME_STATE::ProjectileState& pr,
+         const GAME_STATE::ProjectileState& d) {
+        if (d.mask & M_POS_X) pr.posX = d.posX;
+        if (d.mask & M_POS_Y) pr.posY = d.posY;
+        if (d.mask & M_VELOCITY) {
+          pr.velX = d.velX;
+          pr.velY = d.velY;
+        }
+        if (d.mask & M_DAMAGE) pr.damage = d.damage;
+        if (d.mask & M_TYPE) pr.type = d.type;
+        if (d.mask & M_OWNER) pr.ownerId = d.ownerId;
+      });
+  Store(rebuilt);
+
+  // Un etat plus ancien que celui affiche sert de reference, sans plus
+  if (m_hasDisplayed && !Newer(rebuilt.tick, m_displayedTick)) {
+    return Result::STALE;
+  }
+
+  if (const GAME_STATE* displayed =
+          m_hasDisplayed ? Find(m_displayedTick) : nullptr) {
+    AppendDeleted(
+        displayed->players, rebuilt.players,
+        [](const GAME_STATE::PlayerState& p) { return p.playerId; },
+        [](uint16_t id) {
+          GAME_STATE::PlayerState p{};
+          p.playerId = id;
+          p.mask = M_DELETE;
+          return p;
+        });
+    AppendDeleted(
+        displayed->enemies, rebuilt.enemies,
+        [](const GAME_STATE::EnemyState& e) { return e.enemyId; },
+        [](uint16_t id) {
+          GAME_STATE::EnemyState e{};
+          e.enemyId = id;
+          e.mask = M_DELETE;
+          return e;
+        });
+    AppendDeleted(
+        displayed->projectiles, rebuilt.projectiles,
+        [](const GAME_STATE::ProjectileState& pr) { return pr.projectileId; },
+        [](uint16_t id) {
+          GAME_STATE::ProjectileState pr{};
+          pr.projectileId = id;
+          pr.mask = M_DELETE;
+          return pr;
+        });
+  }
+
+  m_hasDisplayed = true;
+  m_displayedTick = rebuilt.tick;
+  state = std::move(rebuilt);
+  return Result::DISPLAY;
+}
+
+void SnapshotReceiver::Reset() {
+  for (auto& snapshot : m_snapshots) snapshot = Snapshot{};
+  m_hasDisplayed = false;
+  m_displayedTick = 0;
+}
+
+const GAME_STATE* SnapshotReceiver::Find(uint32_t tick) const {
+  for (const auto& snapshot : m_snapshots) {
+    if (snapshot.valid && snapshot.state.tick == tick) return &snapshot.state;
+  }
+  return nullptr;
+}
+
+void SnapshotReceiver::Store(const GAME_STATE& state) {
+  // La place libre, sinon le snapshot le plus ancien
+  Snapshot* slot = &m_snapshots[0];
+  for (auto& snapshot : m_snapshots) {
+    if (!snapshot.valid) {
+      slot = &snapshot;
+      break;
+    }
+    if (Newer(slot->state.tick, snapshot.state.tick)) slot = &snapshot;
+  }
+  slot->valid = true;
+  slot->state = state;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "network/Event.hpp"
+
+/**
+ * @class SnapshotReceiver
+ * @brief Rebuilds the GAME_STATE deltas of the server from their baseline
+ *
+ * The server diffs each GAME_STATE against the last snapshot this client
+ * acknowledged (baseTick), which may be older than the last one displayed.
+ * The receiver keeps the recently rebuilt snapshots by tick, applies each
+ * delta to its baseline, then rewrites the event as an update of the state
+ * displayed by the scene: every entity with its known fields, plus a
+ * M_DELETE entry for each entity that disappeared.
+ */
+class SnapshotReceiver {
+ public:
+  static constexpr size_t CAPACITY = 64;
+
+  enum class Result {
+    DISPLAY,          ///< Newest state, the event must reach the scene
+    STALE,            ///< Older or duplicate state, rebuilt but not shown
+    MISSING_BASELINE  ///< Baseline unknown, the datagram must not be acked
+  };
+
+  /**
+   * @brief Rebuild a received GAME_STATE
+   * @param state Delta or full state, rewritten as the scene update when
+   * the result is DISPLAY
+   */
+  Result Receive(GAME_STATE& state);
+
+  /**
+   * @brief Forget every snapshot, when a game starts or ends
+   */
+  void Reset();
+
+ private:
+  struct Snapshot {
+    bool valid = false;
+    GAME_STATE state;
+  };
+
+  const GAME_STATE* Find(uint32_t tick) const;
+  void Store(const GAME_STATE& state);
+
+  std::array<Snapshot, CAPACITY> m_snapshots{};
+  bool m_hasDisplayed = false;
+  uint32_t m_displayedTick = 0;
+};
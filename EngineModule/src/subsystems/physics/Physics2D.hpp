@@ -1,7 +1,10 @@
 #pragma once
+#ifndef ENGINE_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 #include "ecs/Entity.hpp"
@@ -92,11 +95,13 @@ struct BoxCollider {
         mask(msk),
         isTrigger(trigger) {}
 
+#ifndef ENGINE_HEADLESS
   SDL_Rect GetRect(const Vector2& position) const {
     return {static_cast<int>(position.x + offset.x - width / 2),
             static_cast<int>(position.y + offset.y - height / 2),
             static_cast<int>(width), static_cast<int>(height)};
   }
+#endif
 
   struct Bounds {
     float left, right, top, bottom;
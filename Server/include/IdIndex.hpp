@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class IdIndex
+ * @brief Flat open-addressing table from an entity id to its array position
+ *
+ * Built in O(n) over a snapshot array and probed in O(1), so two snapshots
+ * are diffed in linear time. The slots are reused between builds: once
+ * warmed up, indexing a snapshot does not allocate.
+ */
+class IdIndex {
+ public:
+  static constexpr int32_t NONE = -1;
+
+  /**
+   * @brief Index the items of an array by id
+   * @param items Array to index, must outlive the lookups
+   * @param idOf Returns the uint16_t id of an item
+   *
+   * With duplicate ids, Find returns the first position, like a linear scan.
+   */
+  template <typename T, typename IdOf>
+  void Build(const std::vector<T>& items, IdOf idOf) {
+    size_t capacity = 16;
+    while (capacity < items.size() * 2) capacity <<= 1;
+    mask_ = capacity - 1;
+    slots_.assign(capacity, Slot{0, NONE});
+
+    for (size_t i = 0; i < items.size(); ++i) {
+      uint16_t id = idOf(items[i]);
+      size_t pos = Hash(id) & mask_;
+      while (slots_[pos].index != NONE) {
+        if (slots_[pos].id == id) break;
+        pos = (pos + 1) & mask_;
+      }
+      if (slots_[pos].index == NONE) slots_[pos] = Slot{id, int32_t(i)};
+    }
+  }
+
+  /**
+   * @brief Position of the first item with this id, or NONE
+   */
+  int32_t Find(uint16_t id) const {
+    if (slots_.empty()) return NONE;
+    size_t pos = Hash(id) & mask_;
+    while (slots_[pos].index != NONE) {
+      if (slots_[pos].id == id) return slots_[pos].index;
+      pos = (pos + 1) & mask_;
+    }
+    return NONE;
+  }
+
+ private:
+  struct Slot {
+    uint16_t id;
+    int32_t index;
+  };
+
+  // Les ids sont alloues de facon quasi sequentielle : l'identite suffit
+  static size_t Hash(uint16_t id) { return id; }
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobPool
+ * @brief Fixed-size worker pool running parallel-for batches
+ *
+ * A batch is a number of independent jobs identified by their index. The
+ * calling thread publishes the batch, runs jobs itself alongside the workers
+ * and returns once every job is done, so a batch never waits for a free
+ * worker. Several threads may submit batches at the same time.
+ */
+class JobPool {
+ public:
+  using Job = std::function<void(size_t index)>;
+
+  /**
+   * @brief Construct the pool and start its workers
+   * @param workers Number of worker threads (0 = one per core, minus the
+   * calling thread)
+   */
+  explicit JobPool(size_t workers = 0);
+  ~JobPool();
+
+  JobPool(const JobPool&) = delete;
+  JobPool& operator=(const JobPool&) = delete;
+
+  /**
+   * @brief Run job(0) .. job(count - 1) in parallel and wait for all of them
+   * @param count Number of jobs
+   * @param job Job callback, must not throw
+   */
+  void ParallelFor(size_t count, const Job& job);
+
+  /**
+   * @brief Stop and join all workers
+   */
+  void Stop();
+
+  size_t WorkerCount() const { return workers_.size(); }
+
+ private:
+  struct Batch {
+    const Job* job = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> next{0};  ///< Next job index to claim
+    std::atomic<size_t> done{0};  ///< Jobs finished
+  };
+
+  /**
+   * @brief Claim and run jobs of a batch until none is left
+   */
+  void RunBatch(Batch& batch);
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Batch>> pending_;  ///< Batches with free jobs
+  std::mutex mutex_;
+  std::condition_variable cv_;      ///< Wakes workers on a new batch
+  std::condition_variable doneCv_;  ///< Signals a finished batch
+  bool running_ = true;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class LobbyScheduler
+ * @brief Fixed-size worker pool running lobby ticks from a timer heap
+ *
+ * Each scheduled lobby has a next tick deadline. Workers pop the earliest
+ * deadline that has arrived, run the lobby tick outside the lock and push the
+ * lobby back with its next deadline. A lobby is never ticked by two workers
+ * at the same time.
+ */
+class LobbyScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Lobby tick callback
+   * @param lateness How late the tick started compared to its deadline
+   * @return false to stop scheduling the lobby
+   */
+  using TickFunc = std::function<bool(Clock::duration lateness)>;
+
+  /**
+   * @brief Construct the scheduler and start its workers
+   * @param workers Number of worker threads (0 = one per core)
+   */
+  explicit LobbyScheduler(size_t workers = 0);
+  ~LobbyScheduler();
+
+  LobbyScheduler(const LobbyScheduler&) = delete;
+  LobbyScheduler& operator=(const LobbyScheduler&) = delete;
+
+  /**
+   * @brief Schedule a lobby
+   * @param lobbyId Lobby identifier, replaces any previous schedule
+   * @param firstDeadline Deadline of the first tick
+   * @param period Time between two tick deadlines
+   * @param tick Tick callback
+   * @param onFinished Called once when tick returns false
+   */
+  void Schedule(uint16_t lobbyId, Clock::time_point firstDeadline,
+                Clock::duration period, TickFunc tick,
+                std::function<void()> onFinished = nullptr);
+
+  /**
+   * @brief Remove a lobby, waiting for its running tick to complete
+   * @param lobbyId Lobby identifier
+   */
+  void Cancel(uint16_t lobbyId);
+
+  /**
+   * @brief Stop and join all workers
+   */
+  void Stop();
+
+  size_t WorkerCount() const { return workers_.size(); }
+
+ private:
+  struct Task {
+    uint16_t id;
+    uint64_t generation;
+    Clock::time_point deadline;
+    Clock::duration period;
+    TickFunc tick;
+    std::function<void()> onFinished;
+    bool running = false;
+    bool cancelled = false;
+  };
+
+  struct HeapEntry {
+    Clock::time_point deadline;
+    uint16_t id;
+    uint64_t generation;
+    bool operator>(const HeapEntry& other) const {
+      return deadline > other.deadline;
+    }
+  };
+
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::unordered_map<uint16_t, std::shared_ptr<Task>> tasks_;
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                      std::greater<HeapEntry>>
+      heap_;
+  std::mutex mutex_;
+  std::condition_variable cv_;      ///< Wakes workers on new deadlines
+  std::condition_variable doneCv_;  ///< Signals a finished tick to Cancel
+  uint64_t nextGeneration_ = 1;
+  bool running_ = true;
+};
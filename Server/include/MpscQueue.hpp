@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief Monitoring counters of a MpscQueue
+ */
+struct QueueStats {
+  size_t capacity = 0;   ///< Number of slots
+  size_t size = 0;       ///< Approximate number of queued items
+  size_t highWater = 0;  ///< Largest size observed on push
+  uint64_t pushed = 0;   ///< Items accepted
+  uint64_t dropped = 0;  ///< Items rejected because the queue was full
+};
+
+/**
+ * @class MpscQueue
+ * @brief Bounded lock-free multi-producer / single-consumer ring queue
+ *
+ * Slots are allocated once at construction and reused: producers move their
+ * item into a free slot, the consumer moves it out, so no allocation happens
+ * on the hot path beyond what the item itself owns. Each slot carries a
+ * sequence number telling whether it is free for the producer of a given
+ * position or ready for the consumer. When the ring is full, TryPush rejects
+ * the item and counts it as dropped instead of blocking.
+ *
+ * @tparam T Movable, default constructible item type
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  /**
+   * @brief Construct the queue
+   * @param capacity Number of slots, rounded up to a power of two
+   */
+  explicit MpscQueue(size_t capacity = 1024)
+      : capacity_(RoundUp(capacity)),
+        mask_(capacity_ - 1),
+        slots_(new Slot[capacity_]) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+   * @brief Push an item, callable from any thread
+   * @return false if the queue was full and the item dropped
+   */
+  bool TryPush(T&& item) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[pos & mask_];
+      size_t seq = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(item);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    size_t used = pos + 1 - head_.load(std::memory_order_relaxed);
+    size_t high = highWater_.load(std::memory_order_relaxed);
+    while (used > high &&
+           !highWater_.compare_exchange_weak(high, used,
+                                             std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  bool TryPush(const T& item) { return TryPush(T(item)); }
+
+  /**
+   * @brief Pop the oldest item, only from the consumer thread
+   * @return The item, or nullopt when the queue is empty
+   */
+  std::optional<T> TryPop() {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos & mask_];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (seq != pos + 1) return std::nullopt;
+
+    std::optional<T> res(std::move(slot.value));
+    slot.value = T();
+    slot.sequence.store(pos + capacity_, std::memory_order_release);
+    head_.store(pos + 1, std::memory_order_relaxed);
+    return res;
+  }
+
+  /**
+   * @brief Approximate number of queued items
+   */
+  size_t Size() const {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  size_t Capacity() const { return capacity_; }
+
+  /**
+   * @brief Snapshot of the monitoring counters
+   */
+  QueueStats Stats() const {
+    QueueStats s;
+    s.capacity = capacity_;
+    s.size = Size();
+    s.highWater = highWater_.load(std::memory_order_relaxed);
+    s.pushed = pushed_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    return s;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  static size_t RoundUp(size_t n) {
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  alignas(64) std::atomic<size_t> tail_{0};  ///< Next position to produce
+  alignas(64) std::atomic<size_t> head_{0};  ///< Next position to consume
+  alignas(64) std::atomic<size_t> highWater_{0};
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
@@ -1,17 +1,18 @@
 #pragma once
 #include <cstdint>
-#include <vector>
+
+#include "network/Event.hpp"
 
 /**
  * @struct NetworkMessage
  * @brief Represents a network message exchanged between server and clients
  *
- * Contains the client identifier, raw message data, and timestamp
- * for tracking and debugging purposes.
+ * Contains the client identifier and the message, already decoded on the
+ * IO thread.
  */
 struct NetworkMessage {
   uint16_t client_id;
-  std::vector<uint8_t> data;
+  Event event;  ///< Decoded once, moved out by the consumer
 
   NetworkMessage() : client_id(0) {}
 };
@@ -1,24 +1,97 @@
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <string>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "JobPool.hpp"
+#include "LobbyScheduler.hpp"
+#include "MpscQueue.hpp"
+#include "SnapshotBudget.hpp"
+#include "SnapshotHistory.hpp"
 #include "components/Levels.hpp"
 #include "components/TileMap.hpp"
 #include "dynamicLibLoader/DLLoader.hpp"
 #include "ecs/Registry.hpp"
 #include "engine/GameEngine.hpp"
+#include "scene/SceneKeys.hpp"
 #include "network/DecodeFunc.hpp"
 #include "network/EncodeFunc.hpp"
+#include "network/PlayerInputBuffer.hpp"
 #include "network/ServerNetworkManager.hpp"
 
+/**
+ * @brief Fixed-tick statistics of one lobby simulation
+ */
+struct TickStats {
+  uint64_t ticks = 0;         ///< Simulation ticks executed
+  uint64_t overruns = 0;      ///< Ticks whose update exceeded the tick period
+  uint64_t droppedTicks = 0;  ///< Ticks discarded by the catch-up cap
+  double lastTickMs = 0.0;    ///< Cost of the last tick
+  double maxTickMs = 0.0;     ///< Worst tick cost seen
+  double totalTickMs = 0.0;   ///< Sum of tick costs, for the average
+  double lastLateMs = 0.0;    ///< Lateness of the last scheduler wake-up
+  double maxLateMs = 0.0;     ///< Worst scheduler lateness seen
+};
+
+/**
+ * @brief Snapshot send schedule of one client
+ *
+ * A snapshot is sent every interval ticks. The interval starts at the
+ * configured send rate and is doubled, up to MAX_FACTOR times the base, when
+ * the client link degrades, then halved back once it recovers.
+ */
+struct ClientSendRate {
+  static constexpr int MAX_FACTOR = 4;
+  int baseInterval = 1;    ///< Ticks between snapshots at the nominal rate
+  int interval = 1;        ///< Current ticks between snapshots
+  uint32_t nextTick = 0;   ///< First tick at which the next snapshot is due
+  uint32_t nextCheck = 0;  ///< Tick of the next link quality check
+  uint32_t lastChange = 0;  ///< Tick of the last interval change
+};
+
+/**
+ * @brief Delta from one baseline to the snapshot of the tick
+ *
+ * Clients that acknowledged the same baseline share a single delta.
+ */
+struct SnapshotDelta {
+  std::shared_ptr<const GameState> baseline;  ///< Acknowledged snapshot
+  uint32_t baseTick = 0;                      ///< Tick of the baseline
+  std::shared_ptr<const GameState> state;     ///< Computed delta
+};
+
+/**
+ * @brief GAME_STATE job of one client for one tick
+ *
+ * Jobs are prepared serially on the lobby tick, then encoded in parallel;
+ * each job only touches its own client state.
+ */
+struct SnapshotJob {
+  uint16_t playerId = 0;
+  SnapshotAcks* acks = nullptr;  ///< Sent and acknowledged snapshots
+  SnapshotBudget* budget = nullptr;  ///< Priorities of the entries left out
+  bool full = false;       ///< Full snapshot, sent even when nothing changed
+  bool keepAlive = false;  ///< Sent even if empty, to renew an old baseline
+  size_t delta = 0;        ///< Index of the shared delta when not full
+  std::shared_ptr<const GameState> state;  ///< State to send
+  const GameState* baseline = nullptr;  ///< Baseline of state, if a delta
+  /// State of the client once received, set if state was cut down
+  std::shared_ptr<const GameState> view;
+  OutgoingDatagram datagram;  ///< Encoded packet, empty if nothing to send
+  std::optional<Action> tcpFallback;  ///< State of a client without UDP
+};
+
 /**
  * @class ServerGame
  * @brief Main server game logic manager
@@ -27,6 +100,8 @@
  * and game state synchronization for the R-Type server.
  */
 struct lobby_list {
+  /// Guards the roster and the game state; held by the lobby tick
+  std::mutex mutex;
   uint16_t lobby_id;
   uint16_t host_id;
   std::string name = "";
@@ -36,10 +111,12 @@ struct lobby_list {
   uint8_t max_players = 4;
   std::vector<std::tuple<uint16_t, bool, std::string>> players_list;
   std::vector<std::tuple<uint16_t, bool, std::string>> spectate;
-  std::queue<std::pair<Event, uint16_t>> lobbyEventQueue;
-  std::mutex lobbyQueueMutex;
+  /// Player inputs, pushed by the main thread, drained by the lobby tick
+  MpscQueue<std::pair<Event, uint16_t>> lobbyEventQueue{1024};
+  /// Tick-stamped inputs per player, consumed by the game scene
+  PlayerInputBuffers inputBuffers;
   bool players_ready = false;
-  bool gameRuning = false;
+  std::atomic<bool> gameRuning{false};
   bool hasPassword = false;
   std::vector<LevelComponent> levelsData;
   TileMap currentMap;
@@ -52,12 +129,27 @@ struct lobby_list {
   Registry registry;
   std::unordered_map<uint16_t, Entity> m_players;
   std::unordered_map<uint16_t, uint32_t> playerScores;
-  std::thread gameThread;
-  std::unordered_map<uint16_t, std::shared_ptr<GameState>> lastStates;
-  std::unordered_map<uint16_t, int> playerStateCount;
+  bool loopScheduled = false;  ///< Game ticks are queued on the scheduler
+  std::atomic<bool> loopFinished{false};  ///< Last game tick has returned
+  bool gameStarted = false;  ///< GAME_START sent, simulation running
+  std::unordered_set<uint16_t> loadingPending;  ///< Players still loading
+  std::chrono::steady_clock::time_point loadingDeadline;  ///< Start anyway
+  std::chrono::steady_clock::time_point lastTickTime;
+  std::chrono::steady_clock::duration tickAccumulator{0};
+  /// Snapshots of the recent ticks, the candidate delta baselines
+  SnapshotHistory snapshotHistory;
+  /// GAME_STATE sent to each client and the newest one it acknowledged
+  std::unordered_map<uint16_t, SnapshotAcks> snapshotAcks;
+  /// Packet budget of each client, with the priorities of what it lacks
+  std::unordered_map<uint16_t, SnapshotBudget> snapshotBudgets;
   GameEngine m_engine;
   Scene* m_gameScene = nullptr;
   std::unordered_map<uint16_t, uint32_t> currentScores;
+  uint32_t currentTick = 0;  ///< Monotonic simulation tick, sent in snapshots
+  std::unordered_map<uint16_t, ClientSendRate> sendRates;
+  std::vector<SnapshotJob> snapshotJobs;  ///< Reused by every tick
+  std::vector<SnapshotDelta> snapshotDeltas;  ///< Reused by every tick
+  TickStats tickStats;
 };
 
 class ServerGame {
@@ -70,6 +162,19 @@ class ServerGame {
                   const std::string& host = "0.0.0.0");
   void Run();
 
+  /**
+   * @brief Set the fixed simulation rate of the lobby game loops
+   * @param hz Ticks per second
+   * @param maxCatchUp Max ticks run in one wake-up before dropping time
+   */
+  void SetTickRate(int hz, int maxCatchUp = 5);
+
+  /**
+   * @brief Set the nominal snapshot rate sent to each client
+   * @param hz Snapshots per second, capped by the tick rate
+   */
+  void SetSnapshotRate(int hz);
+
   /**
    * @brief Shutdown the server and cleanup resources
    */
@@ -85,23 +190,36 @@ class ServerGame {
 #endif
   std::unique_ptr<INetworkManager>
       networkManager;  ///< Network communication manager
-  Decoder decode;      ///< Decoder for incoming network messages
   Encoder encode;      ///< Encoder for outgoing network messages
   Registry registry;   ///< ECS registry for game entities
   std::unordered_map<uint16_t, Entity>
-      m_players;          ///< Map of player IDs to their entities
-  std::mutex queueMutex;  ///< Mutex for thread-safe queue access
+      m_players;  ///< Map of player IDs to their entities
 
-  std::vector<std::unique_ptr<lobby_list>> lobbys;
+  /// Lobby directory by lobby id. Lobbies are created and destroyed only on
+  /// the main thread, so the main thread may keep a pointer after unlocking
+  std::unordered_map<uint16_t, std::unique_ptr<lobby_list>> lobbys;
+  /// Lobby id of every player and spectator, a client is in one lobby at most
+  std::unordered_map<uint16_t, uint16_t> playerLobby;
+  JobPool snapshotPool;  ///< Per-client delta and encode jobs of the ticks
+  LobbyScheduler scheduler;  ///< Worker pool ticking the running lobbies
   uint16_t nextLobbyId = 1;
   const float TIME_BETWEEN_LEVELS = 5.0f;
+  int tickRate = 30;         ///< Fixed simulation ticks per second
+  int maxCatchUpTicks = 5;   ///< Catch-up cap per loop iteration
+  int snapshotRate = 30;     ///< Nominal snapshots per second per client
+  /// Link quality thresholds of the snapshot rate downgrade
+  static constexpr float DEGRADED_LOSS = 0.10f;
+  static constexpr float DEGRADED_RTT_MS = 250.0f;
+  static constexpr float HEALTHY_LOSS = 0.02f;
+  static constexpr float HEALTHY_RTT_MS = 120.0f;
   // std::unique_ptr<INetworkManager> networkManager; ///< Network communication
   // manager
 
-  std::queue<std::tuple<Event, uint16_t>>
-      eventQueue;  ///< Queue of incoming events from clients
-  std::queue<std::tuple<Action, uint16_t, lobby_list*>>
-      actionQueue;  ///< Queue of actions to send to clients
+  MpscQueue<std::tuple<Event, uint16_t>> eventQueue{
+      4096};  ///< Queue of incoming events from clients
+  MpscQueue<std::tuple<Action, uint16_t, uint16_t>> actionQueue{
+      8192};  ///< Actions to send: client id, or 0 and the lobby id
+  std::chrono::steady_clock::time_point lastQueueLog;
 
   void CreateLobby(uint16_t playerId, std::string name, std::string playerName,
                    std::string mdp, uint8_t difficulty, uint8_t Maxplayer);
@@ -122,12 +240,24 @@ class ServerGame {
   void RemovePlayerFromLobby(uint16_t playerId);
   void SendMapToClients(uint16_t playerId, lobby_list& lobby);
   void SendMapToLobby(lobby_list& lobby);
+  /**
+   * @brief Lobby a player or spectator is in, O(1) through the index
+   */
   lobby_list* FindPlayerLobby(uint16_t playerId);
+  /**
+   * @brief Lobby with the given id, or nullptr
+   */
+  lobby_list* FindLobby(uint16_t lobbyId);
+  /**
+   * @brief Pointers to every lobby, taken under the directory lock
+   */
+  std::vector<lobby_list*> LobbySnapshot();
   GameState BuildCurrentState(lobby_list& lobby);
   GameState CalculateDelta(const GameState& last, const GameState& current);
 
   /**
-   * @brief Receive and process player input events
+   * @brief Stamp the queued player inputs with the next tick and hand them
+   * to the scene input buffers
    */
   void ReceivePlayerInputs(lobby_list& lobby);
   /**
@@ -139,11 +269,48 @@ class ServerGame {
    * @brief Send current world state to all connected clients
    */
   void SendWorldStateToClients(lobby_list& lobby);
-  void ProcessAndSendState(uint16_t playerId, lobby_list& lobby);
-  std::mutex lobbyMutex;  ///< Mutex for thread-safe lobby access
+  /**
+   * @brief Copy of a snapshot with every field flagged, sent to the clients
+   * that just joined
+   */
+  std::shared_ptr<const GameState> BuildFullState(const GameState& snapshot,
+                                                  uint32_t tick);
+  /**
+   * @brief Fit the state prepared for a client in the packet budget and
+   * encode it, run in parallel for the clients of a lobby
+   * @param job Client state and output datagram
+   * @param snapshot Snapshot of the tick
+   */
+  void ProcessAndSendState(SnapshotJob& job, const GameState& snapshot);
+  /**
+   * @brief Whether a snapshot is due for a client at the current tick,
+   * adapting its send interval to its link quality
+   */
+  bool SnapshotDue(uint16_t playerId, lobby_list& lobby);
+  /**
+   * @brief Forget the acks, budget and send rate of a client, when it joins
+   * or leaves a running game
+   */
+  void ForgetClientSnapshots(uint16_t playerId, lobby_list& lobby);
+  /// Guards lobbys and playerLobby only. It is a leaf lock: never held
+  /// while taking a lobby mutex, which is taken first when both are needed
+  std::mutex directoryMutex;
 
   bool serverRunning;  ///< Server running state flag
 
+  std::mutex wakeMutex;              ///< Guards wakePending
+  std::condition_variable wakeCv;    ///< Wakes the main loop in Run
+  bool wakePending = false;          ///< Work queued since the last wake-up
+  /// Upper bound on the main loop sleep, for UDP retransmissions
+  static constexpr std::chrono::milliseconds MAX_IDLE_WAIT{100};
+  /// Longest wait for the clients to report their assets loaded
+  static constexpr std::chrono::seconds LOADING_TIMEOUT{10};
+
+  /**
+   * @brief Wake the main loop, callable from any thread
+   */
+  void Wake();
+
   /**
    * @brief Setup network event callbacks
    */
@@ -163,13 +330,33 @@ class ServerGame {
    */
   void InitWorld(lobby_list& lobby);
   /**
-   * @brief Main game loop running in separate thread
+   * @brief Collect the ASSETS_READY reports of a starting lobby
+   * @return true once every player is ready or the timeout expired
    */
-  void GameLoop(lobby_list& lobby);
+  bool LoadingDone(lobby_list& lobby);
+  /**
+   * @brief Send GAME_START once the clients are loaded
+   */
+  void BeginGame(lobby_list& lobby);
+  /**
+   * @brief One scheduler wake-up of a lobby: runs the due fixed ticks
+   * @param lateness Delay between the tick deadline and its execution
+   * @return false once the game is over
+   */
+  bool GameTick(lobby_list& lobby,
+                std::chrono::steady_clock::duration lateness);
+  /**
+   * @brief Duration of one simulation tick
+   */
+  std::chrono::steady_clock::duration TickPeriod() const;
   /**
    * @brief Check if game end conditions are met
    */
   void CheckGameEnded(lobby_list& lobby);
+  /**
+   * @brief Record the cost of one tick and periodically log the stats
+   */
+  void RecordTick(lobby_list& lobby, double tickMs);
   /**
    * @brief End the game and cleanup
    */
@@ -181,6 +368,18 @@ class ServerGame {
    * @return Optional tuple containing event and client ID
    */
   std::optional<std::tuple<Event, uint16_t>> PopEvent();
+  /**
+   * @brief Dispatch the queued client events on the main thread
+   */
+  void DispatchEvents();
+  /**
+   * @brief Handle one client event outside of a running game
+   */
+  void HandleEvent(uint16_t playerId, Event& ev);
+  /**
+   * @brief Periodically log the queue high-water marks and drops
+   */
+  void LogQueueStats();
   std::optional<std::pair<Event, uint16_t>> PopEventLobby(lobby_list& lobby);
 
   /**
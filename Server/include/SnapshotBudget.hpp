@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "network/Action.hpp"
+
+/**
+ * @class SnapshotBudget
+ * @brief Fits the GAME_STATE of one client in a single datagram
+ *
+ * The receive buffers of both ends hold about one MTU, so a GAME_STATE
+ * bigger than PACKET_BYTES would be truncated or dropped. When a state does
+ * not fit, its entries are ranked by priority (players, then bosses, then
+ * the enemies near the client ship, then projectiles) and the best ones fill
+ * the datagram. Each entry left out accumulates its priority until it is
+ * sent, so that no entity starves.
+ *
+ * The entries left out are not lost: the view returned by Fit is the state
+ * the client holds once the datagram arrives, and it becomes the delta
+ * baseline when acknowledged, so the next deltas carry them again.
+ */
+class SnapshotBudget {
+ public:
+  /// Datagram size, UDP header of the protocol included, under the MTU
+  static constexpr size_t PACKET_BYTES = 1200;
+  /// Entity count of one list, stored on a single byte by GAME_STATE
+  static constexpr size_t MAX_ENTRIES = 255;
+
+  static constexpr float PRIORITY_PLAYER = 8.0f;
+  static constexpr float PRIORITY_BOSS = 4.0f;
+  static constexpr float PRIORITY_ENEMY_NEAR = 3.0f;
+  static constexpr float PRIORITY_ENEMY_FAR = 1.0f;
+  static constexpr float PRIORITY_PROJECTILE = 0.5f;
+  /// Distance from the client ship at which an enemy gets the far priority
+  static constexpr float NEAR_RANGE = 600.0f;
+
+  /**
+   * @brief Keep the highest priority entries of a state too big to send
+   * @param state Delta, or full state, prepared for the client
+   * @param baseline State the delta applies to, nullptr for a full state
+   * @param snapshot Snapshot the state leads to
+   * @param playerId Client, whose ship ranks the nearby enemies
+   * @param kept Filled with the entries that fit
+   * @param view Filled with the state of the client once kept is applied
+   * @return false if the whole state fits, kept and view are then untouched
+   */
+  bool Fit(const GameState& state, const GameState* baseline,
+           const GameState& snapshot, uint16_t playerId, GameState& kept,
+           GameState& view);
+
+  /**
+   * @brief Upper bound of the datagram size of a state, in either the
+   * GAME_STATE or the GAME_STATE_PACKED format
+   */
+  static size_t EncodedSize(const GameState& state);
+
+ private:
+  /// Priorities accumulated by the entries left out, by kind and id
+  std::unordered_map<uint32_t, float> accumulators_;
+};
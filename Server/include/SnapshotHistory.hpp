@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "network/Action.hpp"
+
+/**
+ * @class SnapshotHistory
+ * @brief Ring of the snapshots published by the recent ticks of a lobby
+ *
+ * Snapshots are shared, immutable and keyed by tick. They are the candidate
+ * delta baselines: a client acknowledging the GAME_STATE of a tick lets the
+ * next deltas be computed against the snapshot of that tick.
+ */
+class SnapshotHistory {
+ public:
+  static constexpr size_t CAPACITY = 64;
+
+  void Push(uint32_t tick, std::shared_ptr<const GameState> state) {
+    Entry& entry = entries_[tick % CAPACITY];
+    entry.tick = tick;
+    entry.state = std::move(state);
+  }
+
+  /**
+   * @brief Snapshot of a tick, or nullptr if it left the ring
+   */
+  std::shared_ptr<const GameState> Find(uint32_t tick) const {
+    const Entry& entry = entries_[tick % CAPACITY];
+    if (!entry.state || entry.tick != tick) return nullptr;
+    return entry.state;
+  }
+
+  void Clear() {
+    for (auto& entry : entries_) entry = Entry{};
+  }
+
+ private:
+  struct Entry {
+    uint32_t tick = 0;
+    std::shared_ptr<const GameState> state;
+  };
+
+  std::array<Entry, CAPACITY> entries_{};
+};
+
+/**
+ * @class SnapshotAcks
+ * @brief GAME_STATE sent to one client and the newest one it acknowledged
+ *
+ * Every GAME_STATE datagram records its sequence number and tick. The ack and
+ * ack_bits piggybacked on the client datagrams then tell which of them
+ * arrived; the newest acknowledged tick becomes the delta baseline as long as
+ * its snapshot is still in the lobby history. A GAME_STATE cut down to the
+ * packet budget records the view the client rebuilds from it, which is then
+ * the baseline instead of the published snapshot.
+ */
+class SnapshotAcks {
+ public:
+  static constexpr size_t WINDOW = 64;
+
+  /**
+   * @brief Remember the tick of a GAME_STATE sent with a sequence number
+   * @param view State of the client once received, nullptr if it is the
+   * snapshot of the tick
+   */
+  void RecordSent(uint16_t seq, uint32_t tick,
+                  std::shared_ptr<const GameState> view = nullptr) {
+    sent_[seq % WINDOW] = Sent{seq, tick, true, std::move(view)};
+  }
+
+  /**
+   * @brief Mark the GAME_STATE of a tick as received, e.g. sent over TCP
+   */
+  void RecordDelivered(uint32_t tick,
+                       std::shared_ptr<const GameState> view = nullptr) {
+    if (!hasBaseline_ || Newer(tick, baselineTick_)) {
+      hasBaseline_ = true;
+      baselineTick_ = tick;
+      baselineView_ = std::move(view);
+    }
+  }
+
+  /**
+   * @brief Move the baseline to the newest GAME_STATE covered by an ack
+   * @param ack Newest sequence number received by the client
+   * @param ackBits Bit i set if ack - (i + 1) was received
+   */
+  void Acknowledge(uint16_t ack, uint32_t ackBits) {
+    for (Sent& sent : sent_) {
+      if (!sent.valid) continue;
+      uint16_t age = static_cast<uint16_t>(ack - sent.seq);
+      bool acked = age == 0 || (age <= 32 && (ackBits & (1u << (age - 1))));
+      if (!acked) continue;
+      sent.valid = false;
+      RecordDelivered(sent.tick, std::move(sent.view));
+    }
+  }
+
+  /**
+   * @brief State of the newest acknowledged tick, nullptr if none or if it
+   * left the history
+   */
+  std::shared_ptr<const GameState> Baseline(
+      const SnapshotHistory& history) const {
+    if (!hasBaseline_) return nullptr;
+    std::shared_ptr<const GameState> snapshot = history.Find(baselineTick_);
+    if (!snapshot || !baselineView_) return snapshot;
+    return baselineView_;
+  }
+
+  bool HasBaseline() const { return hasBaseline_; }
+  uint32_t BaselineTick() const { return baselineTick_; }
+
+ private:
+  struct Sent {
+    uint16_t seq = 0;
+    uint32_t tick = 0;
+    bool valid = false;
+    std::shared_ptr<const GameState> view;  ///< Set if cut down
+  };
+
+  static bool Newer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+  }
+
+  std::array<Sent, WINDOW> sent_{};
+  bool hasBaseline_ = false;
+  uint32_t baselineTick_ = 0;
+  std::shared_ptr<const GameState> baselineView_;
+};
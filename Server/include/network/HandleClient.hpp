@@ -1,14 +1,19 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <asio.hpp>
 
+#include "network/Fragment.hpp"
+
 
 /**
  * @class HandleClient
@@ -34,6 +39,7 @@ class HandleClient {
   };
   std::map<uint16_t, SentPacket> history;
   std::mutex history_mutex;
+  FragmentAssembler fragments;  ///< Fragments received, IO thread only
 
   HandleClient(uint16_t id, const asio::ip::tcp::endpoint& tcp_endpoint,
                const std::string& username);
@@ -126,20 +132,65 @@ class HandleClient {
    */
   void IncrementPacketsReceived() { ++packets_received_; }
 
-  uint16_t GetNextOutSeq() { return next_out_seq_num_++; }
+  /**
+   * @brief Reserve the next outgoing UDP sequence number, thread-safe
+   */
+  uint16_t GetNextOutSeq() { return next_out_seq_num_.fetch_add(1); }
 
-  void UpdateRemoteAck(uint16_t ack, uint32_t ack_bits) {
-    last_received_remote_ack_ = ack;
-    remote_ack_bits_ = ack_bits;
-  }
+  /**
+   * @brief Reserve the id of the next fragmented message, thread-safe
+   */
+  uint16_t GetNextMessageId() { return next_message_id_.fetch_add(1); }
+
+  /**
+   * @brief Store the ack piggybacked on a client datagram and update the
+   * RTT and loss estimates from it
+   */
+  void UpdateRemoteAck(uint16_t ack, uint32_t ack_bits);
+
+  /**
+   * @brief Remember when a UDP datagram was sent, for the RTT estimate
+   * @param seq Sequence number of the datagram
+   */
+  void RecordSent(uint16_t seq);
+
+  /**
+   * @brief Link quality seen from the acks of the client
+   */
+  struct LinkStats {
+    float rttMs = 0.0f;    ///< Smoothed round-trip time
+    float loss = 0.0f;     ///< Smoothed loss ratio, 0 to 1
+    uint64_t samples = 0;  ///< Number of acks used
+  };
+  LinkStats GetLinkStats() const;
+
+  /**
+   * @brief Latest ack and ack_bits received from the client, thread-safe
+   */
+  void GetRemoteAck(uint16_t& ack, uint32_t& ack_bits) const;
   uint16_t GetLastRemoteAck() const { return last_received_remote_ack_; }
   uint32_t GetRemoteAckBits() const { return remote_ack_bits_; }
 
+  /**
+   * @brief Record a sequence number received from the client, IO thread only
+   */
   void UpdateLocalSequence(uint16_t new_seq);
 
-  uint16_t GetLastReceivedSeq() const { return last_received_seq_from_client_; }
+  uint16_t GetLastReceivedSeq() const {
+    return static_cast<uint16_t>(local_ack_.load(std::memory_order_acquire));
+  }
 
-  uint32_t GetLocalAckBits() const { return local_ack_bits_for_client_; }
+  /**
+   * @brief Ack and ack_bits to send back to the client, read together so
+   * that they always match, thread-safe
+   */
+  void GetLocalAck(uint16_t& ack, uint32_t& ack_bits) const;
+
+  /**
+   * @brief Store the LoginFeature bits announced in the login request
+   */
+  void SetFeatures(uint8_t features) { features_ = features; }
+  bool HasFeature(uint8_t feature) const { return (features_ & feature) != 0; }
 
  private:
   uint16_t id_;                           ///< Unique client identifier
@@ -151,13 +202,25 @@ class HandleClient {
   std::chrono::steady_clock::time_point
       last_seen_;  ///< Last activity timestamp
 
-  uint16_t next_out_seq_num_ = 1;
+  std::atomic<uint16_t> next_out_seq_num_{1};
+  std::atomic<uint16_t> next_message_id_{0};
+  std::atomic<uint8_t> features_{0};  ///< LoginFeature bits of the client
   uint16_t last_received_remote_ack_ = 0;
   uint32_t remote_ack_bits_ = 0;
 
-  uint16_t last_received_seq_from_client_ = 0;
-  uint32_t local_ack_bits_for_client_ = 0;
+  /// Newest seq received from the client (low 16 bits) and the bits of the
+  /// 32 seqs before it (high 32 bits), in one word: the snapshot workers
+  /// encode acks while the IO thread updates them
+  std::atomic<uint64_t> local_ack_{0};
 
-  uint64_t packets_sent_ = 0;      ///< Number of packets sent
+  std::atomic<uint64_t> packets_sent_{0};  ///< Number of packets sent
   uint64_t packets_received_ = 0;  ///< Number of packets received
+
+  static constexpr size_t SENT_WINDOW = 256;
+  mutable std::mutex link_mutex_;  ///< Guards the acks, send times and stats
+  std::array<std::chrono::steady_clock::time_point, SENT_WINDOW>
+      sent_times_{};  ///< Send time of the recent datagrams, by seq
+  std::array<uint16_t, SENT_WINDOW> sent_seqs_{};
+  uint16_t highest_acked_ = 0;  ///< Newest seq acked by the client
+  LinkStats link_;              ///< Smoothed link estimates
 };
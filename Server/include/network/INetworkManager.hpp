@@ -6,6 +6,25 @@
 
 #include "include/NetworkMessage.hpp"
 #include "network/Action.hpp"
+#include "network/PacketPool.hpp"
+
+/**
+ * @brief Link quality of one client, estimated from its acks
+ */
+struct ClientLinkStats {
+  float rttMs = 0.0f;    ///< Smoothed round-trip time in milliseconds
+  float loss = 0.0f;     ///< Smoothed packet loss ratio, 0 to 1
+  uint64_t samples = 0;  ///< Acks used for the estimate
+};
+
+/**
+ * @brief A UDP datagram encoded off the IO thread, waiting to be sent
+ */
+struct OutgoingDatagram {
+  uint16_t client_id = 0;     ///< Destination client
+  uint16_t seq = 0;           ///< Sequence number written in the header
+  PacketPool::Buffer data;  ///< Whole packet, header included
+};
 
 /**
  * @class INetworkManager
@@ -22,11 +41,13 @@ class INetworkManager {
   virtual ~INetworkManager() = default;
 
   using MessageCallback =
-      std::function<void(const NetworkMessage&)>;  ///< Message callback type
+      std::function<void(NetworkMessage&&)>;  ///< Message callback type
   using ConnectionCallback =
       std::function<void(uint32_t client_id)>;  ///< Connection callback type
   using DisconnectionCallback =
       std::function<void(uint32_t client_id)>;  ///< Disconnection callback type
+  using WakeupCallback =
+      std::function<void()>;  ///< Called from the IO thread on new work
 
   virtual bool Initialize(uint16_t tcp_port, uint16_t udp_port,
                           const std::string& host) = 0;
@@ -76,6 +97,47 @@ class INetworkManager {
    */
   virtual void SetDisconnectionCallback(DisconnectionCallback callback) = 0;
 
+  /**
+   * @brief Set callback fired when a message or connection event is queued
+   * @param callback Function to call, must be set before Initialize
+   */
+  virtual void SetWakeupCallback(WakeupCallback callback) = 0;
+
+  /**
+   * @brief Get the link quality estimated for a client
+   * @param client_id Client identifier
+   * @param out Filled with the smoothed RTT and loss ratio
+   * @return false if the client is unknown
+   */
+  virtual bool GetClientLinkStats(uint16_t client_id,
+                                  ClientLinkStats& out) = 0;
+
+  /**
+   * @brief Get the latest ack received from a client
+   * @param client_id Client identifier
+   * @param ack Newest sequence number the client received
+   * @param ack_bits Bit i set if ack - (i + 1) was received too
+   * @return false if the client is unknown
+   */
+  virtual bool GetClientAcks(uint16_t client_id, uint16_t& ack,
+                             uint32_t& ack_bits) = 0;
+
+  /**
+   * @brief Encode a UDP action for a client, callable from any thread
+   * @param client_id Client identifier
+   * @param ac Action to encode, protocol 0 or 1
+   * @param out Filled with the packet and its reserved sequence number
+   * @return false if the client has no UDP endpoint or the action is TCP
+   */
+  virtual bool EncodeUDP(uint16_t client_id, const Action& ac,
+                         OutgoingDatagram& out) = 0;
+
+  /**
+   * @brief Hand datagrams encoded with EncodeUDP to the IO thread at once
+   * @param batch Datagrams, sent in order
+   */
+  virtual void SendBatchUDP(std::vector<OutgoingDatagram> batch) = 0;
+
   /**
    * @brief Get user information from database
    * @param username Username to search for
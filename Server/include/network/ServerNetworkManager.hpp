@@ -11,6 +11,7 @@
 #include <asio.hpp>
 
 
+#include "MpscQueue.hpp"
 #include "db/IDatabase.hpp"
 #include "network/ClientManager.hpp"
 #include "network/Decoder.hpp"
@@ -19,6 +20,14 @@
 #include "network/TCPServer.hpp"
 #include "network/UDPServer.hpp"
 
+/**
+ * @brief Packet broadcast over UDP: one payload, one header per client
+ */
+struct UdpBroadcast {
+  std::vector<uint8_t> payload;
+  std::vector<Encoder::Header> headers;
+};
+
 struct ConnectionEvent {
   enum Type { CONNECTED, DISCONNECTED };  ///< Event type
   Type type;                              ///< The type of connection event
@@ -94,6 +103,46 @@ class ServerNetworkManager : public INetworkManager {
    */
   void SetDisconnectionCallback(DisconnectionCallback callback) override;
 
+  /**
+   * @brief Set callback fired when a message or connection event is queued
+   * @param callback Function to call, must be set before Initialize
+   */
+  void SetWakeupCallback(WakeupCallback callback) override;
+
+  /**
+   * @brief Get the link quality estimated for a client
+   * @param client_id Client identifier
+   * @param out Filled with the smoothed RTT and loss ratio
+   * @return false if the client is unknown
+   */
+  bool GetClientLinkStats(uint16_t client_id, ClientLinkStats &out) override;
+
+  /**
+   * @brief Get the latest ack received from a client
+   * @param client_id Client identifier
+   * @param ack Newest sequence number the client received
+   * @param ack_bits Bit i set if ack - (i + 1) was received too
+   * @return false if the client is unknown
+   */
+  bool GetClientAcks(uint16_t client_id, uint16_t &ack,
+                     uint32_t &ack_bits) override;
+
+  /**
+   * @brief Encode a UDP action for a client, callable from any thread
+   * @param client_id Client identifier
+   * @param ac Action to encode
+   * @param out Filled with the packet and its reserved sequence number
+   * @return false if the client has no UDP endpoint or the action is TCP
+   */
+  bool EncodeUDP(uint16_t client_id, const Action &ac,
+                 OutgoingDatagram &out) override;
+
+  /**
+   * @brief Post a batch of encoded datagrams to the IO thread in one task
+   * @param batch Datagrams, kept alive until their send completes
+   */
+  void SendBatchUDP(std::vector<OutgoingDatagram> batch) override;
+
   /**
    * @brief Get user information from database
    * @param username Username to search for
@@ -133,13 +182,41 @@ class ServerNetworkManager : public INetworkManager {
 
   /**
    * @brief Handle incoming UDP data
-   * @param data Received data bytes
+   * @param data Received data bytes, in the receive buffer
    * @param sender Sender endpoint
    */
-  void OnReceive(const std::vector<uint8_t> &data,
-                 const asio::ip::udp::endpoint &sender);
+  void OnReceive(ByteView data, const asio::ip::udp::endpoint &sender);
   void OnReceiveTCP(uint32_t client_id, const std::vector<uint8_t> &data);
 
+  /**
+   * @brief Handle a UDP fragment, queue the message once it is complete
+   * @param client Sender, nullptr if its endpoint is unknown
+   * @param data Received fragment
+   */
+  void OnReceiveFragment(const ClientManager::ClientPtr &client,
+                         ByteView data);
+
+  /**
+   * @brief Queue a decoded message for the game thread
+   */
+  void PushMessage(uint16_t client_id, Event evt);
+
+  /**
+   * @brief Drop the reliable packets covered by an ack of the client
+   */
+  void AcknowledgeHistory(HandleClient &client, uint16_t ack,
+                          uint32_t ack_bits);
+
+  /**
+   * @brief Send an encoded UDP packet, split in fragments when it does not
+   * fit in one datagram
+   * @param client Destination, with a UDP endpoint
+   * @param packet Packet, its header holding a reserved sequence number
+   * @param reliable Keep each datagram for resending until acknowledged
+   */
+  void SendUDPPacket(HandleClient &client, PacketPool::Buffer packet,
+                     bool reliable);
+
   /**
    * @brief Handle TCP login event
    * @param client_id Client identifier
@@ -156,11 +233,19 @@ class ServerNetworkManager : public INetworkManager {
    */
   void OnTCPDisconnect(uint32_t client_id);
 
+  /**
+   * @brief Signal the game thread that new work is queued
+   */
+  void NotifyWakeup();
+
   Encoder encode;
   Decoder decode;
 
   std::unique_ptr<IDatabase> db;
   bool GameStarted = false;      ///< Game started state flag
+  /// Packet buffers, declared before the I/O context whose pending sends
+  /// still hold some of them
+  PacketPool packet_pool_;
   asio::io_context io_context_;  ///< ASIO I/O context for async operations
   std::unique_ptr<asio::io_context::work>
       work_guard_;  ///< Work guard to keep I/O context running
@@ -170,9 +255,9 @@ class ServerNetworkManager : public INetworkManager {
 
   ClientManager client_manager_;  ///< Manager for connected clients
 
-  std::queue<NetworkMessage>
-      incoming_messages_;   ///< Queue of incoming messages
-  std::mutex queue_mutex_;  ///< Mutex for message queue access
+  MpscQueue<NetworkMessage> incoming_messages_{
+      4096};  ///< Queue of incoming messages, IO thread to main thread
+  uint64_t reported_drops_ = 0;  ///< Incoming drops already logged
 
   std::queue<ConnectionEvent>
       connection_events_;    ///< Queue of connection events
@@ -182,6 +267,7 @@ class ServerNetworkManager : public INetworkManager {
   ConnectionCallback connection_callback_;  ///< Callback for client connections
   DisconnectionCallback
       disconnection_callback_;  ///< Callback for client disconnections
+  WakeupCallback wakeup_callback_;  ///< Callback when work is queued
 
   std::unique_ptr<asio::steady_timer>
       timeout_timer_;  ///< Timer for checking client timeouts
@@ -18,6 +18,7 @@
 
 #include "include/ServerMacro.hpp"
 #include "network/DecodeFunc.hpp"
+#include "network/PacketPool.hpp"
 
 using MessageCallback =
     std::function<void(uint32_t, const std::vector<uint8_t>&)>;
@@ -84,7 +85,15 @@ class TCPServer {
    * @param data Data bytes to send
    * @param client_id Target client identifier
    */
-  void SendTo(const std::vector<uint8_t>& data, uint16_t client_id);
+  void SendTo(PacketPool::Buffer data, uint16_t client_id);
+
+  /**
+   * @brief Send a packet shared by several clients
+   * @param data Data bytes to send, kept alive until the write completes
+   * @param client_id Target client identifier
+   */
+  void SendTo(std::shared_ptr<const std::vector<uint8_t>> data,
+              uint16_t client_id);
 
  private:
   MessageCallback message_callback_;
@@ -146,7 +155,13 @@ class ProcessPacketTCP : public std::enable_shared_from_this<ProcessPacketTCP> {
    * @brief Send a packet to the client
    * @param data Data bytes to send
    */
-  void SendPacket(const std::vector<uint8_t>& data);
+  void SendPacket(PacketPool::Buffer data);
+
+  /**
+   * @brief Send a packet shared with other clients
+   * @param data Data bytes to send, kept alive until the write completes
+   */
+  void SendPacket(std::shared_ptr<const std::vector<uint8_t>> data);
 
   /**
    * @brief Get client ID
@@ -8,6 +8,9 @@
 
 #include <asio.hpp>
 
+#include "network/ByteView.hpp"
+#include "network/PacketPool.hpp"
+
 
 /**
  * @class UDPServer
@@ -17,9 +20,9 @@
  */
 class UDPServer {
  public:
-  using ReceiveCallback = std::function<void(
-      const std::vector<uint8_t>&,
-      const asio::ip::udp::endpoint&)>;  ///< Receive callback type
+  /// Receive callback type, the bytes are only valid during the call
+  using ReceiveCallback =
+      std::function<void(ByteView, const asio::ip::udp::endpoint&)>;
 
   UDPServer(asio::io_context& io_context, uint16_t port,
             const std::string& host = "0.0.0.0");
@@ -32,11 +35,22 @@ class UDPServer {
   void SetReceiveCallback(ReceiveCallback callback);
 
   /**
-   * @brief Send data to a specific endpoint
-   * @param data Data bytes to send
+   * @brief Send a pooled packet to a specific endpoint
+   * @param data Packet, back to its pool once the send completes
+   * @param endpoint Target UDP endpoint
+   */
+  void SendTo(PacketPool::Buffer data,
+              const asio::ip::udp::endpoint& endpoint);
+
+  /**
+   * @brief Send one datagram gathered from two buffers, e.g. the header of
+   * a client followed by a payload shared by several clients
+   * @param owner Owner of the buffers, kept alive until completion
+   * @param buffers Buffers sent in order
    * @param endpoint Target UDP endpoint
    */
-  void SendTo(const std::vector<uint8_t>& data,
+  void SendTo(std::shared_ptr<const void> owner,
+              const std::array<asio::const_buffer, 2>& buffers,
               const asio::ip::udp::endpoint& endpoint);
 
   /**
@@ -0,0 +1,95 @@
+#include "include/JobPool.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+JobPool::JobPool(size_t workers) {
+  if (workers == 0) {
+    size_t cores = std::thread::hardware_concurrency();
+    workers = cores > 1 ? cores - 1 : 1;
+  }
+
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back(&JobPool::WorkerLoop, this);
+  }
+  std::cout << "[JobPool] " << workers << " workers started" << std::endl;
+}
+
+JobPool::~JobPool() { Stop(); }
+
+void JobPool::ParallelFor(size_t count, const Job& job) {
+  if (count == 0) return;
+  if (count == 1 || workers_.empty()) {
+    for (size_t i = 0; i < count; ++i) job(i);
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->job = &job;
+  batch->count = count;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+      for (size_t i = 0; i < count; ++i) job(i);
+      return;
+    }
+    pending_.push_back(batch);
+  }
+  cv_.notify_all();
+
+  // L'appelant travaille aussi, le lot avance meme si tous les workers
+  // sont pris
+  RunBatch(*batch);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCv_.wait(lock, [&] { return batch->done.load() == count; });
+  auto it = std::find(pending_.begin(), pending_.end(), batch);
+  if (it != pending_.end()) pending_.erase(it);
+}
+
+void JobPool::RunBatch(Batch& batch) {
+  size_t ran = 0;
+  size_t index;
+  while ((index = batch.next.fetch_add(1)) < batch.count) {
+    (*batch.job)(index);
+    ran++;
+  }
+  if (ran > 0 && batch.done.fetch_add(ran) + ran == batch.count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    doneCv_.notify_all();
+  }
+}
+
+void JobPool::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (running_) {
+    if (pending_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto batch = pending_.front();
+    if (batch->next.load() >= batch->count) {
+      // Tous les jobs sont pris, l'appelant attend juste leur fin
+      pending_.pop_front();
+      continue;
+    }
+
+    lock.unlock();
+    RunBatch(*batch);
+    lock.lock();
+  }
+}
+
+void JobPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) worker.join();
+  }
+}
@@ -0,0 +1,119 @@
+#include "include/LobbyScheduler.hpp"
+
+#include <iostream>
+#include <utility>
+
+LobbyScheduler::LobbyScheduler(size_t workers) {
+  if (workers == 0) workers = std::thread::hardware_concurrency();
+  if (workers == 0) workers = 2;
+
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back(&LobbyScheduler::WorkerLoop, this);
+  }
+  std::cout << "[Scheduler] " << workers << " lobby workers started"
+            << std::endl;
+}
+
+LobbyScheduler::~LobbyScheduler() { Stop(); }
+
+void LobbyScheduler::Schedule(uint16_t lobbyId,
+                              Clock::time_point firstDeadline,
+                              Clock::duration period, TickFunc tick,
+                              std::function<void()> onFinished) {
+  Cancel(lobbyId);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto task = std::make_shared<Task>();
+  task->id = lobbyId;
+  task->generation = nextGeneration_++;
+  task->deadline = firstDeadline;
+  task->period = period;
+  task->tick = std::move(tick);
+  task->onFinished = std::move(onFinished);
+  tasks_[lobbyId] = task;
+  heap_.push({firstDeadline, lobbyId, task->generation});
+  cv_.notify_one();
+}
+
+void LobbyScheduler::Cancel(uint16_t lobbyId) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = tasks_.find(lobbyId);
+  if (it == tasks_.end()) return;
+
+  auto task = it->second;
+  task->cancelled = true;
+  tasks_.erase(it);
+  // Son entree dans le tas est ignoree grace a la generation
+  doneCv_.wait(lock, [&] { return !task->running; });
+}
+
+void LobbyScheduler::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+    for (auto& [id, task] : tasks_) task->cancelled = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) worker.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.clear();
+  heap_ = {};
+}
+
+void LobbyScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (running_) {
+    if (heap_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    HeapEntry top = heap_.top();
+    auto it = tasks_.find(top.id);
+    if (it == tasks_.end() || it->second->generation != top.generation) {
+      heap_.pop();
+      continue;
+    }
+
+    auto now = Clock::now();
+    if (top.deadline > now) {
+      cv_.wait_until(lock, top.deadline);
+      continue;
+    }
+
+    heap_.pop();
+    auto task = it->second;
+    task->running = true;
+    // Un autre worker peut prendre la prochaine echeance
+    if (!heap_.empty()) cv_.notify_one();
+    lock.unlock();
+
+    bool keep = task->tick(now - task->deadline);
+
+    lock.lock();
+    task->running = false;
+
+    if (!keep && !task->cancelled) {
+      tasks_.erase(task->id);
+      auto onFinished = std::move(task->onFinished);
+      lock.unlock();
+      doneCv_.notify_all();
+      if (onFinished) onFinished();
+      lock.lock();
+      continue;
+    }
+
+    if (!task->cancelled) {
+      // Echeances fixes ; si on a pris du retard le tick suivant part
+      // tout de suite, le rattrapage est gere par le tick du lobby
+      task->deadline += task->period;
+      if (task->deadline < now) task->deadline = now;
+      heap_.push({task->deadline, task->id, task->generation});
+    }
+    doneCv_.notify_all();
+  }
+}
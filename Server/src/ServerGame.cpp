@@ -31,9 +31,16 @@
 #include "systems/WaveSystem.hpp"
 #include "systems/WeaponSystem.hpp"
 #include "Helpers/SharedDiff.hpp"
+#include "IdIndex.hpp"
+
+// Le serveur headless charge les variantes des scenes compilees sans SDL
+#ifdef ENGINE_HEADLESS
+#define SCENE_VARIANT "_headless"
+#else
+#define SCENE_VARIANT ""
+#endif
 
 ServerGame::ServerGame() : serverRunning(true) {
-  SetupDecoder(decode);
   SetupEncoder(encode);
 #ifdef _WIN32
   DLLoader<INetworkManager> loader("../src/build/libnetwork_server.dll",
@@ -47,8 +54,10 @@ ServerGame::ServerGame() : serverRunning(true) {
 void ServerGame::CreateLobby(uint16_t playerId, std::string lobbyName,
                              std::string playerName, std::string mdp,
                              uint8_t difficulty, uint8_t Maxplayer) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
+  // Un client n'est que dans un lobby a la fois
+  RemovePlayerFromLobby(playerId);
 
+  // Init du moteur et chargement des scenes hors de tout verrou
   auto l = std::make_unique<lobby_list>();
   l->lobby_id = nextLobbyId++;
   l->host_id = playerId;
@@ -66,20 +75,20 @@ void ServerGame::CreateLobby(uint16_t playerId, std::string lobbyName,
   }
 
 #ifdef _WIN32
-  if (!l->m_engine.GetSceneManager().LoadSceneModule("rtype", "../../Client/src/scenes/libscene_rtypescene.dll")) {
+  if (!l->m_engine.GetSceneManager().LoadSceneModule("rtype", "../../Client/src/scenes/libscene_rtypescene" SCENE_VARIANT ".dll")) {
     std::cerr << "Failed to load game scene!" << std::endl;
     return;
   }
-  if (!l->m_engine.GetSceneManager().LoadSceneModule("secondgame", "../../Client/src/scenes/libscene_secondgame.dll")) {
+  if (!l->m_engine.GetSceneManager().LoadSceneModule("secondgame", "../../Client/src/scenes/libscene_secondgame" SCENE_VARIANT ".dll")) {
       std::cerr << "Failed to load game scene!" << std::endl;
       return;
   };
 #else
-  if (!l->m_engine.GetSceneManager().LoadSceneModule("rtype", "../../Client/src/scenes/libscene_rtypescene.so")) {
+  if (!l->m_engine.GetSceneManager().LoadSceneModule("rtype", "../../Client/src/scenes/libscene_rtypescene" SCENE_VARIANT ".so")) {
     std::cerr << "Failed to load game scene!" << std::endl;
     return;
   }
-  if (!l->m_engine.GetSceneManager().LoadSceneModule("secondGame", "../../Client/src/scenes/libscene_secondgame.so")) {
+  if (!l->m_engine.GetSceneManager().LoadSceneModule("secondGame", "../../Client/src/scenes/libscene_secondgame" SCENE_VARIANT ".so")) {
       std::cerr << "Failed to load game scene!" << std::endl;
       return;
   };
@@ -111,8 +120,11 @@ void ServerGame::CreateLobby(uint16_t playerId, std::string lobbyName,
   SendAction(std::make_tuple(ac, playerId, nullptr));
 
   lobby_list* lobbyPtr = l.get();
-
-  lobbys.push_back(std::move(l));
+  {
+    std::lock_guard<std::mutex> lock(directoryMutex);
+    playerLobby[playerId] = lobbyPtr->lobby_id;
+    lobbys.emplace(lobbyPtr->lobby_id, std::move(l));
+  }
   SendLobbyUpdate(*lobbyPtr);
 }
 
@@ -142,19 +154,15 @@ void ServerGame::SendLobbyUpdate(lobby_list& lobby) {
 
 void ServerGame::JoinLobby(uint16_t playerId, std::string playerName,
                            uint16_t lobbyId, std::string mdp) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
+  lobby_list* current = FindPlayerLobby(playerId);
+  if (current && current->lobby_id != lobbyId) {
+    RemovePlayerFromLobby(playerId);
+  }
 
   Action ac;
   LobbyJoinResponse resp;
 
-  lobby_list* targetLobby = nullptr;
-  for (auto& lobby : lobbys) {
-    if (lobby->lobby_id == lobbyId) {
-      targetLobby = lobby.get();
-      break;
-    }
-  }
-
+  lobby_list* targetLobby = FindLobby(lobbyId);
   if (!targetLobby) {
     resp.success = false;
     resp.errorCode = 0x2010;
@@ -163,7 +171,12 @@ void ServerGame::JoinLobby(uint16_t playerId, std::string playerName,
     ac.type = ActionType::LOBBY_JOIN_RESPONSE;
     ac.data = resp;
     SendAction(std::make_tuple(ac, playerId, nullptr));
+    return;
+  }
 
+  std::lock_guard<std::mutex> lock(targetLobby->mutex);
+  if (targetLobby == current) {
+    // Deja dans ce lobby : on renvoie seulement la reponse
   } else if (targetLobby->nb_player >= targetLobby->max_players) {
     resp.success = false;
     resp.errorCode = 0x2012;
@@ -172,7 +185,7 @@ void ServerGame::JoinLobby(uint16_t playerId, std::string playerName,
     ac.type = ActionType::LOBBY_JOIN_RESPONSE;
     ac.data = resp;
     SendAction(std::make_tuple(ac, playerId, nullptr));
-
+    return;
   } else if (targetLobby->hasPassword && targetLobby->mdp != mdp) {
     resp.success = false;
     resp.errorCode = 0x2011;
@@ -181,6 +194,7 @@ void ServerGame::JoinLobby(uint16_t playerId, std::string playerName,
     ac.type = ActionType::LOBBY_JOIN_RESPONSE;
     ac.data = resp;
     SendAction(std::make_tuple(ac, playerId, nullptr));
+    return;
   } else {
     if (targetLobby->gameRuning) {
       targetLobby->spectate.push_back(
@@ -190,64 +204,83 @@ void ServerGame::JoinLobby(uint16_t playerId, std::string playerName,
           std::make_tuple(playerId, false, playerName));
     }
     targetLobby->nb_player++;
+    std::lock_guard<std::mutex> dirLock(directoryMutex);
+    playerLobby[playerId] = lobbyId;
+  }
 
-    resp.success = true;
-    resp.lobbyId = lobbyId;
-    resp.playerId = playerId;
+  resp.success = true;
+  resp.lobbyId = lobbyId;
+  resp.playerId = playerId;
 
-    for (auto& [pId, ready, pName] : targetLobby->players_list) {
-      LobbyPlayer p;
-      p.playerId = pId;
-      p.ready = ready;
-      p.username = pName;
-      resp.players.push_back(p);
-    }
+  for (auto& [pId, ready, pName] : targetLobby->players_list) {
+    LobbyPlayer p;
+    p.playerId = pId;
+    p.ready = ready;
+    p.username = pName;
+    resp.players.push_back(p);
+  }
 
-    ac.type = ActionType::LOBBY_JOIN_RESPONSE;
-    ac.data = resp;
-    SendAction(std::make_tuple(ac, playerId, nullptr));
+  ac.type = ActionType::LOBBY_JOIN_RESPONSE;
+  ac.data = resp;
+  SendAction(std::make_tuple(ac, playerId, nullptr));
 
-    std::cout << "[Lobby] Player " << playerId << " joined lobby " << lobbyId
-              << std::endl;
-    SendLobbyUpdate(*targetLobby);
-  }
+  std::cout << "[Lobby] Player " << playerId << " joined lobby " << lobbyId
+            << std::endl;
+  SendLobbyUpdate(*targetLobby);
 }
 
 void ServerGame::RemovePlayerFromLobby(uint16_t playerId) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
-  for (auto it = lobbys.begin(); it != lobbys.end();) {
-    bool found = false;
-    auto& lobby = *it;
-
-    for (auto pIt = lobby->players_list.begin();
-         pIt != lobby->players_list.end(); ++pIt) {
-      if (std::get<0>(*pIt) == playerId) {
-        lobby->players_list.erase(pIt);
-        lobby->nb_player--;
-        found = true;
-        break;
-      }
+  lobby_list* lobby = FindPlayerLobby(playerId);
+  if (!lobby) return;
+
+  bool empty = false;
+  {
+    std::lock_guard<std::mutex> lock(lobby->mutex);
+    auto erasePlayer =
+        [playerId](std::vector<std::tuple<uint16_t, bool, std::string>>& v) {
+          for (auto it = v.begin(); it != v.end(); ++it) {
+            if (std::get<0>(*it) == playerId) {
+              v.erase(it);
+              return true;
+            }
+          }
+          return false;
+        };
+    if (erasePlayer(lobby->players_list) || erasePlayer(lobby->spectate)) {
+      lobby->nb_player--;
     }
+    {
+      std::lock_guard<std::mutex> dirLock(directoryMutex);
+      playerLobby.erase(playerId);
+    }
+    ForgetClientSnapshots(playerId, *lobby);
 
-    if (found) {
-      if (lobby->nb_player == 0) {
-        lobby->gameRuning = false;
-        if (lobby->gameThread.joinable()) {
-          lobby->gameThread.join();
-        }
-        it = lobbys.erase(it);
-      } else {
-        if (lobby->host_id == playerId) {
-          lobby->host_id = std::get<0>(lobby->players_list[0]);
-        }
-        SendLobbyUpdate(*lobby);
-        ++it;
-      }
-      break;
+    if (lobby->nb_player == 0) {
+      lobby->gameRuning = false;
+      empty = true;
     } else {
-      ++it;
+      if (lobby->host_id == playerId && !lobby->players_list.empty()) {
+        lobby->host_id = std::get<0>(lobby->players_list[0]);
+      }
+      SendLobbyUpdate(*lobby);
     }
   }
+  if (!empty) return;
+
+  std::unique_ptr<lobby_list> owned;
+  {
+    std::lock_guard<std::mutex> dirLock(directoryMutex);
+    auto it = lobbys.find(lobby->lobby_id);
+    if (it == lobbys.end()) return;
+    owned = std::move(it->second);
+    lobbys.erase(it);
+  }
+  // Hors du verrou du lobby : Cancel attend la fin du tick en cours, qui le
+  // prend aussi
+  if (owned->loopScheduled) {
+    scheduler.Cancel(owned->lobby_id);
+  }
+  std::cout << "[Lobby] " << owned->lobby_id << " closed" << std::endl;
 }
 
 void ServerGame::ResetLobbyReadyStatus(lobby_list& lobby) {
@@ -261,81 +294,73 @@ void ServerGame::ResetLobbyReadyStatus(lobby_list& lobby) {
 }
 
 void ServerGame::HandlePayerReady(uint16_t playerId, bool isReady) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
-
-  lobby_list* l;
+  lobby_list* lobby = FindPlayerLobby(playerId);
+  if (!lobby) return;
 
-  for (auto& lobby : lobbys) {
-    uint16_t nbPlayerReady = 0;
-    bool found = false;
-    bool isSpectate = false;
+  std::lock_guard<std::mutex> lock(lobby->mutex);
+  uint16_t nbPlayerReady = 0;
+  bool isSpectate = false;
 
-    for (auto& player : lobby->players_list) {
-      if (std::get<0>(player) == playerId) {
-        std::get<1>(player) = isReady;
-        found = true;
-      }
-      if (std::get<1>(player) == true) {
-        nbPlayerReady++;
-      }
+  for (auto& player : lobby->players_list) {
+    if (std::get<0>(player) == playerId) {
+      std::get<1>(player) = isReady;
     }
-
-    for (auto& player : lobby->spectate) {
-      if (std::get<0>(player) == playerId) {
-        std::get<1>(player) = isReady;
-        found = true;
-        isSpectate = true;
-        l = lobby.get();
-      }
+    if (std::get<1>(player) == true) {
+      nbPlayerReady++;
     }
+  }
 
-    if (found) {
-      SendLobbyUpdate(*lobby);
-
-      if (lobby->gameRuning && isReady) {
-        size_t playerIndex = 0;
-        for (size_t i = 0; i < lobby->players_list.size(); ++i) {
-          if (std::get<0>(lobby->players_list[i]) == playerId) {
-            playerIndex = i;
-            break;
-          }
-        }
+  for (auto& player : lobby->spectate) {
+    if (std::get<0>(player) == playerId) {
+      std::get<1>(player) = isReady;
+      isSpectate = true;
+    }
+  }
 
-        float spawnY = 200.0f + (playerIndex % 4) * 100.0f;
-
-        if (isSpectate) {
-          SendMapToClients(playerId, *l);
-          Action startAc;
-          GameStart gs;
-          gs.playerSpawnX = 200.0f;
-          gs.playerSpawnY = spawnY;
-          gs.scrollSpeed = 0;
-          startAc.type = ActionType::GAME_START;
-          startAc.data = gs;
-          SendAction(std::make_tuple(startAc, playerId, nullptr));
-        }
-        lobby->lastStates.erase(playerId);
-        lobby->playerStateCount.erase(playerId);
+  SendLobbyUpdate(*lobby);
 
-        return;
+  if (lobby->gameRuning && isReady) {
+    size_t playerIndex = 0;
+    for (size_t i = 0; i < lobby->players_list.size(); ++i) {
+      if (std::get<0>(lobby->players_list[i]) == playerId) {
+        playerIndex = i;
+        break;
       }
-      if (nbPlayerReady == lobby->nb_player && !lobby->gameRuning) {
-        lobby->players_ready = true;
+    }
+
+    float spawnY = 200.0f + (playerIndex % 4) * 100.0f;
+
+    if (isSpectate) {
+      SendMapToClients(playerId, *lobby);
+      Action startAc;
+      GameStart gs;
+      gs.playerSpawnX = 200.0f;
+      gs.playerSpawnY = spawnY;
+      gs.scrollSpeed = 0;
+      startAc.type = ActionType::GAME_START;
+      startAc.data = gs;
+      SendAction(std::make_tuple(startAc, playerId, nullptr));
+    }
+    ForgetClientSnapshots(playerId, *lobby);
+    return;
+  }
+  // loopScheduled : la boucle de la partie precedente n'est pas encore
+  // remise a zero, Schedule attendrait son tick qui attend ce verrou
+  if (nbPlayerReady == lobby->nb_player && !lobby->gameRuning &&
+      !lobby->loopScheduled) {
+    lobby->players_ready = true;
 
-        Action ac;
-        LobbyStart start;
-        start.countdown = 3;
-        ac.type = ActionType::LOBBY_START;
-        ac.data = start;
+    Action ac;
+    LobbyStart start;
+    start.countdown = 3;
+    ac.type = ActionType::LOBBY_START;
+    ac.data = start;
 
-        for (auto& [pId, ready, _] : lobby->players_list) {
-          SendAction(std::make_tuple(ac, pId, nullptr));
-        }
-        lobby->gameRuning = true;
-        StartGame(*lobby);
-      }
-      break;
+    for (auto& [pId, ready, _] : lobby->players_list) {
+      SendAction(std::make_tuple(ac, pId, nullptr));
     }
+    lobby->gameRuning = true;
+    StartGame(*lobby);
   }
 }
 
@@ -355,12 +380,11 @@ void ServerGame::HandleLobbyJoinRequest(uint16_t playerId, Event& ev) {
 }
 
 void ServerGame::HandleLobbyListRequest(uint16_t playerId) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
-
   Action ac;
   LobbyListResponse resp;
 
-  for (const auto& lobby : lobbys) {
+  for (lobby_list* lobby : LobbySnapshot()) {
+    std::lock_guard<std::mutex> lock(lobby->mutex);
     LobbyInfo info;
     info.lobbyId = lobby->lobby_id;
     info.name = lobby->name;
@@ -383,17 +407,19 @@ void ServerGame::HandleLobbyLeave(uint16_t playerId) {
 
 void ServerGame::HandleLobbyKick(uint16_t playerId, uint16_t playerKickId) {
   lobby_list* lobby = FindPlayerLobby(playerId);
-  if (!lobby) return;
-
-  if (playerId != lobby->host_id) return;
+  if (!lobby || FindPlayerLobby(playerKickId) != lobby) return;
+  {
+    std::lock_guard<std::mutex> lock(lobby->mutex);
+    if (playerId != lobby->host_id) return;
+  }
   Action ac;
   ac.type = ActionType::LOBBY_KICK;
   LobbyKick resp;
   resp.playerId = playerKickId;
   ac.data = resp;
   SendAction(std::make_tuple(ac, playerKickId, nullptr));
+  // Envoie aussi le LOBBY_UPDATE aux joueurs restants
   RemovePlayerFromLobby(playerKickId);
-  SendLobbyUpdate(*lobby);
 }
 
 void ServerGame::HandleLobbyMessage(uint16_t playerId, Event& ev) {
@@ -423,15 +449,25 @@ void ServerGame::HandleLobbyMessage(uint16_t playerId, Event& ev) {
 }
 
 lobby_list* ServerGame::FindPlayerLobby(uint16_t playerId) {
-  std::lock_guard<std::mutex> lock(lobbyMutex);
-  for (auto& lobby : lobbys) {
-    for (auto& [pId, ready, _] : lobby->players_list) {
-      if (pId == playerId) {
-        return lobby.get();
-      }
-    }
-  }
-  return nullptr;
+  std::lock_guard<std::mutex> lock(directoryMutex);
+  auto it = playerLobby.find(playerId);
+  if (it == playerLobby.end()) return nullptr;
+  auto lobbyIt = lobbys.find(it->second);
+  return lobbyIt != lobbys.end() ? lobbyIt->second.get() : nullptr;
+}
+
+lobby_list* ServerGame::FindLobby(uint16_t lobbyId) {
+  std::lock_guard<std::mutex> lock(directoryMutex);
+  auto it = lobbys.find(lobbyId);
+  return it != lobbys.end() ? it->second.get() : nullptr;
+}
+
+std::vector<lobby_list*> ServerGame::LobbySnapshot() {
+  std::lock_guard<std::mutex> lock(directoryMutex);
+  std::vector<lobby_list*> res;
+  res.reserve(lobbys.size());
+  for (auto& [id, lobby] : lobbys) res.push_back(lobby.get());
+  return res;
 }
 
 void ServerGame::HandleClientLeave(uint16_t playerId) {
@@ -440,28 +476,21 @@ void ServerGame::HandleClientLeave(uint16_t playerId) {
   lobby_list* lobby = FindPlayerLobby(playerId);
 
   if (lobby) {
-    std::lock_guard<std::mutex> lock(lobbyMutex);
-    auto m_players = lobby->m_engine.GetCurrentScene()->GetPlayers();
+    std::lock_guard<std::mutex> lock(lobby->mutex);
+    Scene* currentScene = lobby->m_engine.GetCurrentScene();
+    auto m_players = currentScene ? currentScene->GetPlayers()
+                                  : std::unordered_map<uint16_t, Entity>{};
     auto itEntity = m_players.find(playerId);
-    
-    if (itEntity != lobby->m_players.end()) {
+
+    if (itEntity != m_players.end()) {
       Entity playerEntity = itEntity->second;
       if (lobby->m_engine.GetRegistry().is_entity_valid(playerEntity)) {
         std::cout << "[SERVER] Killing entity for player " << playerId << std::endl;
         lobby->m_engine.GetRegistry().kill_entity(playerEntity);
-
-      }
-    }
-
-    for (auto specIt = lobby->spectate.begin(); specIt != lobby->spectate.end();
-         ++specIt) {
-      if (std::get<0>(*specIt) == playerId) {
-        lobby->spectate.erase(specIt);
-        lobby->nb_player--;
-        break;
       }
     }
   }
+  // Retire aussi les spectateurs
   RemovePlayerFromLobby(playerId);
 }
 
@@ -481,79 +510,20 @@ void ServerGame::HandleLoginResponse(uint16_t playerId, Event& ev) {
 }
 
 void ServerGame::SetupNetworkCallbacks() {
-  networkManager->SetMessageCallback([this](const NetworkMessage& msg) {
-    Event ev = decode.decode(msg.data);
+  networkManager->SetMessageCallback([this](NetworkMessage&& msg) {
+    Event ev = std::move(msg.event);
     uint16_t playerId = msg.client_id;
 
     lobby_list* targetLobby = FindPlayerLobby(playerId);
 
     if (targetLobby && targetLobby->gameRuning &&
-        ev.type == EventType::PLAYER_INPUT) {
-      std::lock_guard<std::mutex> lock(targetLobby->lobbyQueueMutex);
-      targetLobby->lobbyEventQueue.push({ev, playerId});
+        (ev.type == EventType::PLAYER_INPUT ||
+         ev.type == EventType::ASSETS_READY)) {
+      targetLobby->lobbyEventQueue.TryPush({std::move(ev), playerId});
       return;
     }
 
-    {
-      std::lock_guard<std::mutex> lock(queueMutex);
-      eventQueue.push(std::make_tuple(ev, playerId));
-    }
-
-    switch (ev.type) {
-      case EventType::LOGIN_REQUEST: {
-        std::cout << "[ServerGame] Login request from: " << playerId
-                  << std::endl;
-        HandleLoginResponse(playerId, ev);
-        break;
-      }
-      case EventType::LOBBY_CREATE:
-        std::cout << "[Network] LOBBY_CREATE from " << playerId << std::endl;
-        HandleLobbyCreate(playerId, ev);
-        break;
-
-      case EventType::LOBBY_JOIN_REQUEST:
-        std::cout << "[Network] LOBBY_JOIN_REQUEST from " << playerId
-                  << std::endl;
-        HandleLobbyJoinRequest(playerId, ev);
-        break;
-
-      case EventType::LOBBY_LIST_REQUEST:
-        HandleLobbyListRequest(playerId);
-        break;
-
-      case EventType::PLAYER_READY:
-        std::cout << "[Network] PLAYER_READY from " << playerId << std::endl;
-        HandlePayerReady(playerId, std::get<PLAYER_READY>(ev.data).ready);
-        break;
-
-      case EventType::LOBBY_LEAVE:
-        std::cout << "[Network] LOBBY_LEAVE from " << playerId << std::endl;
-        HandleLobbyLeave(playerId);
-        break;
-
-      case EventType::LOBBY_KICK: {
-        auto& d = std::get<LOBBY_KICK>(ev.data);
-        std::cout << "[Network] LOBBY_LEAVE from " << playerId << std::endl;
-        HandleLobbyKick(playerId, d.playerId);
-        break;
-      }
-      case EventType::MESSAGE:
-        HandleLobbyMessage(playerId, ev);
-        break;
-
-      case EventType::CLIENT_LEAVE:
-        HandleClientLeave(playerId);
-        break;
-      case EventType::ERROR_TYPE: {
-        auto& d = std::get<ERROR_EVNT>(ev.data);
-        std::cerr << "[Network Error] Client " << playerId << ": " << d.message
-                  << std::endl;
-        break;
-      }
-
-      default:
-        break;
-    }
+    eventQueue.TryPush(std::make_tuple(std::move(ev), playerId));
   });
 
   networkManager->SetConnectionCallback([this](uint16_t client_id) {
@@ -562,26 +532,13 @@ void ServerGame::SetupNetworkCallbacks() {
 
   networkManager->SetDisconnectionCallback([this](uint16_t client_id) {
     std::cout << "Client " << client_id << " disconnected!" << std::endl;
-    std::lock_guard<std::mutex> lock(lobbyMutex);
-    for (auto& lobby : lobbys) {
-      Scene* currentScene = lobby->m_engine.GetCurrentScene();
-      if (currentScene) {
-        auto m_players = currentScene->GetPlayers();
-        auto it = m_players.find(client_id);
-        
-        if (it != m_players.end()) {
-          Entity playerEntity = it->second;
-          std::cout << "[DISCONNECT] Killing entity for client " << client_id << std::endl;
-          lobby->m_engine.GetRegistry().kill_entity(playerEntity);
-        }
-      }
-    }
-    RemovePlayerFromLobby(client_id);
+    HandleClientLeave(client_id);
   });
 }
 
 bool ServerGame::Initialize(uint16_t tcpPort, uint16_t udpPort, int diff,
                             const std::string& host) {
+  networkManager->SetWakeupCallback([this]() { Wake(); });
   if (!networkManager->Initialize(tcpPort, udpPort, host)) {
     std::cerr << "Failed to initialize network manager" << std::endl;
     return false;
@@ -623,6 +580,10 @@ void ServerGame::StartGame(lobby_list& lobby) {
   SceneData& data = lobby.m_engine.GetSceneData();
   data.Set("players_list", lobby.players_list);
   data.Set("difficulty", lobby.difficulty);
+  lobby.inputBuffers.clear();
+  lobby.inputBuffers.setTick(lobby.currentTick);
+  lobby.sendRates.clear();
+  data.Set("player_inputs", &lobby.inputBuffers);
 
   if (lobby.name == "secondgame") {
     lobby.m_engine.ChangeScene("secondGame");
@@ -637,22 +598,119 @@ void ServerGame::StartGame(lobby_list& lobby) {
   }
 
   std::cout << "Lobby full! Starting the game!!!!" << std::endl;
-  lobby.gameThread = std::thread(&ServerGame::GameLoop, this, std::ref(lobby));
+  lobby.gameStarted = false;
+  lobby.loopFinished = false;
+  lobby.loopScheduled = true;
+
+  // La map part tout de suite ; la partie demarre quand tous les clients
+  // ont signale ASSETS_READY, ou au bout de LOADING_TIMEOUT
+  SendMapToLobby(lobby);
+  lobby.loadingPending.clear();
+  for (auto& [playerId, ready, _] : lobby.players_list) {
+    if (playerId != 0) lobby.loadingPending.insert(playerId);
+  }
+  lobby.loadingDeadline = std::chrono::steady_clock::now() + LOADING_TIMEOUT;
+
+  lobby_list* l = &lobby;
+  scheduler.Schedule(
+      lobby.lobby_id, std::chrono::steady_clock::now(), TickPeriod(),
+      [this, l](std::chrono::steady_clock::duration lateness) {
+        return GameTick(*l, lateness);
+      },
+      [this, l]() {
+        l->loopFinished = true;
+        Wake();
+      });
 }
 
 std::optional<std::tuple<Event, uint16_t>> ServerGame::PopEvent() {
-  std::lock_guard<std::mutex> lock(queueMutex);
-  if (eventQueue.empty()) {
-    return std::nullopt;
+  return eventQueue.TryPop();
+}
+
+void ServerGame::HandleEvent(uint16_t playerId, Event& ev) {
+  switch (ev.type) {
+    case EventType::LOGIN_REQUEST: {
+      std::cout << "[ServerGame] Login request from: " << playerId
+                << std::endl;
+      HandleLoginResponse(playerId, ev);
+      break;
+    }
+    case EventType::LOBBY_CREATE:
+      std::cout << "[Network] LOBBY_CREATE from " << playerId << std::endl;
+      HandleLobbyCreate(playerId, ev);
+      break;
+
+    case EventType::LOBBY_JOIN_REQUEST:
+      std::cout << "[Network] LOBBY_JOIN_REQUEST from " << playerId
+                << std::endl;
+      HandleLobbyJoinRequest(playerId, ev);
+      break;
+
+    case EventType::LOBBY_LIST_REQUEST:
+      HandleLobbyListRequest(playerId);
+      break;
+
+    case EventType::PLAYER_READY:
+      std::cout << "[Network] PLAYER_READY from " << playerId << std::endl;
+      HandlePayerReady(playerId, std::get<PLAYER_READY>(ev.data).ready);
+      break;
+
+    case EventType::LOBBY_LEAVE:
+      std::cout << "[Network] LOBBY_LEAVE from " << playerId << std::endl;
+      HandleLobbyLeave(playerId);
+      break;
+
+    case EventType::LOBBY_KICK: {
+      auto& d = std::get<LOBBY_KICK>(ev.data);
+      std::cout << "[Network] LOBBY_LEAVE from " << playerId << std::endl;
+      HandleLobbyKick(playerId, d.playerId);
+      break;
+    }
+    case EventType::MESSAGE:
+      HandleLobbyMessage(playerId, ev);
+      break;
+
+    case EventType::CLIENT_LEAVE:
+      HandleClientLeave(playerId);
+      break;
+    case EventType::ERROR_TYPE: {
+      auto& d = std::get<ERROR_EVNT>(ev.data);
+      std::cerr << "[Network Error] Client " << playerId << ": " << d.message
+                << std::endl;
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void ServerGame::DispatchEvents() {
+  while (auto evOpt = PopEvent()) {
+    auto& [ev, playerId] = *evOpt;
+    HandleEvent(playerId, ev);
   }
-  auto res = eventQueue.front();
-  eventQueue.pop();
-  return res;
 }
 
 void ServerGame::SendAction(std::tuple<Action, uint16_t, lobby_list*> ac) {
-  std::lock_guard<std::mutex> lock(queueMutex);
-  actionQueue.push(std::move(ac));
+  auto& [action, clientId, lobby] = ac;
+  // La file garde l'id du lobby : un lobby ferme entre-temps est ignore
+  if (!actionQueue.TryPush(std::make_tuple(std::move(action), clientId,
+                                           lobby ? lobby->lobby_id
+                                                 : uint16_t{0}))) {
+    std::cerr << "[ServerGame] Action queue full, action dropped"
+              << std::endl;
+    return;
+  }
+  Wake();
+}
+
+void ServerGame::Wake() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakePending = true;
+  }
+  wakeCv.notify_one();
 }
 
 void ServerGame::EndGame(lobby_list& lobby) {
@@ -704,8 +762,9 @@ void ServerGame::EndGame(lobby_list& lobby) {
   ac.data = g;
 
   SendAction(std::make_tuple(ac, 0, &lobby));
-  lobby.lastStates.clear();
-  lobby.playerStateCount.clear();
+  lobby.snapshotAcks.clear();
+  lobby.snapshotBudgets.clear();
+  lobby.snapshotHistory.Clear();
   lobby.gameRuning = false;
   std::cout << "game ended!!" << std::endl;
 }
@@ -732,85 +791,251 @@ void ServerGame::CheckGameEnded(lobby_list& lobby) {
   }
 }
 
-void ServerGame::GameLoop(lobby_list& lobby) {
-  for (int i = 0; i < 50 && lobby.gameRuning; ++i) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+bool ServerGame::LoadingDone(lobby_list& lobby) {
+  while (auto evOpt = PopEventLobby(lobby)) {
+    auto& [event, playerId] = *evOpt;
+    if (event.type == EventType::ASSETS_READY &&
+        lobby.loadingPending.erase(playerId) > 0) {
+      std::cout << "[Lobby] " << lobby.lobby_id << " player " << playerId
+                << " loaded, " << lobby.loadingPending.size() << " left"
+                << std::endl;
+    }
   }
 
-  const auto frameDuration = std::chrono::milliseconds(100);
-  auto lastTime = std::chrono::steady_clock::now();
+  if (lobby.loadingPending.empty()) return true;
+  if (std::chrono::steady_clock::now() < lobby.loadingDeadline) return false;
 
-  if (lobby.gameRuning) {
-    size_t playerIndex = 0;
-    SendMapToLobby(lobby);
-    for (auto& [playerId, ready, _] : lobby.players_list) {
-      float spawnY = 200.0f + (playerIndex % 4) * 100.0f;
-
-      Action ac;
-      GameStart g;
-      g.playerSpawnX = 200.0f;
-      g.playerSpawnY = spawnY;
-      g.scrollSpeed = 0;
-      ac.type = ActionType::GAME_START;
-      ac.data = g;
-      SendAction(std::make_tuple(ac, playerId, nullptr));
-      SceneData& data = lobby.m_engine.GetSceneData();
-      data.Set("difficulty", lobby.difficulty);
-
-      //  auto currentState =
-      //       std::make_shared<GameState>(BuildCurrentState(lobby));
-      //   ProcessAndSendState(playerId, lobby, currentState);
-      playerIndex++;
-    }
+  std::cout << "[Lobby] " << lobby.lobby_id << " loading timeout, starting"
+            << " without " << lobby.loadingPending.size() << " player(s)"
+            << std::endl;
+  lobby.loadingPending.clear();
+  return true;
+}
+
+void ServerGame::BeginGame(lobby_list& lobby) {
+  size_t playerIndex = 0;
+  SendMapToLobby(lobby);
+  for (auto& [playerId, ready, _] : lobby.players_list) {
+    float spawnY = 200.0f + (playerIndex % 4) * 100.0f;
+
+    Action ac;
+    GameStart g;
+    g.playerSpawnX = 200.0f;
+    g.playerSpawnY = spawnY;
+    g.scrollSpeed = 0;
+    ac.type = ActionType::GAME_START;
+    ac.data = g;
+    SendAction(std::make_tuple(ac, playerId, nullptr));
+    SceneData& data = lobby.m_engine.GetSceneData();
+    data.Set("difficulty", lobby.difficulty);
+    playerIndex++;
   }
 
   std::cout << "game starting" << std::endl;
+  lobby.gameStarted = true;
+  lobby.tickAccumulator = std::chrono::steady_clock::duration{0};
+  lobby.lastTickTime = std::chrono::steady_clock::now();
+}
+
+std::chrono::steady_clock::duration ServerGame::TickPeriod() const {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / tickRate));
+}
+
+bool ServerGame::GameTick(lobby_list& lobby,
+                          std::chrono::steady_clock::duration lateness) {
+  // Le tick garde le lobby : les operations de lobby du thread principal
+  // attendent au plus un tick, les autres lobbies ne sont pas bloques
+  std::lock_guard<std::mutex> lock(lobby.mutex);
+  if (!lobby.gameRuning) return false;
+  if (!lobby.gameStarted) {
+    if (LoadingDone(lobby)) BeginGame(lobby);
+    return lobby.gameRuning;
+  }
 
-  while (lobby.gameRuning) {
-    auto currentTime = std::chrono::steady_clock::now();
-    float deltaTime =
-        std::chrono::duration<float>(currentTime - lastTime).count();
-    lastTime = currentTime;
+  double lateMs =
+      std::chrono::duration<double, std::milli>(lateness).count();
+  lobby.tickStats.lastLateMs = lateMs;
+  if (lateMs > lobby.tickStats.maxLateMs) lobby.tickStats.maxLateMs = lateMs;
+
+  // Pas fixe : le temps reel s'accumule et la simulation avance par ticks
+  // de 1/tickRate, avec au plus maxCatchUpTicks ticks par reveil
+  const auto tickDuration = TickPeriod();
+  const float fixedDelta = 1.0f / static_cast<float>(tickRate);
+  auto currentTime = std::chrono::steady_clock::now();
+  lobby.tickAccumulator += currentTime - lobby.lastTickTime;
+  lobby.lastTickTime = currentTime;
+
+  ReceivePlayerInputs(lobby);
+
+  int steps = 0;
+  while (lobby.tickAccumulator >= tickDuration && steps < maxCatchUpTicks &&
+         lobby.gameRuning) {
+    auto tickStart = std::chrono::steady_clock::now();
+    lobby.inputBuffers.setTick(lobby.currentTick + 1);
+    lobby.m_engine.Update(fixedDelta);
+    lobby.currentTick++;
+    lobby.tickAccumulator -= tickDuration;
+    steps++;
+    RecordTick(lobby, std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - tickStart)
+                          .count());
+  }
+
+  if (lobby.tickAccumulator >= tickDuration) {
+    lobby.tickStats.droppedTicks += lobby.tickAccumulator / tickDuration;
+    lobby.tickAccumulator %= tickDuration;
+  }
 
-    ReceivePlayerInputs(lobby);
-    lobby.m_engine.Update(deltaTime);
+  if (steps > 0) {
     SendWorldStateToClients(lobby);
     CheckGameEnded(lobby);
+  }
 
-    auto frameTime = std::chrono::steady_clock::now() - currentTime;
-    if (frameTime < frameDuration && lobby.gameRuning) {
-      std::this_thread::sleep_for(frameDuration - frameTime);
-    }
+  if (!lobby.gameRuning) {
+    std::cout << "[Scheduler] Game loop stopped for lobby " << lobby.lobby_id
+              << std::endl;
   }
-  std::cout << "[Thread] GameLoop stopped for lobby " << lobby.lobby_id
-            << std::endl;
+  return lobby.gameRuning;
 }
 
-void ServerGame::SendPacket() {
-  std::queue<std::tuple<Action, uint16_t, lobby_list*>> localQueue;
-  {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    localQueue.swap(actionQueue);
+void ServerGame::RecordTick(lobby_list& lobby, double tickMs) {
+  TickStats& stats = lobby.tickStats;
+  stats.ticks++;
+  stats.lastTickMs = tickMs;
+  stats.totalTickMs += tickMs;
+  if (tickMs > stats.maxTickMs) stats.maxTickMs = tickMs;
+  if (tickMs > 1000.0 / tickRate) stats.overruns++;
+
+  // Un resume toutes les 10 secondes de simulation
+  if (stats.ticks % (static_cast<uint64_t>(tickRate) * 10) == 0) {
+    std::cout << "[Tick] Lobby " << lobby.lobby_id << " tick "
+              << lobby.currentTick << ": avg "
+              << stats.totalTickMs / stats.ticks << " ms, max "
+              << stats.maxTickMs << " ms, late max " << stats.maxLateMs
+              << " ms, overruns " << stats.overruns << ", dropped "
+              << stats.droppedTicks;
+    QueueStats in = lobby.lobbyEventQueue.Stats();
+    std::cout << ", inputs high " << in.highWater << "/" << in.capacity
+              << " dropped " << in.dropped << std::endl;
+  }
+}
+
+void ServerGame::LogQueueStats() {
+  auto now = std::chrono::steady_clock::now();
+  if (now - lastQueueLog < std::chrono::seconds(10)) return;
+  lastQueueLog = now;
+
+  QueueStats ev = eventQueue.Stats();
+  QueueStats ac = actionQueue.Stats();
+  // Silencieux tant que les files restent peu remplies
+  if (ev.dropped == 0 && ac.dropped == 0 && ev.highWater < ev.capacity / 2 &&
+      ac.highWater < ac.capacity / 2) {
+    return;
   }
-  while (!localQueue.empty()) {
-    auto& [action, clientId, lobby] = localQueue.front();
+  std::cout << "[Queues] events high " << ev.highWater << "/" << ev.capacity
+            << " dropped " << ev.dropped << ", actions high " << ac.highWater
+            << "/" << ac.capacity << " dropped " << ac.dropped << std::endl;
+}
 
-    if (clientId == 0 && lobby != nullptr) {
+void ServerGame::SetTickRate(int hz, int maxCatchUp) {
+  if (hz <= 0) return;
+  tickRate = hz;
+  maxCatchUpTicks = maxCatchUp > 0 ? maxCatchUp : 1;
+}
+
+void ServerGame::SetSnapshotRate(int hz) {
+  if (hz <= 0) return;
+  snapshotRate = hz;
+}
+
+void ServerGame::ForgetClientSnapshots(uint16_t playerId, lobby_list& lobby) {
+  lobby.snapshotAcks.erase(playerId);
+  lobby.snapshotBudgets.erase(playerId);
+  lobby.sendRates.erase(playerId);
+}
+
+bool ServerGame::SnapshotDue(uint16_t playerId, lobby_list& lobby) {
+  const uint32_t now = lobby.currentTick;
+  auto [it, inserted] = lobby.sendRates.try_emplace(playerId);
+  ClientSendRate& rate = it->second;
+  if (inserted) {
+    int base = (tickRate + snapshotRate / 2) / snapshotRate;
+    rate.baseInterval = base > 1 ? base : 1;
+    rate.interval = rate.baseInterval;
+    rate.nextTick = now;
+    rate.nextCheck = now + tickRate;
+    rate.lastChange = now;
+  }
+
+  // Une verification par seconde : on ralentit des que le lien se degrade,
+  // on ne reaccelere qu'apres 3 s stables
+  if (static_cast<int32_t>(now - rate.nextCheck) >= 0) {
+    rate.nextCheck = now + tickRate;
+    ClientLinkStats link;
+    if (networkManager->GetClientLinkStats(playerId, link) &&
+        link.samples > 0) {
+      int previous = rate.interval;
+      bool degraded =
+          link.loss > DEGRADED_LOSS || link.rttMs > DEGRADED_RTT_MS;
+      bool healthy = link.loss < HEALTHY_LOSS && link.rttMs < HEALTHY_RTT_MS;
+      if (degraded &&
+          rate.interval < rate.baseInterval * ClientSendRate::MAX_FACTOR) {
+        rate.interval *= 2;
+      } else if (healthy && rate.interval > rate.baseInterval &&
+                 now - rate.lastChange >= static_cast<uint32_t>(tickRate) * 3) {
+        rate.interval /= 2;
+        if (rate.interval < rate.baseInterval)
+          rate.interval = rate.baseInterval;
+      }
+      if (rate.interval != previous) {
+        rate.lastChange = now;
+        std::cout << "[Snapshot] Client " << playerId << " every "
+                  << rate.interval << " ticks (loss " << link.loss * 100.0f
+                  << "%, rtt " << link.rttMs << " ms)" << std::endl;
+      }
+    }
+  }
+
+  if (static_cast<int32_t>(now - rate.nextTick) < 0) return false;
+  rate.nextTick = now + rate.interval;
+  return true;
+}
+
+void ServerGame::SendPacket() {
+  // Borne au contenu present a l'entree : les actions poussees pendant
+  // l'envoi partent au tour suivant
+  size_t pending = actionQueue.Size();
+  while (pending-- > 0) {
+    auto item = actionQueue.TryPop();
+    if (!item) break;
+    auto& [action, clientId, lobbyId] = *item;
+
+    if (clientId == 0 && lobbyId != 0) {
+      lobby_list* lobby = FindLobby(lobbyId);
+      if (!lobby) continue;
+      // Copie des listes sous le verrou du lobby, envoi hors verrou
+      std::vector<std::tuple<uint16_t, bool, std::string>> players;
+      std::vector<std::tuple<uint16_t, bool, std::string>> spectate;
+      {
+        std::lock_guard<std::mutex> lock(lobby->mutex);
+        players = lobby->players_list;
+        spectate = lobby->spectate;
+      }
       size_t protocol = UseUdp(action.type);
 
       if (protocol == 0 || protocol == 1) {
-        networkManager->BroadcastLobbyUDP(action, lobby->players_list);
-        networkManager->BroadcastLobbyUDP(action, lobby->spectate);
+        networkManager->BroadcastLobbyUDP(action, players);
+        networkManager->BroadcastLobbyUDP(action, spectate);
       } else {
-        networkManager->BroadcastLobbyTCP(action, lobby->players_list);
-        networkManager->BroadcastLobbyTCP(action, lobby->spectate);
+        networkManager->BroadcastLobbyTCP(action, players);
+        networkManager->BroadcastLobbyTCP(action, spectate);
       }
     } else {
       NetworkMessage msg;
       msg.client_id = clientId;
       networkManager->SendTo(msg, action);
     }
-    localQueue.pop();
   }
 }
 
@@ -825,25 +1050,26 @@ void ServerGame::ClearLobbyForRematch(lobby_list& lobby) {
   SceneData& data = lobby.m_engine.GetSceneData();
   data.Remove("game_ended");
   data.Remove("victory");
-  data.Remove("game_state");
-  data.Remove("force_state");
-  data.Remove("last_input_event");
-  data.Remove("last_input_player");
+  data.Remove(SceneKeys::GAME_STATE);
+  data.Remove(SceneKeys::FORCE_STATE);
+  lobby.inputBuffers.clear();
 
   for (auto& player : lobby.players_list) {
     std::get<1>(player) = false;
   }
-  for (auto& spectator : lobby.spectate) {
-    if (lobby.players_list.size() < lobby.max_players) {
-      std::get<1>(spectator) = false;
-      lobby.players_list.push_back(spectator);
-    }
+  // Les spectateurs sans place restent spectateurs, et donc indexes
+  auto spec = lobby.spectate.begin();
+  while (spec != lobby.spectate.end() &&
+         lobby.players_list.size() < lobby.max_players) {
+    std::get<1>(*spec) = false;
+    lobby.players_list.push_back(*spec);
+    spec = lobby.spectate.erase(spec);
   }
-  lobby.spectate.clear();
   lobby.players_ready = false;
   lobby.mapSent = false;
-  lobby.lastStates.clear();
-  lobby.playerStateCount.clear();
+  lobby.snapshotAcks.clear();
+  lobby.snapshotBudgets.clear();
+  lobby.snapshotHistory.Clear();
 
   SendLobbyUpdate(lobby);
 }
@@ -853,21 +1079,26 @@ void ServerGame::Run() {
 
   while (serverRunning) {
     networkManager->Update();
+    DispatchEvents();
     SendPacket();
-
-    {
-      std::lock_guard<std::mutex> lock(lobbyMutex);
-      for (auto it = lobbys.begin(); it != lobbys.end();) {
-        if (!(*it)->gameRuning && (*it)->gameThread.joinable()) {
-          (*it)->gameThread.join();
-          ClearLobbyForRematch(**it);
-          std::cout << "[Lobby] " << (*it)->lobby_id << " reset done."
-                    << std::endl;
-        }
-        ++it;
+    LogQueueStats();
+
+    for (lobby_list* lobby : LobbySnapshot()) {
+      if (!lobby->gameRuning && lobby->loopScheduled && lobby->loopFinished) {
+        std::lock_guard<std::mutex> lock(lobby->mutex);
+        lobby->loopScheduled = false;
+        ClearLobbyForRematch(*lobby);
+        std::cout << "[Lobby] " << lobby->lobby_id << " reset done."
+                  << std::endl;
       }
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+
+    // Reveil immediat sur paquet recu, action en file ou fin de partie ;
+    // sinon au plus MAX_IDLE_WAIT pour les retransmissions UDP
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeCv.wait_for(lock, MAX_IDLE_WAIT,
+                    [this] { return wakePending || !serverRunning; });
+    wakePending = false;
   }
   std::cout << "server " << std::endl;
   std::cout << "server " << std::endl;
@@ -875,62 +1106,28 @@ void ServerGame::Run() {
 
 void ServerGame::Shutdown() {
   serverRunning = false;
-  {
-    std::lock_guard<std::mutex> lock(lobbyMutex);
-    for (auto& lobby : lobbys) {
-      lobby->gameRuning = false;
-      if (lobby->gameThread.joinable()) {
-        lobby->gameThread.join();
-      }
-    }
+  Wake();
+  for (lobby_list* lobby : LobbySnapshot()) {
+    lobby->gameRuning = false;
   }
+  scheduler.Stop();
   networkManager->Shutdown();
 }
 
 std::optional<std::pair<Event, uint16_t>> ServerGame::PopEventLobby(
     lobby_list& lobby) {
-  std::lock_guard<std::mutex> lock(lobby.lobbyQueueMutex);
-
-  if (lobby.lobbyEventQueue.empty()) {
-    return std::nullopt;
-  }
-
-  auto res = lobby.lobbyEventQueue.front();
-  lobby.lobbyEventQueue.pop();
-  return res;
+  return lobby.lobbyEventQueue.TryPop();
 }
 
 void ServerGame::ReceivePlayerInputs(lobby_list& lobby) {
+  // Les entrees recues depuis le dernier reveil s'appliquent au prochain tick
+  const uint32_t applyTick = lobby.currentTick + 1;
   while (auto evOpt = PopEventLobby(lobby)) {
-    auto [event, playerId] = evOpt.value();
-
-    // switch (event.type) {
-    //   case EventType::PLAYER_INPUT: {
-    //     const PLAYER_INPUT& input = std::get<PLAYER_INPUT>(event.data);
-
-    //     auto& players = lobby.registry.get_components<PlayerEntity>();
-    //     auto& states = lobby.registry.get_components<InputState>();
-
-    //     for (auto&& [player, state] : Zipper(players, states)) {
-    //       if (player.player_id != playerId) continue;
-
-    //       state.moveLeft = input.left;
-    //       state.moveRight = input.right;
-    //       state.moveDown = input.down;
-    //       state.moveUp = input.up;
-    //       state.action1 = (input.fire == 1);
-    //       state.action2 = (input.fire == 2);
-    //       break;
-    //     }
-    //     break;
-    //   }
-
-    //   default:
-    //     break;
-    // }
-    SceneData& data = lobby.m_engine.GetSceneData();
-    data.Set("last_input_event", event);
-    data.Set("last_input_player", playerId);
+    auto& [event, playerId] = *evOpt;
+    if (event.type != EventType::PLAYER_INPUT) continue;
+
+    lobby.inputBuffers.push(playerId, std::get<PLAYER_INPUT>(event.data),
+                            event.seqNum, applyTick);
   }
 }
 
@@ -969,238 +1166,230 @@ void ServerGame::SendMapToClients(uint16_t playerId, lobby_list& lobby) {
   }
 }
 
-GameState ServerGame::CalculateDelta(const GameState& last,
-                                     const GameState& current) {
-  GameState diff;
-
-  for (const auto& currP : current.players) {
-    auto it = std::find_if(
-        last.players.begin(), last.players.end(),
-        [&](const PlayerState& p) { return p.playerId == currP.playerId; });
-
-    if (it == last.players.end()) {
-      diff.players.push_back(currP);
-    } else {
-      PlayerState deltaP;
-      deltaP.playerId = currP.playerId;
-      deltaP.mask = 0;
-
-      if (std::abs(currP.posX - it->posX) > 0.01f) {
-        deltaP.posX = currP.posX;
-        deltaP.mask |= M_POS_X;
-      }
-      if (std::abs(currP.posY - it->posY) > 0.01f) {
-        deltaP.posY = currP.posY;
-        deltaP.mask |= M_POS_Y;
-      }
-      if (currP.hp != it->hp) {
-        deltaP.hp = currP.hp;
-        deltaP.mask |= M_HP;
-      }
-      if (currP.shield != it->shield) {
-        deltaP.shield = currP.shield;
-        deltaP.mask |= M_SHIELD;
-      }
-      if (currP.weapon != it->weapon) {
-        deltaP.weapon = currP.weapon;
-        deltaP.mask |= M_WEAPON;
-      }
-      if (currP.state != it->state) {
-        deltaP.state = currP.state;
-        deltaP.mask |= M_STATE;
-      }
-      if (currP.sprite != it->sprite) {
-        deltaP.sprite = currP.sprite;
-        deltaP.mask |= M_SPRITE;
-      }
-      if (currP.score != it->score) {
-        deltaP.score = currP.score;
-        deltaP.mask |= M_SCORE;
-      }
-
-      if (deltaP.mask != 0) {
-        diff.players.push_back(deltaP);
-      }
+namespace {
+
+/**
+ * @brief Diff two id-keyed snapshot arrays in O(n + m)
+ *
+ * The baseline is indexed once; each current entity is either new (pushed
+ * whole), changed (pushed by diffFields) or unchanged. Baseline entities
+ * not matched by any current one are pushed as deletions.
+ */
+template <typename T, typename IdOf, typename DiffFields, typename Deleted>
+void DiffById(const std::vector<T>& last, const std::vector<T>& current,
+              IdOf idOf, DiffFields diffFields, Deleted deleted,
+              std::vector<T>& out) {
+  // Tables reutilisees par thread : pas d'allocation une fois chaudes
+  thread_local IdIndex index;
+  thread_local std::vector<uint8_t> seen;
+  index.Build(last, idOf);
+  seen.assign(last.size(), 0);
+
+  for (const T& curr : current) {
+    int32_t i = index.Find(idOf(curr));
+    if (i == IdIndex::NONE) {
+      out.push_back(curr);
+      continue;
     }
+    seen[i] = 1;
+    T delta;
+    if (diffFields(last[i], curr, delta)) out.push_back(delta);
   }
 
-  for (const auto& lastP : last.players) {
-    if (std::none_of(current.players.begin(), current.players.end(),
-                     [&](const PlayerState& p) {
-                       return p.playerId == lastP.playerId;
-                     })) {
-      PlayerState deleteP;
-      deleteP.playerId = lastP.playerId;
-      deleteP.mask = M_DELETE;
-      deleteP.state = 0;
-      diff.players.push_back(deleteP);
-    }
+  for (const T& prev : last) {
+    if (!seen[index.Find(idOf(prev))]) out.push_back(deleted(prev));
   }
+}
 
-  for (const auto& currE : current.enemies) {
-    auto it = std::find_if(
-        last.enemies.begin(), last.enemies.end(),
-        [&](const EnemyState& e) { return e.enemyId == currE.enemyId; });
-
-    if (it == last.enemies.end()) {
-      diff.enemies.push_back(currE);
-    } else {
-      EnemyState deltaE;
-      deltaE.enemyId = currE.enemyId;
-      deltaE.mask = 0;
-
-      if (std::abs(currE.posX - it->posX) > 0.01f) {
-        deltaE.posX = currE.posX;
-        deltaE.mask |= M_POS_X;
-      }
-      if (std::abs(currE.posY - it->posY) > 0.01f) {
-        deltaE.posY = currE.posY;
-        deltaE.mask |= M_POS_Y;
-      }
-      if (currE.hp != it->hp) {
-        deltaE.hp = currE.hp;
-        deltaE.mask |= M_HP;
-      }
-      if (currE.enemyType != it->enemyType) {
-        deltaE.enemyType = currE.enemyType;
-        deltaE.mask |= M_TYPE;
-      }
-      if (currE.state != it->state) {
-        deltaE.state = currE.state;
-        deltaE.mask |= M_STATE;
-      }
-      if (currE.direction != it->direction) {
-        deltaE.direction = currE.direction;
-        deltaE.mask |= M_DIR;
-      }
+}  // namespace
 
-      if (deltaE.mask != 0) {
-        diff.enemies.push_back(deltaE);
-      }
-    }
-  }
-
-  for (const auto& lastE : last.enemies) {
-    if (std::none_of(
-            current.enemies.begin(), current.enemies.end(),
-            [&](const EnemyState& e) { return e.enemyId == lastE.enemyId; })) {
-      EnemyState deleteE;
-      deleteE.enemyId = lastE.enemyId;
-      deleteE.mask = M_DELETE;
-      deleteE.hp = 0;
-      diff.enemies.push_back(deleteE);
-    }
-  }
+GameState ServerGame::CalculateDelta(const GameState& last,
+                                     const GameState& current) {
+  GameState diff;
 
-  for (const auto& currPr : current.projectiles) {
-    auto it = std::find_if(last.projectiles.begin(), last.projectiles.end(),
-                           [&](const ProjectileState& pr) {
-                             return pr.projectileId == currPr.projectileId;
-                           });
+  DiffById(
+      last.players, current.players,
+      [](const PlayerState& p) { return p.playerId; },
+      [](const PlayerState& prev, const PlayerState& currP,
+         PlayerState& deltaP) {
+        deltaP.playerId = currP.playerId;
+        deltaP.mask = 0;
+
+        if (std::abs(currP.posX - prev.posX) > 0.01f) {
+          deltaP.posX = currP.posX;
+          deltaP.mask |= M_POS_X;
+        }
+        if (std::abs(currP.posY - prev.posY) > 0.01f) {
+          deltaP.posY = currP.posY;
+          deltaP.mask |= M_POS_Y;
+        }
+        if (currP.hp != prev.hp) {
+          deltaP.hp = currP.hp;
+          deltaP.mask |= M_HP;
+        }
+        if (currP.shield != prev.shield) {
+          deltaP.shield = currP.shield;
+          deltaP.mask |= M_SHIELD;
+        }
+        if (currP.weapon != prev.weapon) {
+          deltaP.weapon = currP.weapon;
+          deltaP.mask |= M_WEAPON;
+        }
+        if (currP.state != prev.state) {
+          deltaP.state = currP.state;
+          deltaP.mask |= M_STATE;
+        }
+        if (currP.sprite != prev.sprite) {
+          deltaP.sprite = currP.sprite;
+          deltaP.mask |= M_SPRITE;
+        }
+        if (currP.score != prev.score) {
+          deltaP.score = currP.score;
+          deltaP.mask |= M_SCORE;
+        }
+        return deltaP.mask != 0;
+      },
+      [](const PlayerState& lastP) {
+        PlayerState deleteP;
+        deleteP.playerId = lastP.playerId;
+        deleteP.mask = M_DELETE;
+        deleteP.state = 0;
+        return deleteP;
+      },
+      diff.players);
+
+  DiffById(
+      last.enemies, current.enemies,
+      [](const EnemyState& e) { return e.enemyId; },
+      [](const EnemyState& prev, const EnemyState& currE,
+         EnemyState& deltaE) {
+        deltaE.enemyId = currE.enemyId;
+        deltaE.mask = 0;
+
+        if (std::abs(currE.posX - prev.posX) > 0.01f) {
+          deltaE.posX = currE.posX;
+          deltaE.mask |= M_POS_X;
+        }
+        if (std::abs(currE.posY - prev.posY) > 0.01f) {
+          deltaE.posY = currE.posY;
+          deltaE.mask |= M_POS_Y;
+        }
+        if (currE.hp != prev.hp) {
+          deltaE.hp = currE.hp;
+          deltaE.mask |= M_HP;
+        }
+        if (currE.enemyType != prev.enemyType) {
+          deltaE.enemyType = currE.enemyType;
+          deltaE.mask |= M_TYPE;
+        }
+        if (currE.state != prev.state) {
+          deltaE.state = currE.state;
+          deltaE.mask |= M_STATE;
+        }
+        if (currE.direction != prev.direction) {
+          deltaE.direction = currE.direction;
+          deltaE.mask |= M_DIR;
+        }
+        return deltaE.mask != 0;
+      },
+      [](const EnemyState& lastE) {
+        EnemyState deleteE;
+        deleteE.enemyId = lastE.enemyId;
+        deleteE.mask = M_DELETE;
+        deleteE.hp = 0;
+        return deleteE;
+      },
+      diff.enemies);
+
+  DiffById(
+      last.projectiles, current.projectiles,
+      [](const ProjectileState& pr) { return pr.projectileId; },
+      [](const ProjectileState& prev, const ProjectileState& currPr,
+         ProjectileState& deltaPr) {
+        deltaPr.projectileId = currPr.projectileId;
+        deltaPr.mask = 0;
+
+        if (std::abs(currPr.posX - prev.posX) > 0.01f) {
+          deltaPr.posX = currPr.posX;
+          deltaPr.mask |= M_POS_X;
+        }
+        if (std::abs(currPr.posY - prev.posY) > 0.01f) {
+          deltaPr.posY = currPr.posY;
+          deltaPr.mask |= M_POS_Y;
+        }
+        if (currPr.damage != prev.damage) {
+          deltaPr.damage = currPr.damage;
+          deltaPr.mask |= M_DAMAGE;
+        }
+        return deltaPr.mask != 0;
+      },
+      [](const ProjectileState& lastPr) {
+        ProjectileState deletePr;
+        deletePr.projectileId = lastPr.projectileId;
+        deletePr.mask = M_DELETE;
+        deletePr.damage = 0;
+        return deletePr;
+      },
+      diff.projectiles);
 
-    if (it == last.projectiles.end()) {
-      diff.projectiles.push_back(currPr);
-    } else {
-      ProjectileState deltaPr;
-      deltaPr.projectileId = currPr.projectileId;
-      deltaPr.mask = 0;
+  return diff;
+}
 
-      if (std::abs(currPr.posX - it->posX) > 0.01f) {
-        deltaPr.posX = currPr.posX;
-        deltaPr.mask |= M_POS_X;
-      }
-      if (std::abs(currPr.posY - it->posY) > 0.01f) {
-        deltaPr.posY = currPr.posY;
-        deltaPr.mask |= M_POS_Y;
-      }
-      if (currPr.damage != it->damage) {
-        deltaPr.damage = currPr.damage;
-        deltaPr.mask |= M_DAMAGE;
-      }
+std::shared_ptr<const GameState> ServerGame::BuildFullState(
+    const GameState& snapshot, uint32_t tick) {
+  auto full = std::make_shared<GameState>(snapshot);
+  full->tick = tick;
+  full->baseTick = tick;
 
-      if (deltaPr.mask != 0) {
-        diff.projectiles.push_back(deltaPr);
-      }
-    }
+  uint16_t fullMaskEnemy = M_POS_X | M_POS_Y | M_HP | M_STATE | M_TYPE | M_DIR;
+  for (auto& e : full->enemies) {
+    e.mask = fullMaskEnemy;
   }
 
-  for (const auto& lastPr : last.projectiles) {
-    if (std::none_of(current.projectiles.begin(), current.projectiles.end(),
-                     [&](const ProjectileState& pr) {
-                       return pr.projectileId == lastPr.projectileId;
-                     })) {
-      ProjectileState deletePr;
-      deletePr.projectileId = lastPr.projectileId;
-      deletePr.mask = M_DELETE;
-      deletePr.damage = 0;
-      diff.projectiles.push_back(deletePr);
-    }
+  uint16_t fullMaskProj = M_POS_X | M_POS_Y | M_DAMAGE | M_TYPE | M_OWNER;
+  for (auto& pr : full->projectiles) {
+    pr.mask = fullMaskProj;
   }
-
-  return diff;
+  return full;
 }
 
-void ServerGame::ProcessAndSendState(uint16_t playerId, lobby_list& lobby) {
-  auto& lastStatePtr = lobby.lastStates[playerId];
-  auto& stateCount = lobby.playerStateCount[playerId];
-  bool isFirstPacket = false;
-
-  if (stateCount < 3) {
-    isFirstPacket = true;
-    stateCount++;
+void ServerGame::ProcessAndSendState(SnapshotJob& job,
+                                     const GameState& snapshot) {
+  // Trop gros pour un datagramme : seules les entrees prioritaires partent,
+  // les autres restent dans le prochain delta calcule contre la vue
+  GameState kept;
+  GameState view;
+  if (job.budget->Fit(*job.state, job.baseline, snapshot, job.playerId, kept,
+                      view)) {
+    job.state = std::make_shared<const GameState>(std::move(kept));
+    job.view = std::make_shared<const GameState>(std::move(view));
   }
 
-  GameState deltaState;
-  SceneData& data = lobby.m_engine.GetSceneData();
-
-  if (data.Has("game_state")) {
-    deltaState = data.Get<GameState>("game_state");
-  } else {
+  const GameState& state = *job.state;
+  if (!job.full && !job.keepAlive && state.players.empty() &&
+      state.enemies.empty() && state.projectiles.empty()) {
     return;
   }
-  if (isFirstPacket) {
-    uint16_t fullMaskPlayer = M_POS_X | M_POS_Y | M_HP | M_STATE | M_SHIELD |
-                              M_WEAPON | M_SPRITE | M_SCORE;
 
-    uint16_t fullMaskEnemy =
-        M_POS_X | M_POS_Y | M_HP | M_STATE | M_TYPE | M_DIR;
-    for (auto& e : deltaState.enemies) {
-      e.mask = fullMaskEnemy;
-    }
-
-    uint16_t fullMaskProj = M_POS_X | M_POS_Y | M_DAMAGE | M_TYPE | M_OWNER;
-    for (auto& pr : deltaState.projectiles) {
-      pr.mask = fullMaskProj;
-    }
+  Action ac;
+  ac.type = ActionType::GAME_STATE;
+  ac.data = state;
 
+  if (networkManager->EncodeUDP(job.playerId, ac, job.datagram)) {
+    job.acks->RecordSent(job.datagram.seq, state.tick, job.view);
   } else {
-    if (!lastStatePtr) {
-      lastStatePtr = std::make_shared<GameState>();
-    }
-    deltaState =
-        CalculateDelta(*lastStatePtr, data.Get<GameState>("game_state"));
-    lobby.lastStates[playerId] =
-        std::make_shared<GameState>(data.Get<GameState>("game_state"));
-  }
-
-  if (isFirstPacket || !deltaState.players.empty() ||
-      !deltaState.enemies.empty() || !deltaState.projectiles.empty()) {
-    Action ac;
-    ac.type = ActionType::GAME_STATE;
-    ac.data = deltaState;
-
-    NetworkMessage msg;
-    msg.client_id = playerId;
-    networkManager->SendTo(msg, ac);
+    job.tcpFallback = std::move(ac);
   }
 }
 
 void ServerGame::SendWorldStateToClients(lobby_list& lobby) {
   SceneData& data = lobby.m_engine.GetSceneData();
 
-  if (data.Has("game_state")) {
-    GameState state = data.Get<GameState>("game_state");
-    for (const auto& player : state.players) {
+  // Un seul snapshot immuable par tick, lu par tous les envois
+  std::shared_ptr<const GameState> snapshot =
+      data.GetShared(SceneKeys::GAME_STATE);
+  if (snapshot) {
+    for (const auto& player : snapshot->players) {
       lobby.currentScores[player.playerId] = player.score;
     }
   }
@@ -1213,18 +1402,94 @@ void ServerGame::SendWorldStateToClients(lobby_list& lobby) {
         data.Remove("level_transition");
     }
 
-  if (data.Has("force_state")) {
-    ForceState fs = data.Get<ForceState>("force_state");
+  if (data.Has(SceneKeys::FORCE_STATE)) {
+    const ForceState& fs = data.GetRef(SceneKeys::FORCE_STATE);
     SendAction(std::make_tuple(Action{ActionType::FORCE_STATE, fs}, 0, &lobby));
   }
 
-  for (auto& [playerId, ready, name] : lobby.players_list) {
-    if (playerId == 0) continue;
-    ProcessAndSendState(playerId, lobby);
-  }
+  if (!snapshot) return;
+
+  const uint32_t tick = lobby.currentTick;
+  lobby.snapshotHistory.Push(tick, snapshot);
+
+  // Preparation sequentielle : les entrees des maps sont creees ici et les
+  // clients sont groupes par reference acquittee
+  auto& jobs = lobby.snapshotJobs;
+  auto& deltas = lobby.snapshotDeltas;
+  jobs.clear();
+  deltas.clear();
+  std::unordered_map<const GameState*, size_t> deltaOf;
+  std::shared_ptr<const GameState> fullState;
+
+  auto addJob = [&](uint16_t playerId) {
+    if (playerId == 0 || !SnapshotDue(playerId, lobby)) return;
+    SnapshotAcks& acks = lobby.snapshotAcks[playerId];
+    uint16_t ack;
+    uint32_t ackBits;
+    if (networkManager->GetClientAcks(playerId, ack, ackBits)) {
+      acks.Acknowledge(ack, ackBits);
+    }
+
+    SnapshotJob& job = jobs.emplace_back();
+    job.playerId = playerId;
+    job.acks = &acks;
+    job.budget = &lobby.snapshotBudgets[playerId];
+
+    // Rien d'acquitte, ou reference sortie de l'historique : etat complet
+    std::shared_ptr<const GameState> baseline =
+        acks.Baseline(lobby.snapshotHistory);
+    if (!baseline) {
+      if (!fullState) fullState = BuildFullState(*snapshot, tick);
+      job.full = true;
+      job.state = fullState;
+      return;
+    }
+
+    // Un delta vide part quand meme si la reference vieillit, pour que le
+    // client en acquitte une plus recente avant qu'elle ne sorte
+    job.keepAlive =
+        tick - acks.BaselineTick() >= SnapshotHistory::CAPACITY / 2;
+    auto [it, inserted] = deltaOf.try_emplace(baseline.get(), deltas.size());
+    if (inserted) {
+      deltas.push_back(SnapshotDelta{baseline, acks.BaselineTick(), nullptr});
+    }
+    job.delta = it->second;
+  };
+  for (auto& [playerId, ready, name] : lobby.players_list) addJob(playerId);
+  for (auto& [playerId, ready, name] : lobby.spectate) addJob(playerId);
+
+  // Un delta par reference distincte, partage par tous ses clients
+  snapshotPool.ParallelFor(deltas.size(), [&](size_t i) {
+    SnapshotDelta& delta = deltas[i];
+    auto state = std::make_shared<GameState>(
+        CalculateDelta(*delta.baseline, *snapshot));
+    state->tick = tick;
+    state->baseTick = delta.baseTick;
+    delta.state = std::move(state);
+  });
 
-  for (auto& [playerId, ready, name] : lobby.spectate) {
-    if (playerId == 0) continue;
-    ProcessAndSendState(playerId, lobby);
+  snapshotPool.ParallelFor(jobs.size(), [&](size_t i) {
+    SnapshotJob& job = jobs[i];
+    if (!job.state) {
+      job.state = deltas[job.delta].state;
+      job.baseline = deltas[job.delta].baseline.get();
+    }
+    ProcessAndSendState(job, *snapshot);
+  });
+
+  // Les datagrammes partent vers le thread IO en un seul lot
+  std::vector<OutgoingDatagram> batch;
+  batch.reserve(jobs.size());
+  for (auto& job : jobs) {
+    if (job.datagram.data) {
+      batch.push_back(std::move(job.datagram));
+    } else if (job.tcpFallback) {
+      // Le TCP est fiable : l'etat envoye devient la reference
+      job.acks->RecordDelivered(job.state->tick, std::move(job.view));
+      NetworkMessage msg;
+      msg.client_id = job.playerId;
+      networkManager->SendTo(msg, std::move(*job.tcpFallback));
+    }
   }
+  networkManager->SendBatchUDP(std::move(batch));
 }
@@ -0,0 +1,250 @@
+#include "SnapshotBudget.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "IdIndex.hpp"
+#include "network/DataMask.hpp"
+
+namespace {
+
+enum Kind : uint32_t { PLAYER = 0, ENEMY = 1, PROJECTILE = 2 };
+
+// En-tete UDP, puis tick, reference et compteurs : 11 octets en
+// GAME_STATE, au plus 15 en GAME_STATE_PACKED (varints)
+constexpr size_t HEADER_BYTES = 14 + 15;
+
+// Type d'ennemi a partir duquel l'entite est un boss ou une partie de boss
+constexpr uint8_t BOSS_TYPE = 90;
+
+/**
+ * @brief Plus grande taille d'une entree entre les deux formats : id et
+ * masque sur 4 octets en GAME_STATE, jusqu'a 2 bits et deux varints de
+ * 3 octets en GAME_STATE_PACKED
+ */
+size_t EntryBytes(Kind kind, uint16_t mask) {
+  size_t bytes = 4;
+  size_t bits = 2 + 24 + 24;
+  auto field = [&](uint16_t flag, size_t fieldBytes, size_t fieldBits) {
+    if (mask & flag) {
+      bytes += fieldBytes;
+      bits += fieldBits;
+    }
+  };
+  field(M_POS_X, 4, 13);
+  field(M_POS_Y, 4, 12);
+  field(M_HP, 1, 8);
+  field(M_STATE, 1, 8);
+  if (kind == PLAYER) {
+    field(M_SHIELD, 1, 8);
+    field(M_WEAPON, 1, 8);
+    field(M_SPRITE, 1, 8);
+    field(M_SCORE, 4, 40);
+  } else if (kind == ENEMY) {
+    field(M_TYPE, 1, 8);
+    field(M_DIR, 1, 2);
+  } else {
+    field(M_VELOCITY, 0, 24);
+    field(M_TYPE, 1, 8);
+    field(M_OWNER, 2, 24);
+    field(M_DAMAGE, 1, 8);
+  }
+  return std::max(bytes, (bits + 7) / 8);
+}
+
+uint32_t Key(Kind kind, uint16_t id) { return (kind << 16) | id; }
+
+/**
+ * @brief Remettre dans la vue l'etat de reference des entrees omises
+ *
+ * Une entite nouvelle disparait de la vue, une entite modifiee reprend sa
+ * valeur de reference et une entite supprimee y reste.
+ */
+template <typename T, typename IdOf>
+void RevertOmitted(std::vector<T>& view, const std::vector<T>& base,
+                   const std::vector<T>& entries,
+                   const std::vector<bool>& taken, IdOf idOf) {
+  IdIndex viewIndex;
+  IdIndex baseIndex;
+  viewIndex.Build(view, idOf);
+  baseIndex.Build(base, idOf);
+
+  const size_t count = view.size();
+  std::vector<bool> removed(count, false);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (taken[i]) continue;
+    uint16_t id = idOf(entries[i]);
+    int32_t v = viewIndex.Find(id);
+    int32_t b = baseIndex.Find(id);
+    if (entries[i].mask & M_DELETE) {
+      if (b != IdIndex::NONE) view.push_back(base[b]);
+    } else if (v != IdIndex::NONE) {
+      if (b == IdIndex::NONE) {
+        removed[v] = true;
+      } else {
+        view[v] = base[b];
+      }
+    }
+  }
+
+  size_t out = 0;
+  for (size_t i = 0; i < view.size(); ++i) {
+    if (i < count && removed[i]) continue;
+    if (out != i) view[out] = view[i];
+    out++;
+  }
+  view.resize(out);
+}
+
+template <typename T>
+std::vector<T> KeepTaken(const std::vector<T>& entries,
+                         const std::vector<bool>& taken) {
+  std::vector<T> kept;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (taken[i]) kept.push_back(entries[i]);
+  }
+  return kept;
+}
+
+}  // namespace
+
+size_t SnapshotBudget::EncodedSize(const GameState& state) {
+  size_t total = HEADER_BYTES;
+  for (const auto& p : state.players) total += EntryBytes(PLAYER, p.mask);
+  for (const auto& e : state.enemies) total += EntryBytes(ENEMY, e.mask);
+  for (const auto& pr : state.projectiles) {
+    total += EntryBytes(PROJECTILE, pr.mask);
+  }
+  return total;
+}
+
+bool SnapshotBudget::Fit(const GameState& state, const GameState* baseline,
+                         const GameState& snapshot, uint16_t playerId,
+                         GameState& kept, GameState& view) {
+  if (state.players.size() <= MAX_ENTRIES &&
+      state.enemies.size() <= MAX_ENTRIES &&
+      state.projectiles.size() <= MAX_ENTRIES &&
+      EncodedSize(state) <= PACKET_BYTES) {
+    if (!accumulators_.empty()) accumulators_.clear();
+    return false;
+  }
+
+  static const GameState empty;
+  const GameState& base = baseline ? *baseline : empty;
+
+  // Position du vaisseau du client, pour classer les ennemis proches
+  bool hasShip = false;
+  float shipX = 0.0f;
+  float shipY = 0.0f;
+  for (const auto& p : snapshot.players) {
+    if (p.playerId == playerId) {
+      hasShip = true;
+      shipX = p.posX;
+      shipY = p.posY;
+      break;
+    }
+  }
+
+  struct Candidate {
+    float priority;  ///< Base priority plus the accumulated one
+    Kind kind;
+    uint32_t index;
+    uint16_t id;
+    size_t bytes;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(state.players.size() + state.enemies.size() +
+                     state.projectiles.size());
+  auto add = [&](Kind kind, uint32_t index, uint16_t id, uint16_t mask,
+                 float priority) {
+    auto it = accumulators_.find(Key(kind, id));
+    float accumulated = it != accumulators_.end() ? it->second : 0.0f;
+    candidates.push_back(Candidate{priority + accumulated, kind, index, id,
+                                   EntryBytes(kind, mask)});
+  };
+
+  for (uint32_t i = 0; i < state.players.size(); ++i) {
+    const auto& p = state.players[i];
+    add(PLAYER, i, p.playerId, p.mask, PRIORITY_PLAYER);
+  }
+
+  // Type et position d'un ennemi du delta : snapshot, sinon reference
+  IdIndex snapshotEnemies;
+  IdIndex baseEnemies;
+  auto enemyId = [](const EnemyState& e) { return e.enemyId; };
+  snapshotEnemies.Build(snapshot.enemies, enemyId);
+  baseEnemies.Build(base.enemies, enemyId);
+  for (uint32_t i = 0; i < state.enemies.size(); ++i) {
+    const auto& e = state.enemies[i];
+    const EnemyState* ref = nullptr;
+    if (int32_t s = snapshotEnemies.Find(e.enemyId); s != IdIndex::NONE) {
+      ref = &snapshot.enemies[s];
+    } else if (int32_t b = baseEnemies.Find(e.enemyId); b != IdIndex::NONE) {
+      ref = &base.enemies[b];
+    }
+
+    float priority = PRIORITY_ENEMY_FAR;
+    if (ref && ref->enemyType >= BOSS_TYPE) {
+      priority = PRIORITY_BOSS;
+    } else if (ref) {
+      float nearness = 0.5f;
+      if (hasShip) {
+        float distance = std::hypot(ref->posX - shipX, ref->posY - shipY);
+        nearness = std::max(0.0f, 1.0f - distance / NEAR_RANGE);
+      }
+      priority += (PRIORITY_ENEMY_NEAR - PRIORITY_ENEMY_FAR) * nearness;
+    }
+    add(ENEMY, i, e.enemyId, e.mask, priority);
+  }
+
+  for (uint32_t i = 0; i < state.projectiles.size(); ++i) {
+    const auto& pr = state.projectiles[i];
+    add(PROJECTILE, i, pr.projectileId, pr.mask, PRIORITY_PROJECTILE);
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              if (a.priority != b.priority) return a.priority > b.priority;
+              if (a.kind != b.kind) return a.kind < b.kind;
+              return a.index < b.index;
+            });
+
+  // Les plus prioritaires d'abord ; une entree trop grosse laisse sa place
+  // aux suivantes, et les omises accumulent leur priorite
+  std::vector<bool> taken[3] = {
+      std::vector<bool>(state.players.size(), false),
+      std::vector<bool>(state.enemies.size(), false),
+      std::vector<bool>(state.projectiles.size(), false)};
+  size_t counts[3] = {0, 0, 0};
+  size_t room = PACKET_BYTES - HEADER_BYTES;
+  std::unordered_map<uint32_t, float> accumulators;
+  for (const Candidate& c : candidates) {
+    if (c.bytes <= room && counts[c.kind] < MAX_ENTRIES) {
+      room -= c.bytes;
+      counts[c.kind]++;
+      taken[c.kind][c.index] = true;
+    } else {
+      accumulators[Key(c.kind, c.id)] = c.priority;
+    }
+  }
+  accumulators_.swap(accumulators);
+
+  kept.tick = state.tick;
+  kept.baseTick = state.baseTick;
+  kept.players = KeepTaken(state.players, taken[PLAYER]);
+  kept.enemies = KeepTaken(state.enemies, taken[ENEMY]);
+  kept.projectiles = KeepTaken(state.projectiles, taken[PROJECTILE]);
+
+  view = snapshot;
+  view.tick = state.tick;
+  view.baseTick = state.tick;
+  RevertOmitted(view.players, base.players, state.players, taken[PLAYER],
+                [](const PlayerState& p) { return p.playerId; });
+  RevertOmitted(view.enemies, base.enemies, state.enemies, taken[ENEMY],
+                enemyId);
+  RevertOmitted(view.projectiles, base.projectiles, state.projectiles,
+                taken[PROJECTILE],
+                [](const ProjectileState& pr) { return pr.projectileId; });
+  return true;
+}
@@ -9,6 +9,8 @@ int main(int ac, char **av) {
   if (ac >= 2) diff = atoi(av[1]);
   if (diff == 0) diff = 1;
   if (ac >= 3) host = av[2];
+  if (ac >= 4) server.SetTickRate(atoi(av[3]));
+  if (ac >= 5) server.SetSnapshotRate(atoi(av[4]));
   if (!server.Initialize(4242, 4243, diff, host)) {
     return 1;
   }
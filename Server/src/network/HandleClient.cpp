@@ -1,5 +1,6 @@
 #include "network/HandleClient.hpp"
 
+#include <bitset>
 #include <string>
 
 HandleClient::HandleClient(uint16_t id,
@@ -24,22 +25,87 @@ bool HandleClient::IsTimedOut(std::chrono::seconds timeout) const {
 }
 
 void HandleClient::UpdateLocalSequence(uint16_t new_seq) {
-  if (new_seq == last_received_seq_from_client_) return;
+  // Seul le thread IO ecrit : lecture, calcul, puis une seule ecriture du
+  // couple seq / bits
+  uint64_t packed = local_ack_.load(std::memory_order_relaxed);
+  uint16_t last = static_cast<uint16_t>(packed);
+  uint32_t bits = static_cast<uint32_t>(packed >> 16);
+  if (new_seq == last) return;
 
-  uint16_t diff = new_seq - last_received_seq_from_client_;
+  uint16_t diff = new_seq - last;
 
   if (diff < 32768) {
     if (diff < 32) {
-      local_ack_bits_for_client_ <<= diff;
-      local_ack_bits_for_client_ |= (1 << (diff - 1));
+      bits <<= diff;
+      bits |= (1U << (diff - 1));
     } else {
-      local_ack_bits_for_client_ = 0;
+      bits = 0;
     }
-    last_received_seq_from_client_ = new_seq;
+    last = new_seq;
   } else {
-    uint16_t late_diff = last_received_seq_from_client_ - new_seq;
+    uint16_t late_diff = last - new_seq;
     if (late_diff <= 32) {
-      local_ack_bits_for_client_ |= (1U << (late_diff - 1));
+      bits |= (1U << (late_diff - 1));
     }
   }
+  local_ack_.store((static_cast<uint64_t>(bits) << 16) | last,
+                   std::memory_order_release);
+}
+
+void HandleClient::GetLocalAck(uint16_t& ack, uint32_t& ack_bits) const {
+  uint64_t packed = local_ack_.load(std::memory_order_acquire);
+  ack = static_cast<uint16_t>(packed);
+  ack_bits = static_cast<uint32_t>(packed >> 16);
+}
+
+void HandleClient::RecordSent(uint16_t seq) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  sent_seqs_[seq % SENT_WINDOW] = seq;
+  sent_times_[seq % SENT_WINDOW] = std::chrono::steady_clock::now();
+}
+
+void HandleClient::UpdateRemoteAck(uint16_t ack, uint32_t ack_bits) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  last_received_remote_ack_ = ack;
+  remote_ack_bits_ = ack_bits;
+
+  // Seul un ack plus recent apporte une nouvelle mesure
+  if (link_.samples > 0 && static_cast<int16_t>(ack - highest_acked_) <= 0)
+    return;
+  highest_acked_ = ack;
+
+  const float alpha = 0.125f;
+  if (sent_seqs_[ack % SENT_WINDOW] == ack &&
+      sent_times_[ack % SENT_WINDOW].time_since_epoch().count() != 0) {
+    float sample = std::chrono::duration<float, std::milli>(
+                       std::chrono::steady_clock::now() -
+                       sent_times_[ack % SENT_WINDOW])
+                       .count();
+    link_.rttMs = link_.samples == 0
+                      ? sample
+                      : link_.rttMs + alpha * (sample - link_.rttMs);
+  }
+
+  // Les 32 datagrammes precedant l'ack : bit absent = perdu
+  size_t window = ack > 32 ? 32 : (ack > 1 ? ack - 1 : 0);
+  if (window > 0) {
+    uint32_t mask = window == 32 ? 0xFFFFFFFFu : ((1u << window) - 1);
+    size_t received = std::bitset<32>(ack_bits & mask).count();
+    float sample = 1.0f - static_cast<float>(received) / window;
+    link_.loss = link_.samples == 0
+                     ? sample
+                     : link_.loss + alpha * (sample - link_.loss);
+  }
+  link_.samples++;
+}
+
+HandleClient::LinkStats HandleClient::GetLinkStats() const {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  return link_;
+}
+
+void HandleClient::GetRemoteAck(uint16_t& ack, uint32_t& ack_bits) const {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  ack = last_received_remote_ack_;
+  ack_bits = remote_ack_bits_;
 }
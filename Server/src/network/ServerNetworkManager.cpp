@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <utility>
@@ -10,6 +11,7 @@
 #include "db/Database.hpp"
 #include "network/DecodeFunc.hpp"
 #include "network/EncodeFunc.hpp"
+#include "network/Fragment.hpp"
 
 ServerNetworkManager::ServerNetworkManager() {
   SetupEncoder(encode);
@@ -66,7 +68,7 @@ bool ServerNetworkManager::Initialize(uint16_t tcp_port, uint16_t udp_port,
     udp_server_ = std::make_unique<UDPServer>(io_context_, udp_port, host);
 
     udp_server_->SetReceiveCallback(
-        [this](const auto &data, const auto &endpoint) {
+        [this](ByteView data, const asio::ip::udp::endpoint &endpoint) {
           OnReceive(data, endpoint);
         });
 
@@ -113,11 +115,15 @@ void ServerNetworkManager::IOThreadFunc() {
   std::cout << "[ServerNetworkManager] IO thread stopped" << std::endl;
 }
 
-void ServerNetworkManager::OnReceive(const std::vector<uint8_t> &data,
+void ServerNetworkManager::OnReceive(ByteView data,
                                      const asio::ip::udp::endpoint &sender) {
   if (data.size() < 6) return;
 
   auto client = client_manager_.GetUDPClientByEndpoint(sender);
+  if (fragment::isFragment(data)) {
+    OnReceiveFragment(client, data);
+    return;
+  }
   Event evt = decode.decode(data);
 
   if (!client) {
@@ -138,26 +144,90 @@ void ServerNetworkManager::OnReceive(const std::vector<uint8_t> &data,
   }
   client->UpdateLocalSequence(evt.seqNum);
   client->UpdateRemoteAck(evt.ack, evt.ack_bits);
+  AcknowledgeHistory(*client, evt.ack, evt.ack_bits);
 
-  {
-    std::lock_guard<std::mutex> lock(client->history_mutex);
-    client->history.erase(evt.ack);
-    for (int i = 0; i < 32; ++i) {
-      if (evt.ack_bits & (1 << i)) {
-        client->history.erase(static_cast<uint16_t>(evt.ack - (i + 1)));
-      }
-    }
-  }
+  client->UpdateLastSeen();
+  client->IncrementPacketsReceived();
+
+  // Decode une seule fois ici ; le jeu recoit l'evenement deplace
+  PushMessage(client->GetId(), std::move(evt));
+}
+
+void ServerNetworkManager::OnReceiveFragment(
+    const ClientManager::ClientPtr &client, ByteView data) {
+  fragment::Header header;
+  if (!client || !fragment::parse(data, header)) return;
+
+  // Un fragment en retard est garde : c'est le renvoi d'un morceau manquant
+  bool newest =
+      static_cast<int16_t>(header.seq - client->GetLastReceivedSeq()) > 0;
+  client->UpdateLocalSequence(header.seq);
+  if (newest) client->UpdateRemoteAck(header.ack, header.ackBits);
+  AcknowledgeHistory(*client, header.ack, header.ackBits);
 
   client->UpdateLastSeen();
   client->IncrementPacketsReceived();
 
+  auto now = std::chrono::steady_clock::now();
+  client->fragments.expire(now);
+  std::optional<std::vector<uint8_t>> whole = client->fragments.add(data, now);
+  if (!whole) return;
+
+  PushMessage(client->GetId(), decode.decode(*whole));
+}
+
+void ServerNetworkManager::PushMessage(uint16_t client_id, Event evt) {
   NetworkMessage msg;
-  msg.client_id = client->GetId();
-  msg.data = data;
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    incoming_messages_.push(std::move(msg));
+  msg.client_id = client_id;
+  msg.event = std::move(evt);
+  incoming_messages_.TryPush(std::move(msg));
+  NotifyWakeup();
+}
+
+void ServerNetworkManager::AcknowledgeHistory(HandleClient &client,
+                                              uint16_t ack,
+                                              uint32_t ack_bits) {
+  std::lock_guard<std::mutex> lock(client.history_mutex);
+  client.history.erase(ack);
+  for (int i = 0; i < 32; ++i) {
+    if (ack_bits & (1 << i)) {
+      client.history.erase(static_cast<uint16_t>(ack - (i + 1)));
+    }
+  }
+}
+
+void ServerNetworkManager::SendUDPPacket(HandleClient &client,
+                                         PacketPool::Buffer packet,
+                                         bool reliable) {
+  size_t count = fragment::countFor(*packet);
+  if (count == 0) {
+    std::cerr << "[Network] UDP packet of " << packet->size()
+              << " bytes too big to be fragmented, dropped" << std::endl;
+    return;
+  }
+
+  // Chaque fragment a son numero de sequence, le premier reprend celui du
+  // paquet ; les fragments fiables sont acquittes et renvoyes un par un
+  uint16_t seq = fragment::readU16(&(*packet)[6]);
+  uint16_t messageId = count > 1 ? client.GetNextMessageId() : 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) seq = client.GetNextOutSeq();
+    PacketPool::Buffer datagram;
+    if (count == 1) {
+      datagram = std::move(packet);
+    } else {
+      datagram = packet_pool_.acquire();
+      fragment::make(*packet, messageId, static_cast<uint8_t>(i),
+                     static_cast<uint8_t>(count), seq, *datagram);
+    }
+    if (reliable) {
+      std::lock_guard<std::mutex> lock(client.history_mutex);
+      client.history[seq] = {seq, *datagram,
+                             std::chrono::steady_clock::now(), 1};
+    }
+    udp_server_->SendTo(std::move(datagram), client.GetUDPEndpoint());
+    client.RecordSent(seq);
+    client.IncrementPacketsSent();
   }
 }
 
@@ -168,28 +238,26 @@ void ServerNetworkManager::OnReceiveTCP(uint32_t client_id,
 
   client->UpdateLastSeen();
 
-  NetworkMessage msg;
-  msg.client_id = static_cast<uint16_t>(client_id);
-  msg.data = data;
-
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    incoming_messages_.push(std::move(msg));
-  }
+  PushMessage(static_cast<uint16_t>(client_id), decode.decode(data));
 }
 
 void ServerNetworkManager::Update() {
-  std::queue<NetworkMessage> messages;
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    messages.swap(incoming_messages_);
-  }
-
-  while (!messages.empty()) {
+  size_t pending = incoming_messages_.Size();
+  while (pending-- > 0) {
+    auto msg = incoming_messages_.TryPop();
+    if (!msg) break;
     if (message_callback_) {
-      message_callback_(messages.front());
+      message_callback_(std::move(*msg));
     }
-    messages.pop();
+  }
+
+  QueueStats stats = incoming_messages_.Stats();
+  if (stats.dropped != reported_drops_) {
+    std::cerr << "[Network] Incoming queue full (high " << stats.highWater
+              << "/" << stats.capacity << "), "
+              << stats.dropped - reported_drops_ << " messages dropped"
+              << std::endl;
+    reported_drops_ = stats.dropped;
   }
 
   std::queue<ConnectionEvent> events;
@@ -228,7 +296,9 @@ void ServerNetworkManager::Update() {
       if (now - packet.last_sent > std::chrono::milliseconds(100)) {
         std::cout << "[RETRY] Resending critical packet seq: " << it->first
                   << std::endl;
-        udp_server_->SendTo(packet.data, client->GetUDPEndpoint());
+        PacketPool::Buffer copy = packet_pool_.acquire();
+        copy->assign(packet.data.begin(), packet.data.end());
+        udp_server_->SendTo(std::move(copy), client->GetUDPEndpoint());
         packet.last_sent = now;
         packet.retry_count++;
       }
@@ -243,69 +313,158 @@ void ServerNetworkManager::SendTo(const NetworkMessage &msg, Action ac) {
 
   size_t protocol = UseUdp(ac.type);
 
+  PacketPool::Buffer finalPacket = packet_pool_.acquire();
   if ((protocol == 0 || protocol == 1) && client->HasUDPEndpoint()) {
     uint16_t seq = client->GetNextOutSeq();
-    uint16_t ack = client->GetLastReceivedSeq();
-    uint32_t bits = client->GetLocalAckBits();
-
-    std::vector<uint8_t> finalPacket =
-        encode.encode(ac, protocol, seq, ack, bits);
-    if (protocol == 1) {
-      std::lock_guard<std::mutex> lock(client->history_mutex);
-      client->history[seq] = {seq, finalPacket,
-                              std::chrono::steady_clock::now(), 1};
-    }
-    udp_server_->SendTo(finalPacket, client->GetUDPEndpoint());
-    client->IncrementPacketsSent();
+    uint16_t ack;
+    uint32_t bits;
+    client->GetLocalAck(ack, bits);
+
+    encode.encodeInto(ac, ac.type, protocol, seq, ack, bits, *finalPacket);
+    SendUDPPacket(*client, std::move(finalPacket), protocol == 1);
   } else if (tcp_server_) {
-    std::vector<uint8_t> finalPacket = encode.encode(ac, 2, 0, 0, 0);
-    tcp_server_->SendTo(finalPacket, client->GetId());
+    encode.encodeInto(ac, ac.type, 2, 0, 0, 0, *finalPacket);
+    tcp_server_->SendTo(std::move(finalPacket), client->GetId());
     client->IncrementPacketsSent();
   }
 }
 
 void ServerNetworkManager::BroadcastLobbyUDP(
     Action ac, std::vector<std::tuple<uint16_t, bool, std::string>> &ids) {
+  if (!udp_server_) return;
   size_t protocol = UseUdp(ac.type);
 
-  for (auto &id : ids) {
-    uint16_t clientId = std::get<0>(id);
-    auto client = client_manager_.GetClient(clientId);
-
-    if (client && udp_server_ && client->HasUDPEndpoint()) {
-      uint16_t seq = client->GetNextOutSeq();
-      uint16_t ack = client->GetLastReceivedSeq();
-      uint32_t bits = client->GetLocalAckBits();
+  // La charge utile est encodee une fois ; chaque client n'a que son en-tete,
+  // ecrit d'avance pour que le tableau ne bouge plus pendant les envois
+  auto packet = std::make_shared<UdpBroadcast>();
+  if (!encode.encodePayload(ac, ac.type, packet->payload)) return;
+  const uint32_t length = static_cast<uint32_t>(packet->payload.size());
 
-      std::vector<uint8_t> finalPacket =
-          encode.encode(ac, protocol, seq, ack, bits);
-
-      if (protocol == 1) {
-        std::lock_guard<std::mutex> lock(client->history_mutex);
-        client->history[seq] = {seq, finalPacket,
-                                std::chrono::steady_clock::now(), 1};
-      }
+  std::vector<ClientManager::ClientPtr> targets;
+  targets.reserve(ids.size());
+  packet->headers.reserve(ids.size());
+  for (auto &id : ids) {
+    auto client = client_manager_.GetClient(std::get<0>(id));
+    if (!client || !client->HasUDPEndpoint()) continue;
+
+    uint16_t ack;
+    uint32_t bits;
+    client->GetLocalAck(ack, bits);
+    Encoder::Header &header = packet->headers.emplace_back();
+    Encoder::writeHeader(header, ac.type, protocol, length,
+                         client->GetNextOutSeq(), ack, bits);
+    targets.push_back(std::move(client));
+  }
 
-      udp_server_->SendTo(finalPacket, client->GetUDPEndpoint());
-      client->IncrementPacketsSent();
+  // Paquet fiable (garde pour le renvoi) ou trop gros : paquet complet
+  bool whole = protocol == 1 ||
+               Encoder::UDP_HEADER_SIZE + length > fragment::MAX_DATAGRAM;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    HandleClient &client = *targets[i];
+    const Encoder::Header &header = packet->headers[i];
+    if (whole) {
+      PacketPool::Buffer finalPacket = packet_pool_.acquire();
+      finalPacket->assign(header.begin(), header.end());
+      finalPacket->insert(finalPacket->end(), packet->payload.begin(),
+                          packet->payload.end());
+      SendUDPPacket(client, std::move(finalPacket), protocol == 1);
+      continue;
     }
+
+    udp_server_->SendTo(packet,
+                        {asio::buffer(header), asio::buffer(packet->payload)},
+                        client.GetUDPEndpoint());
+    client.RecordSent(fragment::readU16(&header[6]));
+    client.IncrementPacketsSent();
   }
 }
 
 void ServerNetworkManager::BroadcastLobbyTCP(
     Action ac, std::vector<std::tuple<uint16_t, bool, std::string>> &ids) {
+  if (!tcp_server_) return;
+
+  // L'en-tete TCP ne depend pas du client : un seul paquet pour tous
+  auto packet = std::make_shared<const std::vector<uint8_t>>(
+      encode.encode(ac, 2, 0, 0, 0));
   for (auto &id : ids) {
     uint16_t clientId = std::get<0>(id);
     auto client = client_manager_.GetClient(clientId);
 
-    if (client && tcp_server_) {
-      std::vector<uint8_t> finalPacket = encode.encode(ac, 2, 0, 0, 0);
-      tcp_server_->SendTo(finalPacket, client->GetId());
+    if (client) {
+      tcp_server_->SendTo(packet, client->GetId());
       client->IncrementPacketsSent();
     }
   }
 }
 
+bool ServerNetworkManager::GetClientLinkStats(uint16_t client_id,
+                                              ClientLinkStats &out) {
+  auto client = client_manager_.GetClient(client_id);
+  if (!client) return false;
+
+  HandleClient::LinkStats link = client->GetLinkStats();
+  out.rttMs = link.rttMs;
+  out.loss = link.loss;
+  out.samples = link.samples;
+  return true;
+}
+
+bool ServerNetworkManager::GetClientAcks(uint16_t client_id, uint16_t &ack,
+                                         uint32_t &ack_bits) {
+  auto client = client_manager_.GetClient(client_id);
+  if (!client) return false;
+
+  client->GetRemoteAck(ack, ack_bits);
+  return true;
+}
+
+bool ServerNetworkManager::EncodeUDP(uint16_t client_id, const Action &ac,
+                                     OutgoingDatagram &out) {
+  size_t protocol = UseUdp(ac.type);
+  if (protocol == 2 || !udp_server_) return false;
+
+  auto client = client_manager_.GetClient(client_id);
+  if (!client || !client->HasUDPEndpoint()) return false;
+
+  // Format compact pour les clients qui l'ont annonce au login
+  ActionType as = ac.type;
+  if (as == ActionType::GAME_STATE &&
+      client->HasFeature(LoginFeature::F_PACKED_STATE)) {
+    as = ActionType::GAME_STATE_PACKED;
+  }
+
+  out.client_id = client_id;
+  out.seq = client->GetNextOutSeq();
+  out.data = packet_pool_.acquire();
+  uint16_t ack;
+  uint32_t bits;
+  client->GetLocalAck(ack, bits);
+  encode.encodeInto(ac, as, protocol, out.seq, ack, bits, *out.data);
+  if (protocol == 1) {
+    std::lock_guard<std::mutex> lock(client->history_mutex);
+    client->history[out.seq] = {out.seq, *out.data,
+                                std::chrono::steady_clock::now(), 1};
+  }
+  return true;
+}
+
+void ServerNetworkManager::SendBatchUDP(std::vector<OutgoingDatagram> batch) {
+  if (batch.empty() || !udp_server_) return;
+
+  // Un seul post pour tout le lot ; chaque paquet passe a son envoi et
+  // retourne au pool quand celui-ci se termine
+  asio::post(io_context_, [this, batch = std::move(batch)]() mutable {
+    for (auto &datagram : batch) {
+      auto client = client_manager_.GetClient(datagram.client_id);
+      if (!client || !client->HasUDPEndpoint()) continue;
+
+      udp_server_->SendTo(std::move(datagram.data), client->GetUDPEndpoint());
+      client->RecordSent(datagram.seq);
+      client->IncrementPacketsSent();
+    }
+  });
+}
+
 void ServerNetworkManager::CheckClientTimeouts() {
   auto timed_out = client_manager_.CheckTimeouts(CLIENT_TIMEOUT);
 
@@ -327,6 +486,14 @@ void ServerNetworkManager::CheckClientTimeouts() {
       [this](const asio::error_code &) { CheckClientTimeouts(); });
 }
 
+void ServerNetworkManager::SetWakeupCallback(WakeupCallback callback) {
+  wakeup_callback_ = std::move(callback);
+}
+
+void ServerNetworkManager::NotifyWakeup() {
+  if (wakeup_callback_) wakeup_callback_();
+}
+
 void ServerNetworkManager::SetMessageCallback(MessageCallback callback) {
   message_callback_ = std::move(callback);
 }
@@ -351,12 +518,18 @@ void ServerNetworkManager::OnTCPLogin(
     std::cout << "[ServerNetworkManager] Client " << client_id << " ("
               << username << ") logged in via TCP" << std::endl;
 
+    Event login = decode.decode(data);
+    if (const auto *req = std::get_if<LOGIN_REQUEST>(&login.data)) {
+      client->SetFeatures(req->features);
+    }
+
     ConnectionEvent event{ConnectionEvent::CONNECTED, client_id};
     {
       std::lock_guard<std::mutex> lock(events_mutex_);
       connection_events_.push(event);
     }
-    OnReceiveTCP(client_id, data);
+    client->UpdateLastSeen();
+    PushMessage(static_cast<uint16_t>(client_id), std::move(login));
   }
 }
 
@@ -369,6 +542,7 @@ void ServerNetworkManager::OnTCPDisconnect(uint32_t client_id) {
     std::lock_guard<std::mutex> lock(events_mutex_);
     connection_events_.push(event);
   }
+  NotifyWakeup();
 
   client_manager_.RemoveClient(client_id);
 }
@@ -168,7 +168,7 @@ void ProcessPacketTCP::HandleReadPayload(const asio::error_code& error,
   ReadHeader();
 }
 
-void TCPServer::SendTo(const std::vector<uint8_t>& data, uint16_t client_id) {
+void TCPServer::SendTo(PacketPool::Buffer data, uint16_t client_id) {
   std::shared_ptr<ProcessPacketTCP> session;
 
   {
@@ -182,21 +182,62 @@ void TCPServer::SendTo(const std::vector<uint8_t>& data, uint16_t client_id) {
     session = it->second;
   }
 
-  session->SendPacket(data);
+  session->SendPacket(std::move(data));
 }
 
-void ProcessPacketTCP::SendPacket(const std::vector<uint8_t>& data) {
+void ProcessPacketTCP::SendPacket(PacketPool::Buffer data) {
   if (!socket_.is_open()) {
     std::cerr << "[ProcessPacketTCP] Cannot send packet: socket closed"
               << std::endl;
     return;
   }
   auto self = shared_from_this();
-  asio::async_write(socket_, asio::buffer(data),
-                    [this, self](const asio::error_code& error, std::size_t) {
-                      if (error) {
-                        std::cerr << "[ProcessPacketTCP] Send error: "
-                                  << error.message() << std::endl;
-                      }
-                    });
+  const std::vector<uint8_t>& bytes = *data;
+  asio::async_write(
+      socket_, asio::buffer(bytes),
+      [this, self, data = std::move(data)](const asio::error_code& error,
+                                           std::size_t) {
+        if (error) {
+          std::cerr << "[ProcessPacketTCP] Send error: " << error.message()
+                    << std::endl;
+        }
+      });
+}
+
+void TCPServer::SendTo(std::shared_ptr<const std::vector<uint8_t>> data,
+                       uint16_t client_id) {
+  std::shared_ptr<ProcessPacketTCP> session;
+
+  {
+    std::lock_guard<std::mutex> lock(process_packet_mutex_);
+    auto it = sessions_.find(client_id);
+    if (it == sessions_.end()) {
+      std::cerr << "[TCPServer] Cannot send: unknown client " << client_id
+                << std::endl;
+      return;
+    }
+    session = it->second;
+  }
+
+  session->SendPacket(std::move(data));
+}
+
+void ProcessPacketTCP::SendPacket(
+    std::shared_ptr<const std::vector<uint8_t>> data) {
+  if (!socket_.is_open()) {
+    std::cerr << "[ProcessPacketTCP] Cannot send packet: socket closed"
+              << std::endl;
+    return;
+  }
+  auto self = shared_from_this();
+  const std::vector<uint8_t>& bytes = *data;
+  asio::async_write(
+      socket_, asio::buffer(bytes),
+      [this, self, data = std::move(data)](const asio::error_code& error,
+                                           std::size_t) {
+        if (error) {
+          std::cerr << "[ProcessPacketTCP] Send error: " << error.message()
+                    << std::endl;
+        }
+      });
 }
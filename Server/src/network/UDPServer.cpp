@@ -32,10 +32,11 @@ void UDPServer::StartReceive() {
 void UDPServer::HandleReceive(const asio::error_code& error,
                               std::size_t bytes_transferred) {
   if (!error && bytes_transferred > 0) {
+    // Le buffer de reception est prete tel quel, il n'est rempli a nouveau
+    // qu'au prochain StartReceive
     if (receive_callback_) {
-      std::vector<uint8_t> data(recv_buffer_.begin(),
-                                recv_buffer_.begin() + bytes_transferred);
-      receive_callback_(data, remote_endpoint_);
+      receive_callback_(ByteView(recv_buffer_.data(), bytes_transferred),
+                        remote_endpoint_);
     }
     StartReceive();
   } else if (error != asio::error::operation_aborted) {
@@ -44,18 +45,34 @@ void UDPServer::HandleReceive(const asio::error_code& error,
   }
 }
 
-void UDPServer::SendTo(const std::vector<uint8_t>& data,
+void UDPServer::SendTo(PacketPool::Buffer data,
                        const asio::ip::udp::endpoint& endpoint) {
   if (!socket_.is_open()) return;
 
-  socket_.async_send_to(asio::buffer(data), endpoint,
-                        [](const asio::error_code& error, std::size_t) {
-                          if (error) {
-                            std::cerr
-                                << "[UDPServer] Send error: " << error.message()
-                                << std::endl;
-                          }
-                        });
+  const std::vector<uint8_t>& bytes = *data;
+  socket_.async_send_to(
+      asio::buffer(bytes), endpoint,
+      [data = std::move(data)](const asio::error_code& error, std::size_t) {
+        if (error) {
+          std::cerr << "[UDPServer] Send error: " << error.message()
+                    << std::endl;
+        }
+      });
+}
+
+void UDPServer::SendTo(std::shared_ptr<const void> owner,
+                       const std::array<asio::const_buffer, 2>& buffers,
+                       const asio::ip::udp::endpoint& endpoint) {
+  if (!socket_.is_open()) return;
+
+  socket_.async_send_to(
+      buffers, endpoint,
+      [owner = std::move(owner)](const asio::error_code& error, std::size_t) {
+        if (error) {
+          std::cerr << "[UDPServer] Send error: " << error.message()
+                    << std::endl;
+        }
+      });
 }
 
 void UDPServer::Close() {
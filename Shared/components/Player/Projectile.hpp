@@ -10,10 +10,17 @@ struct Projectile {
   size_t ownerId;
   bool isActive = true;
   int chargeLevel = 0;
+  // Projectile rapide : collision balayee (swept AABB) au lieu d'un test
+  // ponctuel, pour ne pas traverser les cibles a faible tick rate
+  bool fastMover = false;
+
+  // Faux au tick du tir : le projectile apparait a la bouche du canon et n'a
+  // pas encore bouge, il n'y a donc pas de trajet a balayer derriere lui
+  bool hasTravelled() const { return currentLife > 0.0f; }
 
   explicit Projectile(float dmg = 10.0f, float spd = 300.0f,
                       Vector2 dir = {1.0f, 0.0f}, float life = 5.0f,
-                      size_t owner = 0, int charge = 0)
+                      size_t owner = 0, int charge = 0, bool fast = false)
       : damage(dmg),
         speed(spd),
         direction(dir),
@@ -21,5 +28,6 @@ struct Projectile {
         currentLife(0.0f),
         ownerId(owner),
         isActive(true),
-        chargeLevel(charge) {}
+        chargeLevel(charge),
+        fastMover(fast) {}
 };
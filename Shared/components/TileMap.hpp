@@ -1,6 +1,10 @@
 // Chemin: shared/components/TileMap.hpp
 #pragma once
+#include <cmath>
 #include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 #include <vector>
 
 #include "physics/Physics2D.hpp"  // Pour Vector2
@@ -13,6 +17,17 @@ enum class TileType : uint8_t {
   PLATFORM = 4,
 };
 
+// Index du bit de poids faible d'un mot non nul
+inline int tilemapLowestBit(uint64_t word) {
+#if defined(_MSC_VER)
+  unsigned long idx;
+  _BitScanForward64(&idx, word);
+  return static_cast<int>(idx);
+#else
+  return __builtin_ctzll(word);
+#endif
+}
+
 struct TileMap {
   uint16_t width = 0;
   uint16_t height = 0;
@@ -22,6 +37,20 @@ struct TileMap {
   std::vector<uint8_t> tiles;
   bool isLoaded = false;
 
+  // Masques de tuiles solides precalcules : un bitset par ligne (width bits)
+  // et un par colonne (height bits). Maintenus par setTile, reconstruits par
+  // rebuildSolidMasks quand `tiles` est rempli directement.
+  std::vector<uint64_t> solidRows;
+  std::vector<uint64_t> solidCols;
+  size_t rowWords = 0;
+  size_t colWords = 0;
+  bool solidMasksReady = false;
+
+  static bool isSolidType(TileType type) {
+    return type == TileType::GROUND || type == TileType::WALL ||
+           type == TileType::CEILING || type == TileType::PLATFORM;
+  }
+
   TileType getTile(int x, int y) const {
     if (x < 0 || x >= static_cast<int>(width) || y < 0 ||
         y >= static_cast<int>(height)) {
@@ -34,36 +63,113 @@ struct TileMap {
     if (x >= 0 && x < static_cast<int>(width) && y >= 0 &&
         y < static_cast<int>(height)) {
       tiles[y * width + x] = static_cast<uint8_t>(type);
+      if (solidMasksReady) setSolidBit(x, y, isSolidType(type));
     }
   }
 
+  void rebuildSolidMasks() {
+    rowWords = (static_cast<size_t>(width) + 63) / 64;
+    colWords = (static_cast<size_t>(height) + 63) / 64;
+    solidRows.assign(rowWords * height, 0);
+    solidCols.assign(colWords * width, 0);
+    solidMasksReady = tiles.size() >= static_cast<size_t>(width) * height;
+    if (!solidMasksReady) return;
+
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        if (isSolidType(static_cast<TileType>(tiles[y * width + x]))) {
+          setSolidBit(x, y, true);
+        }
+      }
+    }
+  }
+
+  int pixelToTileX(float pixelX) const {
+    return static_cast<int>((pixelX + scrollOffset) / tileSize);
+  }
+
+  int pixelToTileY(float pixelY) const {
+    return static_cast<int>(pixelY / tileSize);
+  }
+
   TileType getTileAtPixel(float pixelX, float pixelY) const {
-    int tileX = static_cast<int>((pixelX + scrollOffset) / tileSize);
-    int tileY = static_cast<int>(pixelY / tileSize);
-    return getTile(tileX, tileY);
+    return getTile(pixelToTileX(pixelX), pixelToTileY(pixelY));
   }
 
   bool isSolid(int tileX, int tileY) const {
-    TileType type = getTile(tileX, tileY);
-    return type == TileType::GROUND || type == TileType::WALL ||
-           type == TileType::CEILING || type == TileType::PLATFORM;
+    if (tileX < 0 || tileX >= static_cast<int>(width) || tileY < 0 ||
+        tileY >= static_cast<int>(height)) {
+      return false;
+    }
+    if (!solidMasksReady) return isSolidType(getTile(tileX, tileY));
+    return (solidRows[tileY * rowWords + (tileX >> 6)] >> (tileX & 63)) & 1u;
   }
 
   bool isSolidAtPixel(float pixelX, float pixelY) const {
-    int tileX = static_cast<int>((pixelX + scrollOffset) / tileSize);
-    int tileY = static_cast<int>(pixelY / tileSize);
-    return isSolid(tileX, tileY);
+    return isSolid(pixelToTileX(pixelX), pixelToTileY(pixelY));
   }
 
-  // Collision avec une BoxCollider
+  // Premiere colonne solide de la ligne `row` dans [x0, x1], -1 si aucune
+  int firstSolidInSpan(int row, int x0, int x1) const {
+    if (row < 0 || row >= static_cast<int>(height)) return -1;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= static_cast<int>(width)) x1 = static_cast<int>(width) - 1;
+    if (x0 > x1) return -1;
+    if (!solidMasksReady) {
+      for (int x = x0; x <= x1; ++x)
+        if (isSolid(x, row)) return x;
+      return -1;
+    }
+    return firstBitInRange(&solidRows[row * rowWords], x0, x1);
+  }
+
+  // Premiere ligne solide de la colonne `col` dans [y0, y1], -1 si aucune
+  int firstSolidInColumnSpan(int col, int y0, int y1) const {
+    if (col < 0 || col >= static_cast<int>(width)) return -1;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= static_cast<int>(height)) y1 = static_cast<int>(height) - 1;
+    if (y0 > y1) return -1;
+    if (!solidMasksReady) {
+      for (int y = y0; y <= y1; ++y)
+        if (isSolid(col, y)) return y;
+      return -1;
+    }
+    return firstBitInRange(&solidCols[col * colWords], y0, y1);
+  }
+
+  // Collision avec une BoxCollider : toutes les tuiles couvertes par la boite
   bool checkCollision(const Vector2& position,
                       const BoxCollider& collider) const {
     auto bounds = collider.GetBounds(position);
+    int x0 = pixelToTileX(bounds.left);
+    int x1 = pixelToTileX(bounds.right);
+    int y0 = pixelToTileY(bounds.top);
+    int y1 = pixelToTileY(bounds.bottom);
 
-    return isSolidAtPixel(bounds.left, bounds.top) ||
-           isSolidAtPixel(bounds.right, bounds.top) ||
-           isSolidAtPixel(bounds.left, bounds.bottom) ||
-           isSolidAtPixel(bounds.right, bounds.bottom);
+    for (int y = y0; y <= y1; ++y) {
+      if (firstSolidInSpan(y, x0, x1) >= 0) return true;
+    }
+    return false;
+  }
+
+  // Collision balayee : la boite va de `from` a `to` pendant le tick. On
+  // echantillonne le trajet par pas d'une demi-tuile pour ne pas sauter de
+  // tuile, et `toi` recoit la fraction du trajet au premier contact.
+  bool sweepCollision(const Vector2& from, const Vector2& to,
+                      const BoxCollider& collider, float& toi) const {
+    Vector2 delta = to - from;
+    float step = tileSize * 0.5f;
+    int samples = static_cast<int>(std::ceil(delta.Length() / step));
+    if (samples < 1) samples = 1;
+
+    for (int i = 0; i <= samples; ++i) {
+      float t = static_cast<float>(i) / samples;
+      if (checkCollision(from + delta * t, collider)) {
+        toi = t;
+        return true;
+      }
+    }
+    return false;
   }
 
   void init(uint16_t w, uint16_t h, uint16_t tSize = 32) {
@@ -72,7 +178,34 @@ struct TileMap {
     tileSize = tSize;
     scrollOffset = 0.0f;
     tiles.resize(w * h, static_cast<uint8_t>(TileType::EMPTY));
+    rebuildSolidMasks();
   }
 
   void update(float deltaTime) { scrollOffset += scrollSpeed * deltaTime; }
+
+ private:
+  void setSolidBit(int x, int y, bool solid) {
+    uint64_t& rowWord = solidRows[y * rowWords + (x >> 6)];
+    uint64_t& colWord = solidCols[x * colWords + (y >> 6)];
+    if (solid) {
+      rowWord |= uint64_t{1} << (x & 63);
+      colWord |= uint64_t{1} << (y & 63);
+    } else {
+      rowWord &= ~(uint64_t{1} << (x & 63));
+      colWord &= ~(uint64_t{1} << (y & 63));
+    }
+  }
+
+  static int firstBitInRange(const uint64_t* words, int from, int to) {
+    int firstWord = from >> 6;
+    int lastWord = to >> 6;
+    for (int w = firstWord; w <= lastWord; ++w) {
+      uint64_t word = words[w];
+      if (w == firstWord) word &= ~uint64_t{0} << (from & 63);
+      if (w == lastWord && (to & 63) != 63)
+        word &= (uint64_t{1} << ((to & 63) + 1)) - 1;
+      if (word) return (w << 6) + tilemapLowestBit(word);
+    }
+    return -1;
+  }
 };
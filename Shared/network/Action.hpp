@@ -26,6 +26,7 @@ enum class ActionType : uint8_t {
   MESSAGE,
   LOBBY_KICK,
   CLIENT_LEAVE,
+  ASSETS_READY,
 
   // Serveur → Client
   LEVEL_TRANSITION,
@@ -43,15 +44,23 @@ enum class ActionType : uint8_t {
   BOSS_UPDATE,
   ENEMY_HIT,
   SEND_MAP,
+  GAME_STATE_PACKED,  // GameState au format compact, voir BitStream.hpp
 };
 
 struct AuthUDP {
   uint16_t playerId;
 };
 
+// Capacites annoncees par le client au login
+enum LoginFeature : uint8_t {
+  F_NONE = 0,
+  F_PACKED_STATE = 1 << 0,  // Recoit GAME_STATE_PACKED
+};
+
 struct LoginReq {
   std::string username;
   std::string passwordHash;
+  uint8_t features = F_PACKED_STATE;
 };
 
 struct PlayerInput {
@@ -212,6 +221,8 @@ struct ProjectileState {
 };
 
 struct GameState {
+  uint32_t tick = 0;  // tick serveur de la simulation
+  uint32_t baseTick = 0;  // tick de reference du delta, = tick si complet
   std::vector<PlayerState> players;
   std::vector<EnemyState> enemies;
   std::vector<ProjectileState> projectiles;
@@ -255,6 +266,10 @@ struct ClientLeave {
   uint16_t playerId;
 };
 
+struct AssetsReady {
+  uint16_t playerId;
+};
+
 struct ForceState {
   uint16_t forceId;
   uint16_t ownerId;
@@ -273,7 +288,8 @@ using ActionData =
                  LobbyListResponse, PlayerReady, LobbyUpdate, LobbyStart,
                  GameStart, GameEnd, ErrorMsg, GameState, BossSpawn, BossUpdate,
                  EnemyHit, LobbyListRequest, LobbyLeave, Message, LobbyKick,
-                 ForceState, MapData, ClientLeave, LevelTransition>;
+                 ForceState, MapData, ClientLeave, LevelTransition,
+                 AssetsReady>;
 
 struct Action {
   ActionType type;
@@ -294,6 +310,7 @@ inline size_t UseUdp(ActionType type) {
     case ActionType::FIRE_PRESS:
     case ActionType::FIRE_RELEASE:
     case ActionType::GAME_STATE:
+    case ActionType::GAME_STATE_PACKED:
     case ActionType::BOSS_UPDATE:
     case ActionType::FORCE_STATE:
       return 0;  // UDP
@@ -319,6 +336,7 @@ inline size_t UseUdp(ActionType type) {
     case ActionType::MESSAGE:
     case ActionType::LOBBY_KICK:
     case ActionType::CLIENT_LEAVE:
+    case ActionType::ASSETS_READY:
     case ActionType::ERROR_SERVER:
     case ActionType::SEND_MAP:
       return 2;  // TCP
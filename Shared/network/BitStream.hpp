@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Quantisation ranges of the bit-packed GAME_STATE
+ *
+ * Positions cover the 800x600 playfield plus the off-screen margins the
+ * bounds system allows before killing an entity.
+ */
+namespace quant {
+constexpr float POS_X_MIN = -256.0f;
+constexpr float POS_X_RANGE = 1536.0f;
+constexpr unsigned POS_X_BITS = 13;  ///< 0.19 px steps
+constexpr float POS_Y_MIN = -256.0f;
+constexpr float POS_Y_RANGE = 1024.0f;
+constexpr unsigned POS_Y_BITS = 12;  ///< 0.25 px steps
+constexpr float VEL_MIN = -1024.0f;
+constexpr float VEL_RANGE = 2048.0f;
+constexpr unsigned VEL_BITS = 12;  ///< 0.5 px/s steps
+
+inline uint32_t quantize(float value, float min, float range, unsigned bits) {
+  const uint32_t steps = (1u << bits) - 1;
+  float t = (value - min) / range;
+  if (!(t > 0.0f)) return 0;
+  if (t >= 1.0f) return steps;
+  return static_cast<uint32_t>(std::lround(t * steps));
+}
+
+inline float dequantize(uint32_t q, float min, float range, unsigned bits) {
+  const uint32_t steps = (1u << bits) - 1;
+  return min + range * static_cast<float>(q) / static_cast<float>(steps);
+}
+}  // namespace quant
+
+/**
+ * @class BitWriter
+ * @brief Appends values of arbitrary bit width to a byte buffer, MSB first
+ */
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+  void write(uint32_t value, unsigned bits) {
+    if (bits < 32) value &= (1u << bits) - 1;
+    acc = (acc << bits) | value;
+    count += bits;
+    while (count >= 8) {
+      count -= 8;
+      out.push_back(static_cast<uint8_t>(acc >> count));
+    }
+  }
+
+  /**
+   * @brief 7 bits per group, high bit set when another group follows
+   */
+  void writeVarint(uint32_t value) {
+    while (value >= 0x80) {
+      write((value & 0x7F) | 0x80, 8);
+      value >>= 7;
+    }
+    write(value, 8);
+  }
+
+  /**
+   * @brief Zigzag varint, small magnitudes of either sign stay short
+   */
+  void writeSigned(int32_t value) {
+    writeVarint((static_cast<uint32_t>(value) << 1) ^
+                static_cast<uint32_t>(value >> 31));
+  }
+
+  /**
+   * @brief Pad the last byte with zeros
+   */
+  void flush() {
+    if (count > 0) write(0, 8 - count);
+  }
+
+ private:
+  std::vector<uint8_t>& out;
+  uint64_t acc = 0;
+  unsigned count = 0;
+};
+
+/**
+ * @class BitReader
+ * @brief Reads what BitWriter wrote; every read fails past the end
+ */
+class BitReader {
+ public:
+  BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+  bool read(unsigned bits, uint32_t& value) {
+    if (bits > (size - pos) * 8 - used) return false;
+    value = 0;
+    while (bits > 0) {
+      unsigned avail = 8 - used;
+      unsigned take = bits < avail ? bits : avail;
+      uint32_t chunk = (data[pos] >> (avail - take)) & ((1u << take) - 1);
+      value = (value << take) | chunk;
+      bits -= take;
+      used += take;
+      if (used == 8) {
+        used = 0;
+        pos++;
+      }
+    }
+    return true;
+  }
+
+  bool readVarint(uint32_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+      uint32_t group;
+      if (!read(8, group)) return false;
+      value |= (group & 0x7F) << shift;
+      if (!(group & 0x80)) return true;
+    }
+    return false;
+  }
+
+  bool readSigned(int32_t& value) {
+    uint32_t raw;
+    if (!readVarint(raw)) return false;
+    value = static_cast<int32_t>((raw >> 1) ^ (~(raw & 1) + 1));
+    return true;
+  }
+
+ private:
+  const uint8_t* data;
+  size_t size;
+  size_t pos = 0;
+  unsigned used = 0;  ///< Bits already read in data[pos]
+};
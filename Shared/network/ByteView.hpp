@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ByteView
+ * @brief Read-only view over bytes owned by someone else (a receive buffer,
+ * a vector), passed by value instead of copying the bytes
+ *
+ * Same reading interface as a const std::vector<uint8_t>, so the decoders
+ * take either without a copy.
+ */
+class ByteView {
+ public:
+  ByteView() = default;
+  ByteView(const uint8_t* data, size_t size) : ptr(data), count(size) {}
+  ByteView(const std::vector<uint8_t>& bytes)  // NOLINT(runtime/explicit)
+      : ptr(bytes.data()), count(bytes.size()) {}
+
+  const uint8_t& operator[](size_t index) const { return ptr[index]; }
+  const uint8_t* data() const { return ptr; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const uint8_t* begin() const { return ptr; }
+  const uint8_t* end() const { return ptr + count; }
+
+ private:
+  const uint8_t* ptr = nullptr;
+  size_t count = 0;
+};
@@ -1,1142 +1,411 @@
 #include "network/DecodeFunc.hpp"
 
-#include "network/DataMask.hpp"
-
-// #include <arpa/inet.h>
-#ifdef _WIN32
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#else
-#include <arpa/inet.h>
-#endif
-
-#include <cstring>
-#include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
-bool checkHeader(const std::vector<uint8_t>& packet, size_t& offset,
-                 uint32_t& payloadLength, uint16_t& seq, uint16_t& ack,
-                 uint32_t& ack_bits) {
-  if (packet.size() < 6) return false;
-
-  uint8_t flags = packet[1];
-
-  memcpy(&payloadLength, &packet[2], 4);
-  payloadLength = ntohl(payloadLength);
-
-  offset = 6;
-
-  if ((flags & 0x02) || (flags & 0x08)) {
-    if (packet.size() < 14) return false;
-    memcpy(&seq, &packet[offset], 2);
-    seq = ntohs(seq);
-    offset += 2;
-
-    memcpy(&ack, &packet[offset], 2);
-    ack = ntohs(ack);
-    offset += 2;
+#include "network/BitStream.hpp"
+#include "network/DataMask.hpp"
+#include "network/Protocol.hpp"
+#include "network/Schema.hpp"
 
-    memcpy(&ack_bits, &packet[offset], 4);
-    ack_bits = ntohl(ack_bits);
-    offset += 4;
-  }
-  return packet.size() == (offset + payloadLength);
-}
+// Les handlers ne recoivent que la charge utile, l'en-tete est deja lu par
+// Decoder::decode. Une lecture hors de la charge utile fait echouer le
+// lecteur et le paquet est rejete : ils lisent donc sans verifier chaque
+// champ et ne testent in.ok() que pour sortir tot d'une boucle.
 
-Event DecodeLOGIN_REQUEST(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOGIN_REQUEST;
+Event DecodeLOGIN_REQUEST(PacketReader& in) {
   LOGIN_REQUEST data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
+  in.string(data.username);
+  in.string(data.password);
 
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
+  // Octet optionnel, absent chez les anciens clients
+  if (in.remaining() > 0) in.u8(data.features);
 
-  uint8_t usernameLen = packet[offset++];
-  data.username =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), usernameLen);
-  offset += usernameLen;
-
-  uint8_t passwordLen = packet[offset++];
-  data.password =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), passwordLen);
-  offset += passwordLen;
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::LOGIN_REQUEST, std::move(data)};
 }
 
-Event DecodeLOGIN_RESPONSE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOGIN_RESPONSE;
-
-  LOGIN_RESPONSE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.success = packet[offset++];
+Event DecodeLOGIN_RESPONSE(PacketReader& in) {
+  LOGIN_RESPONSE data{};
+  in.u8(data.success);
   if (data.success == 1) {
-    memcpy(&data.playerId, &packet[offset], sizeof(data.playerId));
-    data.playerId = ntohs(data.playerId);
-    offset += sizeof(data.playerId);
-
-    memcpy(&data.udpPort, &packet[offset], sizeof(data.udpPort));
-    data.udpPort = ntohs(data.udpPort);
-    offset += sizeof(data.udpPort);
+    in.u16(data.playerId);
+    in.u16(data.udpPort);
   } else {
-    memcpy(&data.errorCode, &packet[offset], sizeof(data.errorCode));
-    data.errorCode = ntohs(data.errorCode);
-    offset += sizeof(data.errorCode);
-
-    uint8_t msgLen = packet[offset++];
-    data.message =
-        std::string(reinterpret_cast<const char*>(&packet[offset]), msgLen);
-    offset += msgLen;
+    in.u16(data.errorCode);
+    in.string(data.message);
   }
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::LOGIN_RESPONSE, std::move(data)};
 }
 
-Event DecodeGAME_START(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::GAME_START;
-
-  GAME_START data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  uint32_t temp;
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.playerSpawnX, &temp, sizeof(data.playerSpawnX));
-  offset += sizeof(temp);
-
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.playerSpawnY, &temp, sizeof(data.playerSpawnY));
-  offset += sizeof(temp);
-
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.scrollSpeed, &temp, sizeof(data.scrollSpeed));
-  offset += sizeof(temp);
-
-  evt.data = data;
-  return evt;
-}
+Event DecodeGAME_END(PacketReader& in) {
+  GAME_END data{};
+  uint8_t victory = 0;
+  uint8_t playerCount = 0;
+  in.u8(victory);
+  in.u8(playerCount);
+  data.victory = victory != 0;
 
-Event DecodeGAME_END(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::GAME_END;
-
-  GAME_END data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.victory = (packet[offset++] != 0);
-  uint8_t playerCount = packet[offset++];
   data.scores.reserve(playerCount);
-
-  for (uint8_t i = 0; i < playerCount; ++i) {
-    GAME_END::Score score;
-    memcpy(&score.playerId, &packet[offset], sizeof(score.playerId));
-    score.playerId = ntohs(score.playerId);
-    offset += sizeof(score.playerId);
-
-    uint8_t nameLen = packet[offset++];
-    score.playerName.assign(reinterpret_cast<const char*>(&packet[offset]), nameLen);
-    offset += nameLen;
-  
-    memcpy(&score.score, &packet[offset], sizeof(score.score));
-    score.score = ntohl(score.score);
-    offset += sizeof(score.score);
-
-    score.rank = packet[offset++];    
-    data.scores.push_back(score);
+  for (uint8_t i = 0; i < playerCount && in.ok(); ++i) {
+    GAME_END::Score score{};
+    in.u16(score.playerId);
+    in.string(score.playerName);
+    in.u32(score.score);
+    in.u8(score.rank);
+    data.scores.push_back(std::move(score));
   }
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::GAME_END, std::move(data)};
 }
 
-Event DecodeERROR(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::ERROR_TYPE;
-
-  ERROR_EVNT data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.errorCode, &packet[offset], sizeof(data.errorCode));
-  data.errorCode = ntohs(data.errorCode);
-  offset += sizeof(data.errorCode);
-
-  uint8_t msgLen = packet[offset++];
-  data.message =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), msgLen);
-  offset += msgLen;
-
-  evt.data = data;
-  return evt;
+Event DecodeERROR(PacketReader& in) {
+  ERROR_EVNT data{};
+  in.u16(data.errorCode);
+  in.string(data.message);
+  return Event{EventType::ERROR_TYPE, std::move(data)};
 }
 
-Event DecodePLAYER_INPUT(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::PLAYER_INPUT;
-
-  PLAYER_INPUT data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.up = packet[offset++] == 1;
-  data.down = packet[offset++] == 1;
-  data.left = packet[offset++] == 1;
-  data.right = packet[offset++] == 1;
-  data.fire = packet[offset++];
-
-  evt.data = data;
-  return evt;
+namespace {
+
+// Plus petite entree d'une liste de GAME_STATE : id et masque
+constexpr size_t MIN_ENTRY = 4;
+
+/**
+ * @brief Lire le nombre d'entrees d'une liste ; une liste absente en fin de
+ * paquet est vide, un nombre que la charge restante ne peut pas contenir
+ * rejette le paquet sans lire les entrees
+ */
+uint8_t ReadCount(PacketReader& in) {
+  uint8_t count = 0;
+  if (in.remaining() == 0) return 0;
+  in.u8(count);
+  if (count * MIN_ENTRY > in.remaining()) in.fail();
+  return in.ok() ? count : 0;
 }
 
-Event DecodeGAME_STATE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::GAME_STATE;
-  GAME_STATE data;
-  size_t offset = 0;
-  uint32_t payloadLength;
-  uint16_t seq, ack;
-  uint32_t ack_bits;
-  uint32_t temp32;
+}  // namespace
 
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits)) {
-    return evt;
+Event DecodeGAME_STATE(PacketReader& in) {
+  GAME_STATE data;
+  in.u32(data.tick);
+  in.u32(data.baseTick);
+
+  uint8_t count = ReadCount(in);
+  data.players.reserve(count);
+  for (uint8_t i = 0; i < count && in.ok(); ++i) {
+    GAME_STATE::PlayerState p{};
+    in.u16(p.playerId);
+    in.u16(p.mask);
+    if (p.mask & M_POS_X) in.f32(p.posX);
+    if (p.mask & M_POS_Y) in.f32(p.posY);
+    if (p.mask & M_HP) in.u8(p.hp);
+    if (p.mask & M_STATE) in.u8(p.state);
+    if (p.mask & M_SHIELD) in.u8(p.shield);
+    if (p.mask & M_WEAPON) in.u8(p.weapon);
+    if (p.mask & M_SPRITE) in.u8(p.sprite);
+    if (p.mask & M_SCORE) in.u32(p.score);
+    data.players.push_back(p);
   }
 
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  // JOUEURS
-  if (offset < packet.size()) {
-    uint8_t numPlayers = packet[offset++];
-    for (int i = 0; i < numPlayers; ++i) {
-      if (offset + 4 > packet.size()) break;
-
-      GAME_STATE::PlayerState p;
-
-      memcpy(&p.playerId, &packet[offset], 2);
-      p.playerId = ntohs(p.playerId);
-      offset += 2;
+  count = ReadCount(in);
+  data.enemies.reserve(count);
+  for (uint8_t i = 0; i < count && in.ok(); ++i) {
+    GAME_STATE::EnemyState e{};
+    in.u16(e.enemyId);
+    in.u16(e.mask);
+    if (e.mask & M_POS_X) in.f32(e.posX);
+    if (e.mask & M_POS_Y) in.f32(e.posY);
+    if (e.mask & M_HP) in.u8(e.hp);
+    if (e.mask & M_STATE) in.u8(e.state);
+    if (e.mask & M_TYPE) in.u8(e.enemyType);
+    if (e.mask & M_DIR) in.i8(e.direction);
+    data.enemies.push_back(e);
+  }
 
-      memcpy(&p.mask, &packet[offset], 2);
-      p.mask = ntohs(p.mask);
-      offset += 2;
+  count = ReadCount(in);
+  data.projectiles.reserve(count);
+  for (uint8_t i = 0; i < count && in.ok(); ++i) {
+    GAME_STATE::ProjectileState pr{};
+    in.u16(pr.projectileId);
+    in.u16(pr.mask);
+    if (pr.mask & M_POS_X) in.f32(pr.posX);
+    if (pr.mask & M_POS_Y) in.f32(pr.posY);
+    if (pr.mask & M_TYPE) in.u8(pr.type);
+    if (pr.mask & M_OWNER) in.u16(pr.ownerId);
+    if (pr.mask & M_DAMAGE) in.u8(pr.damage);
+    data.projectiles.push_back(pr);
+  }
 
-      if (p.mask & M_POS_X) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&p.posX, &temp32, 4);
-        offset += 4;
-      }
-      if (p.mask & M_POS_Y) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&p.posY, &temp32, 4);
-        offset += 4;
-      }
-      if (p.mask & M_HP) {
-        if (offset >= packet.size()) break;
-        p.hp = packet[offset++];
-      }
-      if (p.mask & M_STATE) {
-        if (offset >= packet.size()) break;
-        p.state = packet[offset++];
-      }
-      if (p.mask & M_SHIELD) {
-        if (offset >= packet.size()) break;
-        p.shield = packet[offset++];
-      }
-      if (p.mask & M_WEAPON) {
-        if (offset >= packet.size()) break;
-        p.weapon = packet[offset++];
-      }
-      if (p.mask & M_SPRITE) {
-        if (offset >= packet.size()) break;
-        p.sprite = packet[offset++];
-      }
-      if (p.mask & M_SCORE) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&p.score, &temp32, 4);
-        offset += 4;
-      }
+  return Event{EventType::GAME_STATE, std::move(data)};
+}
 
-      data.players.push_back(p);
+Event DecodeGAME_STATE_PACKED(PacketReader& in) {
+  GAME_STATE data;
+  BitReader r(in.data(), in.remaining());
+  uint32_t v;
+
+  // TICK et age de la reference
+  if (!r.read(32, data.tick) || !r.readVarint(v)) return Event{};
+  data.baseTick = data.tick - v;
+
+  auto readPos = [&](uint16_t mask, float& x, float& y) {
+    if (mask & M_POS_X) {
+      if (!r.read(quant::POS_X_BITS, v)) return false;
+      x = quant::dequantize(v, quant::POS_X_MIN, quant::POS_X_RANGE,
+                            quant::POS_X_BITS);
     }
+    if (mask & M_POS_Y) {
+      if (!r.read(quant::POS_Y_BITS, v)) return false;
+      y = quant::dequantize(v, quant::POS_Y_MIN, quant::POS_Y_RANGE,
+                            quant::POS_Y_BITS);
+    }
+    return true;
+  };
+  auto readByte = [&](uint16_t mask, uint16_t bit, uint8_t& field) {
+    if (!(mask & bit)) return true;
+    if (!r.read(8, v)) return false;
+    field = static_cast<uint8_t>(v);
+    return true;
+  };
+
+  int32_t prevId = 0;
+  uint16_t prevMask = 0;
+  auto readId = [&](uint16_t& id, uint16_t& mask) {
+    int32_t delta = 1;
+    if (!r.read(1, v)) return false;
+    if (!v && !r.readSigned(delta)) return false;
+    // Un ecart hors de la plage des ids ne vient pas de l'encodeur
+    if (delta < -0xFFFF || delta > 0xFFFF) return false;
+    prevId = static_cast<uint16_t>(prevId + delta);
+    id = static_cast<uint16_t>(prevId);
+
+    if (!r.read(1, v)) return false;
+    if (!v) {
+      if (!r.readVarint(v)) return false;
+      prevMask = static_cast<uint16_t>(v);
+    }
+    mask = prevMask;
+    return true;
+  };
+
+  // Un etat tronque est ecarte en entier
+  uint32_t count;
+  if (!r.readVarint(count)) return Event{};
+  prevId = 0;
+  prevMask = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    GAME_STATE::PlayerState p{};
+    if (!readId(p.playerId, p.mask) || !readPos(p.mask, p.posX, p.posY) ||
+        !readByte(p.mask, M_HP, p.hp) || !readByte(p.mask, M_STATE, p.state) ||
+        !readByte(p.mask, M_SHIELD, p.shield) ||
+        !readByte(p.mask, M_WEAPON, p.weapon) ||
+        !readByte(p.mask, M_SPRITE, p.sprite)) {
+      return Event{};
+    }
+    if (p.mask & M_SCORE) {
+      if (!r.readVarint(p.score)) return Event{};
+    }
+    data.players.push_back(p);
   }
 
-  // ENNEMIS
-  if (offset < packet.size()) {
-    uint8_t numEnemies = packet[offset++];
-    for (int i = 0; i < numEnemies; ++i) {
-      if (offset + 4 > packet.size()) break;
-
-      GAME_STATE::EnemyState e;
-
-      memcpy(&e.enemyId, &packet[offset], 2);
-      e.enemyId = ntohs(e.enemyId);
-      offset += 2;
-
-      memcpy(&e.mask, &packet[offset], 2);
-      e.mask = ntohs(e.mask);
-      offset += 2;
-
-      if (e.mask & M_POS_X) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&e.posX, &temp32, 4);
-        offset += 4;
-      }
-      if (e.mask & M_POS_Y) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&e.posY, &temp32, 4);
-        offset += 4;
-      }
-      if (e.mask & M_HP) {
-        if (offset >= packet.size()) break;
-        e.hp = packet[offset++];
-      }
-      if (e.mask & M_STATE) {
-        if (offset >= packet.size()) break;
-        e.state = packet[offset++];
-      }
-      if (e.mask & M_TYPE) {
-        if (offset >= packet.size()) break;
-        e.enemyType = packet[offset++];
-      }
-      if (e.mask & M_DIR) {
-        if (offset >= packet.size()) break;
-        e.direction = (int8_t)packet[offset++];
-      }
-
-      data.enemies.push_back(e);
+  if (!r.readVarint(count)) return Event{};
+  prevId = 0;
+  prevMask = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    GAME_STATE::EnemyState e{};
+    if (!readId(e.enemyId, e.mask) || !readPos(e.mask, e.posX, e.posY) ||
+        !readByte(e.mask, M_HP, e.hp) || !readByte(e.mask, M_STATE, e.state) ||
+        !readByte(e.mask, M_TYPE, e.enemyType)) {
+      return Event{};
+    }
+    if (e.mask & M_DIR) {
+      if (!r.read(2, v)) return Event{};
+      e.direction = static_cast<int8_t>(static_cast<int>(v) - 1);
     }
+    data.enemies.push_back(e);
   }
 
-  // PROJECTILES
-  if (offset < packet.size()) {
-    uint8_t numProjectiles = packet[offset++];
-    for (int i = 0; i < numProjectiles; ++i) {
-      if (offset + 4 > packet.size()) break;
-
-      GAME_STATE::ProjectileState pr;
-
-      memcpy(&pr.projectileId, &packet[offset], 2);
-      pr.projectileId = ntohs(pr.projectileId);
-      offset += 2;
-
-      memcpy(&pr.mask, &packet[offset], 2);
-      pr.mask = ntohs(pr.mask);
-      offset += 2;
-
-      if (pr.mask & M_POS_X) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&pr.posX, &temp32, 4);
-        offset += 4;
-      }
-      if (pr.mask & M_POS_Y) {
-        memcpy(&temp32, &packet[offset], 4);
-        temp32 = ntohl(temp32);
-        memcpy(&pr.posY, &temp32, 4);
-        offset += 4;
-      }
-      if (pr.mask & M_TYPE) {
-        if (offset >= packet.size()) break;
-        pr.type = packet[offset++];
-      }
-      if (pr.mask & M_OWNER) {
-        if (offset + 2 > packet.size()) break;
-        uint16_t owner;
-        memcpy(&owner, &packet[offset], 2);
-        pr.ownerId = ntohs(owner);
-        offset += 2;
-      }
-      if (pr.mask & M_DAMAGE) {
-        if (offset >= packet.size()) break;
-        pr.damage = packet[offset++];
-      }
-
-      data.projectiles.push_back(pr);
+  if (!r.readVarint(count)) return Event{};
+  prevId = 0;
+  prevMask = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    GAME_STATE::ProjectileState pr{};
+    if (!readId(pr.projectileId, pr.mask) ||
+        !readPos(pr.mask, pr.posX, pr.posY)) {
+      return Event{};
     }
+    if (pr.mask & M_VELOCITY) {
+      if (!r.read(quant::VEL_BITS, v)) return Event{};
+      pr.velX = quant::dequantize(v, quant::VEL_MIN, quant::VEL_RANGE,
+                                  quant::VEL_BITS);
+      if (!r.read(quant::VEL_BITS, v)) return Event{};
+      pr.velY = quant::dequantize(v, quant::VEL_MIN, quant::VEL_RANGE,
+                                  quant::VEL_BITS);
+    }
+    if (!readByte(pr.mask, M_TYPE, pr.type)) return Event{};
+    if (pr.mask & M_OWNER) {
+      if (!r.readVarint(v)) return Event{};
+      pr.ownerId = static_cast<uint16_t>(v);
+    }
+    if (!readByte(pr.mask, M_DAMAGE, pr.damage)) return Event{};
+    data.projectiles.push_back(pr);
   }
 
-  evt.data = data;
-  return evt;
+  return Event{EventType::GAME_STATE, std::move(data)};
 }
 
-Event DecodeAUTH(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::AUTH;
-
-  AUTH data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.playerId, &packet[offset], sizeof(data.playerId));
-  data.playerId = ntohs(data.playerId);
-  offset += sizeof(data.playerId);
-
-  evt.data = data;
-  return evt;
+Event DecodeLOBBY_CREATE(PacketReader& in) {
+  LOBBY_CREATE data{};
+  in.string(data.lobbyName);
+  in.string(data.playerName);
+  in.string(data.password);
+  in.u8(data.Maxplayer);
+  in.u8(data.difficulty);
+  return Event{EventType::LOBBY_CREATE, std::move(data)};
 }
 
-Event DecodeBOSS_SPAWN(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::BOSS_SPAWN;
-
-  BOSS_SPAWN data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.bossId, &packet[offset], sizeof(data.bossId));
-  data.bossId = ntohs(data.bossId);
-  offset += sizeof(data.bossId);
-
-  data.bossType = packet[offset++];
-
-  memcpy(&data.maxHp, &packet[offset], sizeof(data.maxHp));
-  data.maxHp = ntohs(data.maxHp);
-  offset += sizeof(data.maxHp);
-
-  data.phase = packet[offset++];
-  evt.data = data;
-  return evt;
+Event DecodeLOBBY_JOIN_REQUEST(PacketReader& in) {
+  LOBBY_JOIN_REQUEST data{};
+  in.u16(data.lobbyId);
+  in.string(data.name);
+  in.string(data.password);
+  return Event{EventType::LOBBY_JOIN_REQUEST, std::move(data)};
 }
 
-Event DecodeBOSS_UPDATE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::BOSS_UPDATE;
-
-  BOSS_UPDATE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.bossId, &packet[offset], sizeof(data.bossId));
-  data.bossId = ntohs(data.bossId);
-  offset += sizeof(data.bossId);
-
-  uint32_t temp;
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.posX, &temp, sizeof(data.posX));
-  offset += sizeof(temp);
-
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.posY, &temp, sizeof(data.posY));
-  offset += sizeof(temp);
-
-  memcpy(&data.hp, &packet[offset], sizeof(data.hp));
-  data.hp = ntohs(data.hp);
-  offset += sizeof(data.hp);
-
-  data.phase = packet[offset++];
-  data.action = packet[offset++];
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeENEMY_HIT(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::ENEMY_HIT;
-
-  ENEMY_HIT data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.enemyId, &packet[offset], sizeof(data.enemyId));
-  data.enemyId = ntohs(data.enemyId);
-  offset += sizeof(data.enemyId);
-
-  data.damage = packet[offset++];
-
-  memcpy(&data.hpRemaining, &packet[offset], sizeof(data.hpRemaining));
-  data.hpRemaining = ntohs(data.hpRemaining);
-  offset += sizeof(data.hpRemaining);
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeFORCE_STATE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::FORCE_STATE;
-
-  FORCE_STATE data;
-  size_t offset = 2;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.forceId, &packet[offset], sizeof(data.forceId));
-  data.forceId = ntohs(data.forceId);
-  offset += sizeof(data.forceId);
-
-  memcpy(&data.ownerId, &packet[offset], sizeof(data.ownerId));
-  data.ownerId = ntohs(data.ownerId);
-  offset += sizeof(data.ownerId);
-
-  uint32_t temp;
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.posX, &temp, sizeof(data.posX));
-  offset += sizeof(temp);
-
-  memcpy(&temp, &packet[offset], sizeof(temp));
-  temp = ntohl(temp);
-  memcpy(&data.posY, &temp, sizeof(data.posY));
-  offset += sizeof(temp);
-
-  data.state = packet[offset++];
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeLOBBY_CREATE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_CREATE;
-
-  LOBBY_CREATE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  uint8_t lobbyNameLen = packet[offset++];
-  data.lobbyName =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), lobbyNameLen);
-  offset += lobbyNameLen;
-
-  uint8_t playerNameLen = packet[offset++];
-  data.playerName = std::string(reinterpret_cast<const char*>(&packet[offset]),
-                                playerNameLen);
-  offset += playerNameLen;
-
-  uint8_t passwordLen = packet[offset++];
-  data.password =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), passwordLen);
-  offset += passwordLen;
-
-  data.Maxplayer = packet[offset++];
-  data.difficulty = packet[offset++];
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeLOBBY_JOIN_REQUEST(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_JOIN_REQUEST;
-  LOBBY_JOIN_REQUEST data;
-
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  if (packet.size() < offset + 2) return evt;
-
-  uint16_t rawId;
-  memcpy(&rawId, &packet[offset], 2);
-  data.lobbyId = ntohs(rawId);
-  offset += 2;
-
-  if (packet.size() < offset + 1) return evt;
-  uint8_t nameLen = packet[offset++];
-  if (nameLen > 0 && (offset + nameLen <= packet.size())) {
-    data.name =
-        std::string(reinterpret_cast<const char*>(&packet[offset]), nameLen);
-    offset += nameLen;
-  }
-
-  if (packet.size() < offset + 1) return evt;
-  uint8_t passwordLen = packet[offset++];
-  if (passwordLen > 0 && (offset + passwordLen <= packet.size())) {
-    data.password = std::string(reinterpret_cast<const char*>(&packet[offset]),
-                                passwordLen);
-    offset += passwordLen;
-  }
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeLOBBY_JOIN_RESPONSE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_JOIN_RESPONSE;
-
-  LOBBY_JOIN_RESPONSE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.success = packet[offset++];
+Event DecodeLOBBY_JOIN_RESPONSE(PacketReader& in) {
+  LOBBY_JOIN_RESPONSE data{};
+  in.u8(data.success);
 
   if (data.success == 1) {
-    memcpy(&data.lobbyId, &packet[offset], sizeof(data.lobbyId));
-    data.lobbyId = ntohs(data.lobbyId);
-    offset += sizeof(data.lobbyId);
+    in.u16(data.lobbyId);
+    in.u16(data.playerId);
 
-    memcpy(&data.playerId, &packet[offset], sizeof(data.playerId));
-    data.playerId = ntohs(data.playerId);
-    offset += sizeof(data.playerId);
-
-    uint8_t playerCount = packet[offset++];
+    uint8_t playerCount = 0;
+    in.u8(playerCount);
     data.players.reserve(playerCount);
-
-    for (uint8_t i = 0; i < playerCount; ++i) {
-      LOBBY_JOIN_RESPONSE::Player player;
-
-      memcpy(&player.playerId, &packet[offset], sizeof(player.playerId));
-      player.playerId = ntohs(player.playerId);
-      offset += sizeof(player.playerId);
-
-      player.ready = packet[offset++] == 1;
-
-      uint8_t usernameLen = packet[offset++];
-      player.username = std::string(
-          reinterpret_cast<const char*>(&packet[offset]), usernameLen);
-      offset += usernameLen;
-
-      data.players.push_back(player);
+    for (uint8_t i = 0; i < playerCount && in.ok(); ++i) {
+      LOBBY_JOIN_RESPONSE::Player player{};
+      in.u16(player.playerId);
+      in.flag(player.ready);
+      in.string(player.username);
+      data.players.push_back(std::move(player));
     }
   } else {
-    memcpy(&data.errorCode, &packet[offset], sizeof(data.errorCode));
-    data.errorCode = ntohs(data.errorCode);
-    offset += sizeof(data.errorCode);
-
-    uint8_t msgLen = packet[offset++];
-    data.errorMessage =
-        std::string(reinterpret_cast<const char*>(&packet[offset]), msgLen);
-    offset += msgLen;
+    in.u16(data.errorCode);
+    in.string(data.errorMessage);
   }
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::LOBBY_JOIN_RESPONSE, std::move(data)};
 }
 
-Event DecodeLOBBY_LIST_RESPONSE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_LIST_RESPONSE;
-
+Event DecodeLOBBY_LIST_RESPONSE(PacketReader& in) {
   LOBBY_LIST_RESPONSE data;
-  size_t offset = 0;
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  uint8_t lobbyCount = packet[offset++];
+  uint8_t lobbyCount = 0;
+  in.u8(lobbyCount);
   data.lobbies.reserve(lobbyCount);
 
-  for (uint8_t i = 0; i < lobbyCount; ++i) {
-    Lobbies lobby;
-
-    memcpy(&lobby.lobbyId, &packet[offset], sizeof(lobby.lobbyId));
-    lobby.lobbyId = ntohs(lobby.lobbyId);
-    offset += sizeof(lobby.lobbyId);
-
-    uint8_t nameLen = packet[offset++];
-    lobby.name =
-        std::string(reinterpret_cast<const char*>(&packet[offset]), nameLen);
-    offset += nameLen;
-
-    lobby.playerCount = packet[offset++];
-    lobby.maxPlayers = packet[offset++];
-    lobby.difficulty = packet[offset++];
-    lobby.isStarted = (packet[offset++] == 1);
-    lobby.hasPassword = (packet[offset++] == 1);
-
-    data.lobbies.push_back(lobby);
+  for (uint8_t i = 0; i < lobbyCount && in.ok(); ++i) {
+    Lobbies lobby{};
+    in.u16(lobby.lobbyId);
+    in.string(lobby.name);
+    in.u8(lobby.playerCount);
+    in.u8(lobby.maxPlayers);
+    in.u8(lobby.difficulty);
+    in.flag(lobby.isStarted);
+    in.flag(lobby.hasPassword);
+    data.lobbies.push_back(std::move(lobby));
   }
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodePLAYER_READY(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::PLAYER_READY;
-
-  PLAYER_READY data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.ready = packet[offset++] == 1;
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::LOBBY_LIST_RESPONSE, std::move(data)};
 }
 
-Event DecodeLOBBY_UPDATE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_UPDATE;
-
-  LOBBY_UPDATE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  uint8_t nameLen = packet[offset++];
-  data.name =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), nameLen);
-  offset += nameLen;
-
-  memcpy(&data.hostId, &packet[offset], sizeof(data.hostId));
-  data.hostId = ntohs(data.hostId);
-  offset += sizeof(data.hostId);
+Event DecodeLOBBY_UPDATE(PacketReader& in) {
+  LOBBY_UPDATE data{};
+  in.string(data.name);
+  in.u16(data.hostId);
+  in.flag(data.asStarted);
+  in.u8(data.maxPlayers);
+  in.u8(data.difficulty);
 
-  data.asStarted = (packet[offset++] == 1);
-  data.maxPlayers = packet[offset++];
-  data.difficulty = packet[offset++];
-
-  uint8_t playerCount = packet[offset++];
+  uint8_t playerCount = 0;
+  in.u8(playerCount);
   data.playerInfo.reserve(playerCount);
-
-  for (uint8_t i = 0; i < playerCount; ++i) {
-    PlayerInfo player;
-
-    memcpy(&player.playerId, &packet[offset], sizeof(player.playerId));
-    player.playerId = ntohs(player.playerId);
-    offset += sizeof(player.playerId);
-
-    player.ready = (packet[offset++] == 1);
-
-    uint8_t usernameLen = packet[offset++];
-    player.username = std::string(
-        reinterpret_cast<const char*>(&packet[offset]), usernameLen);
-    offset += usernameLen;
-
-    data.playerInfo.push_back(player);
+  for (uint8_t i = 0; i < playerCount && in.ok(); ++i) {
+    PlayerInfo player{};
+    in.u16(player.playerId);
+    in.flag(player.ready);
+    in.string(player.username);
+    data.playerInfo.push_back(std::move(player));
   }
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeLOBBY_KICK(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_KICK;
-
-  LOBBY_KICK data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.playerId, &packet[offset], sizeof(data.playerId));
-  data.playerId = ntohs(data.playerId);
-  offset += sizeof(data.playerId);
-
-  evt.data = data;
-  return evt;
+  return Event{EventType::LOBBY_UPDATE, std::move(data)};
 }
 
-Event DecodeLOBBY_START(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_START;
-
-  LOBBY_START data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.countdown = packet[offset++];
-
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeLOBBY_LIST_REQUEST(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_LIST_REQUEST;
-  LOBBY_LIST_REQUEST data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.playerId, &packet[offset], 2);
-  data.playerId = ntohs(data.playerId);
-
-  evt.data = data;
-  return evt;
+Event DecodeMAP_DATA(PacketReader& in) {
+  using S = protocol::MapHeaderSchema;
+  MAP_DATA data{};
+  if (const uint8_t* header = in.block(schema::SIZE<S, MAP_DATA>)) {
+    schema::read<S>(header, data);
+  }
+  // Le reste de la charge utile est la grille de tuiles
+  in.raw(data.tiles, in.remaining());
+  return Event{EventType::SEND_MAP, std::move(data)};
 }
 
-Event DecodeLOBBY_LEAVE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LOBBY_LEAVE;
-  LOBBY_LEAVE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.playerId, &packet[offset], 2);
-  data.playerId = ntohs(data.playerId);
-
-  evt.data = data;
-  return evt;
+Event DecodeMESSAGE(PacketReader& in) {
+  MESSAGE data{};
+  in.u16(data.lobbyId);
+  in.string(data.playerName);
+  in.string(data.message);
+  return Event{EventType::MESSAGE, std::move(data)};
 }
 
-Event DecodeMAP_DATA(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::SEND_MAP;
-  MAP_DATA data;
-  size_t offset = 2;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.width, &packet[offset], sizeof(uint16_t));
-  data.width = ntohs(data.width);
-  offset += sizeof(uint16_t);
-  memcpy(&data.height, &packet[offset], sizeof(uint16_t));
-  data.height = ntohs(data.height);
-
-  offset += sizeof(uint16_t);
-  uint32_t temp;
-  memcpy(&temp, &packet[offset], sizeof(uint32_t));
-  temp = ntohl(temp);
-  memcpy(&data.scrollSpeed, &temp, sizeof(float));
-  offset += sizeof(float);
-  uint32_t tilesSize = payloadLength - 8;
-  if (tilesSize > 0) {
-    data.tiles.resize(tilesSize);
-    memcpy(data.tiles.data(), &packet[offset], tilesSize);
+namespace {
+
+/**
+ * @brief Decode a fixed-size message as one block, from its schema
+ */
+template <typename S>
+Event DecodeFixed(PacketReader& in) {
+  typename S::Received data{};
+  if (const uint8_t* bytes =
+          in.block(schema::SIZE<S, typename S::Received>)) {
+    schema::read<S>(bytes, data);
   }
-  evt.data = data;
-  return evt;
-}
-
-Event DecodeMESSAGE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::MESSAGE;
-
-  MESSAGE data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.lobbyId, &packet[offset], sizeof(data.lobbyId));
-  data.lobbyId = ntohs(data.lobbyId);
-  offset += sizeof(data.lobbyId);
-
-  uint8_t nameLen = packet[offset++];
-  data.playerName =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), nameLen);
-  offset += nameLen;
-
-  uint8_t msgLen = packet[offset++];
-  data.message =
-      std::string(reinterpret_cast<const char*>(&packet[offset]), msgLen);
-  offset += msgLen;
-
-  evt.data = data;
-  return evt;
+  return Event{S::PACKET, data};
 }
 
-Event DecodeCLIENT_LEAVE(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::CLIENT_LEAVE;
-
-  CLIENT_LEAVE data;
-  size_t offset = 2;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  memcpy(&data.playerId, &packet[offset], sizeof(data.playerId));
-  data.playerId = ntohs(data.playerId);
-  offset += sizeof(data.playerId);
-
-  evt.data = data;
-  return evt;
+template <typename... S>
+void RegisterFixed(Decoder& decoder) {
+  (decoder.registerHandler(S::PACKET, DecodeFixed<S>), ...);
 }
 
-Event DecodeLEVEL_TRANSITION(const std::vector<uint8_t>& packet) {
-  Event evt;
-  evt.type = EventType::LEVEL_TRANSITION;
-
-  LEVEL_TRANSITION data;
-  size_t offset = 0;
-
-  uint32_t payloadLength = 0;
-  uint16_t seq = 0;
-  uint16_t ack = 0;
-  uint32_t ack_bits = 0;
-
-  if (!checkHeader(packet, offset, payloadLength, seq, ack, ack_bits))
-    return Event{};
-
-  evt.seqNum = seq;
-  evt.ack = ack;
-  evt.ack_bits = ack_bits;
-
-  data.levelNumber = packet[offset++];
-
-  evt.data = data;
-  return evt;
-}
+}  // namespace
 
 void SetupDecoder(Decoder& decoder) {
-  // TCP Messages
-  decoder.registerHandler(0x01, DecodeLOGIN_REQUEST);
-  decoder.registerHandler(0x02, DecodeLOGIN_RESPONSE);
-  decoder.registerHandler(0x0F, DecodeGAME_START);
-  decoder.registerHandler(0x10, DecodeGAME_END);
-  decoder.registerHandler(0x11, DecodeCLIENT_LEAVE);
-  decoder.registerHandler(0x12, DecodeERROR);
-
-  decoder.registerHandler(0x03, DecodeLOBBY_CREATE);
-  decoder.registerHandler(0x04, DecodeLOBBY_JOIN_REQUEST);
-  decoder.registerHandler(0x05, DecodeLOBBY_JOIN_RESPONSE);
-  decoder.registerHandler(0x06, DecodeLOBBY_LIST_REQUEST);
-  decoder.registerHandler(0x07, DecodeLOBBY_LIST_RESPONSE);
-  decoder.registerHandler(0x08, DecodePLAYER_READY);
-  decoder.registerHandler(0x09, DecodeLOBBY_UPDATE);
-  decoder.registerHandler(0x0A, DecodeLOBBY_LEAVE);
-  decoder.registerHandler(0x0B, DecodeLOBBY_START);
-  decoder.registerHandler(0x0C, DecodeMESSAGE);
-  decoder.registerHandler(0x0D, DecodeLOBBY_KICK);
-  decoder.registerHandler(0x0E, DecodeMAP_DATA);
-  // UDP Messages
-  decoder.registerHandler(0x20, DecodePLAYER_INPUT);
-  decoder.registerHandler(0x21, DecodeGAME_STATE);
-  decoder.registerHandler(0x22, DecodeAUTH);
-  decoder.registerHandler(0x23, DecodeBOSS_SPAWN);
-  decoder.registerHandler(0x24, DecodeBOSS_UPDATE);
-  decoder.registerHandler(0x25, DecodeENEMY_HIT);
-  decoder.registerHandler(0x26, DecodeFORCE_STATE);
-  decoder.registerHandler(0x27, DecodeLEVEL_TRANSITION);
+  using namespace protocol;  // NOLINT(build/namespaces)
+
+  // Messages de taille fixe, generes depuis leur schema (Protocol.hpp)
+  RegisterFixed<AuthSchema, PlayerInputSchema, BossSpawnSchema,
+                BossUpdateSchema, EnemyHitSchema, ForceStateSchema,
+                GameStartSchema, PlayerReadySchema, LobbyStartSchema,
+                LobbyListRequestSchema, LobbyLeaveSchema, LobbyKickSchema,
+                ClientLeaveSchema, AssetsReadySchema, LevelTransitionSchema>(
+      decoder);
+
+  // Messages de taille variable
+  decoder.registerHandler(EventType::LOGIN_REQUEST, DecodeLOGIN_REQUEST);
+  decoder.registerHandler(EventType::LOGIN_RESPONSE, DecodeLOGIN_RESPONSE);
+  decoder.registerHandler(EventType::GAME_END, DecodeGAME_END);
+  decoder.registerHandler(EventType::ERROR_TYPE, DecodeERROR);
+  decoder.registerHandler(EventType::LOBBY_CREATE, DecodeLOBBY_CREATE);
+  decoder.registerHandler(EventType::LOBBY_JOIN_REQUEST,
+                          DecodeLOBBY_JOIN_REQUEST);
+  decoder.registerHandler(EventType::LOBBY_JOIN_RESPONSE,
+                          DecodeLOBBY_JOIN_RESPONSE);
+  decoder.registerHandler(EventType::LOBBY_LIST_RESPONSE,
+                          DecodeLOBBY_LIST_RESPONSE);
+  decoder.registerHandler(EventType::LOBBY_UPDATE, DecodeLOBBY_UPDATE);
+  decoder.registerHandler(EventType::MESSAGE, DecodeMESSAGE);
+  decoder.registerHandler(EventType::SEND_MAP, DecodeMAP_DATA);
+  decoder.registerHandler(EventType::GAME_STATE, DecodeGAME_STATE);
+  decoder.registerHandler(EventType::GAME_STATE_PACKED,
+                          DecodeGAME_STATE_PACKED);
 }
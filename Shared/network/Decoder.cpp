@@ -1,6 +1,6 @@
 #include "network/Decoder.hpp"
 
-#include <vector>
+#include <variant>
 
 Decoder::Decoder() { handlers.fill(nullptr); }
 
@@ -8,7 +8,7 @@ void Decoder::registerHandler(uint8_t packetType, DecodeFunc func) {
   handlers[packetType] = func;
 }
 
-Event Decoder::decode(const std::vector<uint8_t>& packet) {
+Event Decoder::decode(ByteView packet) {
   if (packet.empty()) {
     return Event{};
   }
@@ -18,5 +18,33 @@ Event Decoder::decode(const std::vector<uint8_t>& packet) {
   if (!handlers[type]) {
     return Event{};
   }
-  return handlers[type](packet);
+
+  // En-tete lu une seule fois ici, les handlers ne voient que la charge utile
+  PacketReader header(packet);
+  uint8_t flags = 0;
+  uint32_t payloadLength = 0;
+  uint16_t seq = 0;
+  uint16_t ack = 0;
+  uint32_t ack_bits = 0;
+  header.u8(type);
+  header.u8(flags);
+  header.u32(payloadLength);
+  if ((flags & 0x02) || (flags & 0x08)) {
+    header.u16(seq);
+    header.u16(ack);
+    header.u32(ack_bits);
+  }
+  if (!header.ok() || header.remaining() != payloadLength) {
+    return Event{};
+  }
+
+  PacketReader payload(ByteView(header.data(), payloadLength));
+  Event evt = handlers[type](payload);
+  if (!payload.ok() || std::holds_alternative<std::monostate>(evt.data)) {
+    return Event{};
+  }
+  evt.seqNum = seq;
+  evt.ack = ack;
+  evt.ack_bits = ack_bits;
+  return evt;
 }
@@ -2,19 +2,31 @@
 
 #include <array>
 #include <cstdint>
-#include <functional>
-#include <vector>
 
+#include "network/ByteView.hpp"
 #include "network/Event.hpp"
+#include "network/PacketReader.hpp"
 
 class Decoder {
  public:
-  using DecodeFunc = std::function<Event(const std::vector<uint8_t>&)>;
+  /**
+   * @brief Decodes the payload of one packet type; the reader stops at the
+   * end of the payload and a read past it rejects the packet
+   */
+  using DecodeFunc = Event (*)(PacketReader&);
 
   Decoder();
 
   void registerHandler(uint8_t packetType, DecodeFunc func);
-  Event decode(const std::vector<uint8_t>& packet);
+  void registerHandler(EventType packetType, DecodeFunc func) {
+    registerHandler(static_cast<uint8_t>(packetType), func);
+  }
+
+  /**
+   * @brief Check the header, then decode the payload with its handler
+   * @return Event{} if the packet is unknown, truncated or malformed
+   */
+  Event decode(ByteView packet);
 
  private:
   std::array<DecodeFunc, 256> handlers;
@@ -6,9 +6,11 @@
 #include <arpa/inet.h>
 #endif
 
+#include <cstring>
 #include <vector>
 
 #include "network/Encoder.hpp"
+#include "network/Protocol.hpp"
 
 Encoder::Encoder() { handlers.fill(nullptr); }
 
@@ -16,130 +18,76 @@ void Encoder::registerHandler(ActionType type, EncodePayload f) {
   handlers[static_cast<uint8_t>(type)] = f;
 }
 
-inline uint8_t getType(const Action& a) {
-  switch (a.type) {
-    case ActionType::LOGIN_REQUEST:
-      return 0x01;
-    case ActionType::LOGIN_RESPONSE:
-      return 0x02;
-    case ActionType::LOBBY_CREATE:
-      return 0x03;
-    case ActionType::LOBBY_JOIN_REQUEST:
-      return 0x04;
-    case ActionType::LOBBY_JOIN_RESPONSE:
-      return 0x05;
-    case ActionType::LOBBY_LIST_REQUEST:
-      return 0x06;
-    case ActionType::LOBBY_LIST_RESPONSE:
-      return 0x07;
-    case ActionType::PLAYER_READY:
-      return 0x08;
-    case ActionType::LOBBY_UPDATE:
-      return 0x09;
-    case ActionType::LOBBY_LEAVE:
-      return 0x0A;
-    case ActionType::LOBBY_START:
-      return 0x0B;
-    case ActionType::MESSAGE:
-      return 0x0C;
-    case ActionType::LOBBY_KICK:
-      return 0x0D;
-    case ActionType::SEND_MAP:
-      return 0x0E;
-    case ActionType::GAME_START:
-      return 0x0F;
-    case ActionType::GAME_END:
-      return 0x10;
-    case ActionType::CLIENT_LEAVE:
-      return 0x11;
-    case ActionType::ERROR_SERVER:
-      return 0x12;
-
-    case ActionType::UP_PRESS:
-    case ActionType::UP_RELEASE:
-    case ActionType::DOWN_PRESS:
-    case ActionType::DOWN_RELEASE:
-    case ActionType::LEFT_PRESS:
-    case ActionType::LEFT_RELEASE:
-    case ActionType::RIGHT_PRESS:
-    case ActionType::RIGHT_RELEASE:
-    case ActionType::FIRE_PRESS:
-    case ActionType::FIRE_RELEASE:
-      return 0x20;
-
-    case ActionType::GAME_STATE:
-      return 0x21;
-    case ActionType::AUTH:
-      return 0x22;
-    case ActionType::BOSS_SPAWN:
-      return 0x23;
-    case ActionType::BOSS_UPDATE:
-      return 0x24;
-    case ActionType::ENEMY_HIT:
-      return 0x25;
-    case ActionType::FORCE_STATE:
-      return 0x26;
-    case ActionType::LEVEL_TRANSITION:
-      return 0x27;
-
-    default:
-      return 0xFF;
-  }
-}
-
 std::vector<uint8_t> Encoder::encode(const Action& a, size_t useUDP,
                                      uint16_t seqNum, uint16_t ack,
                                      uint32_t ack_bytes) {
-  auto& func = handlers[static_cast<uint8_t>(a.type)];
-  if (!func) return {};
-
-  std::vector<uint8_t> payload;
-  payload.reserve(64);
-  func(a, payload);
-
-  size_t headerSize = (useUDP == 0 || useUDP == 1) ? 14 : 6;
+  return encode(a, a.type, useUDP, seqNum, ack, ack_bytes);
+}
 
+std::vector<uint8_t> Encoder::encode(const Action& a, ActionType as,
+                                     size_t useUDP, uint16_t seqNum,
+                                     uint16_t ack, uint32_t ack_bytes) {
   std::vector<uint8_t> packet;
-  packet.reserve(headerSize + payload.size());
+  packet.reserve(64);
+  if (!encodeInto(a, as, useUDP, seqNum, ack, ack_bytes, packet)) return {};
+  return packet;
+}
 
-  PacketHeader header;
-  header.type = getType(a);
-  header.flags = 0;
+bool Encoder::encodeInto(const Action& a, ActionType as, size_t useUDP,
+                         uint16_t seqNum, uint16_t ack, uint32_t ack_bytes,
+                         std::vector<uint8_t>& packet) {
+  // Les handlers ecrivent la charge utile depuis le debut du buffer ;
+  // l'en-tete est insere devant, dans la capacite deja reservee
+  packet.clear();
+  if (!encodePayload(a, as, packet)) return false;
+
+  Header header;
+  size_t headerSize =
+      writeHeader(header, as, useUDP, static_cast<uint32_t>(packet.size()),
+                  seqNum, ack, ack_bytes);
+  packet.insert(packet.begin(), header.begin(), header.begin() + headerSize);
+  return true;
+}
 
-  if (useUDP == 0) header.flags |= 0x02;
-  if (useUDP == 1) header.flags |= 0x08;
-  if (useUDP == 2) header.flags |= 0x01;
+bool Encoder::encodePayload(const Action& a, ActionType as,
+                            std::vector<uint8_t>& payload) {
+  auto& func = handlers[static_cast<uint8_t>(as)];
+  if (!func) return false;
+  func(a, payload);
+  return true;
+}
 
-  header.length = static_cast<uint32_t>(payload.size());
-  header.seqNum = seqNum;
-  header.ack = ack;
-  header.ack_bytes = ack_bytes;
+size_t Encoder::writeHeader(Header& out, ActionType as, size_t useUDP,
+                            uint32_t length, uint16_t seqNum, uint16_t ack,
+                            uint32_t ack_bytes) {
+  PacketHeader h;
+  h.type = static_cast<uint8_t>(protocol::packetType(as));
+  h.flags = 0;
 
-  writeHeader(packet, header);
-  packet.insert(packet.end(), payload.begin(), payload.end());
+  if (useUDP == 0) h.flags |= 0x02;
+  if (useUDP == 1) h.flags |= 0x08;
+  if (useUDP == 2) h.flags |= 0x01;
 
-  return packet;
-}
+  h.length = length;
+  h.seqNum = seqNum;
+  h.ack = ack;
+  h.ack_bytes = ack_bytes;
+
+  out[0] = h.type;
+  out[1] = h.flags;
 
-void Encoder::writeHeader(std::vector<uint8_t>& packet, const PacketHeader& h) {
-  packet.push_back(h.type);
-  packet.push_back(h.flags);
+  uint32_t len = htonl(h.length);
+  memcpy(&out[2], &len, 4);
 
-  uint32_t length = htonl(h.length);
-  const uint8_t* pLen = reinterpret_cast<const uint8_t*>(&length);
-  packet.insert(packet.end(), pLen, pLen + 4);
+  if (!(h.flags & 0x02) && !(h.flags & 0x08)) return TCP_HEADER_SIZE;
 
-  if ((h.flags & 0x02) || (h.flags & 0x08)) {
-    uint16_t s = htons(h.seqNum);
-    const uint8_t* pSeq = reinterpret_cast<const uint8_t*>(&s);
-    packet.insert(packet.end(), pSeq, pSeq + 2);
+  uint16_t s = htons(h.seqNum);
+  memcpy(&out[6], &s, 2);
 
-    uint16_t a = htons(h.ack);
-    const uint8_t* pAck = reinterpret_cast<const uint8_t*>(&a);
-    packet.insert(packet.end(), pAck, pAck + 2);
+  uint16_t ak = htons(h.ack);
+  memcpy(&out[8], &ak, 2);
 
-    uint32_t ab = htonl(h.ack_bytes);
-    const uint8_t* pAb = reinterpret_cast<const uint8_t*>(&ab);
-    packet.insert(packet.end(), pAb, pAb + 4);
-  }
+  uint32_t ab = htonl(h.ack_bytes);
+  memcpy(&out[10], &ab, 4);
+  return UDP_HEADER_SIZE;
 }
@@ -1,9 +1,14 @@
 #include "network/EncodeFunc.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
+#include "network/BitStream.hpp"
 #include "network/DataMask.hpp"
+#include "network/Protocol.hpp"
+#include "network/Schema.hpp"
 
 void htonf(float value, uint8_t* out) {
   uint32_t asInt;
@@ -13,25 +18,6 @@ void htonf(float value, uint8_t* out) {
   std::memcpy(out, &asInt, sizeof(uint32_t));
 }
 
-void Auth(const Action& a, std::vector<uint8_t>& out) {
-  const auto* auth = std::get_if<AuthUDP>(&a.data);
-  if (!auth) return;
-  out.resize(2);
-  uint16_t playerId = htons(auth->playerId);
-  memcpy(out.data(), &playerId, sizeof(uint16_t));
-}
-
-void PlayerInputFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* input = std::get_if<PlayerInput>(&a.data);
-  if (!input) return;
-  out.resize(5);
-  out[0] = input->up ? 1 : 0;
-  out[1] = input->down ? 1 : 0;
-  out[2] = input->left ? 1 : 0;
-  out[3] = input->right ? 1 : 0;
-  out[4] = input->fire;
-}
-
 void LoginRequestFunc(const Action& a, std::vector<uint8_t>& out) {
   const auto* login = std::get_if<LoginReq>(&a.data);
   if (!login) return;
@@ -48,6 +34,8 @@ void LoginRequestFunc(const Action& a, std::vector<uint8_t>& out) {
   out[offset++] = passwordLen;
   out.resize(offset + passwordLen);
   memcpy(out.data() + offset, login->passwordHash.data(), passwordLen);
+  offset += passwordLen;
+  out.push_back(login->features);
 }
 
 void GameStateFunc(const Action& a, std::vector<uint8_t>& out) {
@@ -57,6 +45,17 @@ void GameStateFunc(const Action& a, std::vector<uint8_t>& out) {
 
   uint8_t buffer2[2];
 
+  // TICK
+  uint32_t tick = htonl(state->tick);
+  uint8_t buffer4[4];
+  memcpy(buffer4, &tick, 4);
+  out.insert(out.end(), buffer4, buffer4 + 4);
+
+  // TICK DE REFERENCE
+  uint32_t baseTick = htonl(state->baseTick);
+  memcpy(buffer4, &baseTick, 4);
+  out.insert(out.end(), buffer4, buffer4 + 4);
+
   // JOUEURS
   out.push_back(static_cast<uint8_t>(state->players.size()));
   for (const auto& p : state->players) {
@@ -149,63 +148,91 @@ void GameStateFunc(const Action& a, std::vector<uint8_t>& out) {
   }
 }
 
-void BossSpawnFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* boss = std::get_if<BossSpawn>(&a.data);
-  if (!boss) return;
-  out.resize(6);
-  size_t offset = 0;
-  uint16_t bossId = htons(boss->bossId);
-  memcpy(out.data() + offset, &bossId, sizeof(uint16_t));
-  offset += 2;
-  out[offset++] = boss->bossType;
-  uint16_t maxHp = htons(boss->maxHp);
-  memcpy(out.data() + offset, &maxHp, sizeof(uint16_t));
-  offset += 2;
-  out[offset++] = boss->phase;
-}
+void GameStatePackedFunc(const Action& a, std::vector<uint8_t>& out) {
+  const auto* state = std::get_if<GameState>(&a.data);
+  if (!state) return;
+  out.clear();
+  BitWriter w(out);
 
-void BossUpdateFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* boss = std::get_if<BossUpdate>(&a.data);
-  if (!boss) return;
-  out.resize(14);
-  size_t offset = 0;
-  uint16_t bossId = htons(boss->bossId);
-  memcpy(out.data() + offset, &bossId, sizeof(uint16_t));
-  offset += 2;
-  htonf(boss->posX, out.data() + offset);
-  offset += 4;
-  htonf(boss->posY, out.data() + offset);
-  offset += 4;
-  uint16_t hp = htons(boss->hp);
-  memcpy(out.data() + offset, &hp, sizeof(uint16_t));
-  offset += 2;
-  out[offset++] = boss->phase;
-  out[offset++] = boss->action;
-}
+  // TICK, puis l'age de la reference (0 : etat complet)
+  w.write(state->tick, 32);
+  w.writeVarint(state->tick - state->baseTick);
 
-void EnemyHitFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* hit = std::get_if<EnemyHit>(&a.data);
-  if (!hit) return;
-  out.resize(5);
-  size_t offset = 0;
-  uint16_t enemyId = htons(hit->enemyId);
-  memcpy(out.data() + offset, &enemyId, sizeof(uint16_t));
-  offset += 2;
-  out[offset++] = hit->damage;
-  uint16_t hp = htons(hit->hpRemaining);
-  memcpy(out.data() + offset, &hp, sizeof(uint16_t));
-}
+  auto writePos = [&](uint16_t mask, float x, float y) {
+    if (mask & M_POS_X) {
+      w.write(quant::quantize(x, quant::POS_X_MIN, quant::POS_X_RANGE,
+                              quant::POS_X_BITS),
+              quant::POS_X_BITS);
+    }
+    if (mask & M_POS_Y) {
+      w.write(quant::quantize(y, quant::POS_Y_MIN, quant::POS_Y_RANGE,
+                              quant::POS_Y_BITS),
+              quant::POS_Y_BITS);
+    }
+  };
+
+  // Id en ecart avec l'entree precedente et masque, chacun precede d'un
+  // bit : id suivant / meme masque que l'entree precedente
+  int32_t prevId = 0;
+  uint16_t prevMask = 0;
+  auto writeId = [&](uint16_t id, uint16_t mask) {
+    int32_t delta = static_cast<int32_t>(id) - prevId;
+    w.write(delta == 1, 1);
+    if (delta != 1) w.writeSigned(delta);
+    prevId = id;
+    w.write(mask == prevMask, 1);
+    if (mask != prevMask) w.writeVarint(mask);
+    prevMask = mask;
+  };
 
-void GameStartFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* start = std::get_if<GameStart>(&a.data);
-  if (!start) return;
-  out.resize(12);
-  size_t offset = 0;
-  htonf(start->playerSpawnX, out.data() + offset);
-  offset += 4;
-  htonf(start->playerSpawnY, out.data() + offset);
-  offset += 4;
-  htonf(start->scrollSpeed, out.data() + offset);
+  // JOUEURS
+  w.writeVarint(static_cast<uint32_t>(state->players.size()));
+  prevId = 0;
+  prevMask = 0;
+  for (const auto& p : state->players) {
+    writeId(p.playerId, p.mask);
+    writePos(p.mask, p.posX, p.posY);
+    if (p.mask & M_HP) w.write(p.hp, 8);
+    if (p.mask & M_STATE) w.write(p.state, 8);
+    if (p.mask & M_SHIELD) w.write(p.shield, 8);
+    if (p.mask & M_WEAPON) w.write(p.weapon, 8);
+    if (p.mask & M_SPRITE) w.write(p.sprite, 8);
+    if (p.mask & M_SCORE) w.writeVarint(p.score);
+  }
+
+  // ENNEMIS
+  w.writeVarint(static_cast<uint32_t>(state->enemies.size()));
+  prevId = 0;
+  prevMask = 0;
+  for (const auto& e : state->enemies) {
+    writeId(e.enemyId, e.mask);
+    writePos(e.mask, e.posX, e.posY);
+    if (e.mask & M_HP) w.write(e.hp, 8);
+    if (e.mask & M_STATE) w.write(e.state, 8);
+    if (e.mask & M_TYPE) w.write(e.enemyType, 8);
+    if (e.mask & M_DIR) w.write(static_cast<uint32_t>(e.direction + 1), 2);
+  }
+
+  // PROJECTILES
+  w.writeVarint(static_cast<uint32_t>(state->projectiles.size()));
+  prevId = 0;
+  prevMask = 0;
+  for (const auto& pr : state->projectiles) {
+    writeId(pr.projectileId, pr.mask);
+    writePos(pr.mask, pr.posX, pr.posY);
+    if (pr.mask & M_VELOCITY) {
+      w.write(quant::quantize(pr.velX, quant::VEL_MIN, quant::VEL_RANGE,
+                              quant::VEL_BITS),
+              quant::VEL_BITS);
+      w.write(quant::quantize(pr.velY, quant::VEL_MIN, quant::VEL_RANGE,
+                              quant::VEL_BITS),
+              quant::VEL_BITS);
+    }
+    if (pr.mask & M_TYPE) w.write(pr.type, 8);
+    if (pr.mask & M_OWNER) w.writeVarint(pr.ownerId);
+    if (pr.mask & M_DAMAGE) w.write(pr.damage, 8);
+  }
+  w.flush();
 }
 
 void GameEndFunc(const Action& a, std::vector<uint8_t>& out) {
@@ -396,13 +423,6 @@ void LobbyListResponseFunc(const Action& a, std::vector<uint8_t>& out) {
   }
 }
 
-void PlayerReadyFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* ready = std::get_if<PlayerReady>(&a.data);
-  if (!ready) return;
-  out.resize(1);
-  out[0] = ready->ready ? 1 : 0;
-}
-
 void LobbyUpdateFunc(const Action& a, std::vector<uint8_t>& out) {
   const auto* update = std::get_if<LobbyUpdate>(&a.data);
   if (!update) return;
@@ -442,48 +462,6 @@ void LobbyUpdateFunc(const Action& a, std::vector<uint8_t>& out) {
   }
 }
 
-void LobbyStartFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* start = std::get_if<LobbyStart>(&a.data);
-  if (!start) return;
-  out.resize(1);
-  out[0] = start->countdown;
-}
-
-void LobbyListRequestFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* req = std::get_if<LobbyListRequest>(&a.data);
-  if (!req) return;
-
-  out.clear();
-  uint16_t id = htons(req->playerId);
-  uint8_t buf[2];
-  memcpy(buf, &id, 2);
-  out.push_back(buf[0]);
-  out.push_back(buf[1]);
-}
-
-void LobbyLeaveFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* req = std::get_if<LobbyLeave>(&a.data);
-  if (!req) return;
-
-  out.clear();
-  uint16_t id = htons(req->playerId);
-  uint8_t buf[2];
-  memcpy(buf, &id, 2);
-  out.push_back(buf[0]);
-  out.push_back(buf[1]);
-}
-
-void LobbyKickFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* kick = std::get_if<LobbyKick>(&a.data);
-  if (!kick) return;
-
-  out.clear();
-  uint16_t pId = htons(kick->playerId);
-
-  out.resize(sizeof(uint16_t));
-  memcpy(out.data(), &pId, sizeof(uint16_t));
-}
-
 void MessageFunc(const Action& a, std::vector<uint8_t>& out) {
   const auto* msg = std::get_if<Message>(&a.data);
   if (!msg) return;
@@ -511,108 +489,85 @@ void MessageFunc(const Action& a, std::vector<uint8_t>& out) {
 }
 
 void MapDataFunc(const Action& a, std::vector<uint8_t>& out) {
+  using S = protocol::MapHeaderSchema;
   const auto* map = std::get_if<MapData>(&a.data);
   if (!map) return;
 
-  out.clear();
-
-  uint16_t w = htons(map->width);
-  uint8_t wBytes[2];
-  memcpy(wBytes, &w, 2);
-  out.insert(out.end(), wBytes, wBytes + 2);
-
-  uint16_t h = htons(map->height);
-  uint8_t hBytes[2];
-  memcpy(hBytes, &h, 2);
-  out.insert(out.end(), hBytes, hBytes + 2);
-
-  uint8_t speedBytes[4];
-  htonf(map->scrollSpeed, speedBytes);
-  out.insert(out.end(), speedBytes, speedBytes + 4);
-
-  if (!map->tiles.empty()) {
-    out.insert(out.end(), map->tiles.begin(), map->tiles.end());
-  }
+  constexpr size_t headerSize = schema::SIZE<S, const MapData>;
+  out.resize(headerSize + map->tiles.size());
+  schema::write<S>(out.data(), *map);
+  std::copy(map->tiles.begin(), map->tiles.end(), out.begin() + headerSize);
 }
 
-void ForceStateFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* force = std::get_if<ForceState>(&a.data);
-  if (!force) return;
-  out.resize(13);
-  size_t offset = 0;
-  uint16_t forceId = htons(force->forceId);
-
-  memcpy(out.data() + offset, &forceId, sizeof(uint16_t));
-  offset += 2;
-  uint16_t ownerId = htons(force->ownerId);
-  memcpy(out.data() + offset, &ownerId, sizeof(uint16_t));
-  offset += 2;
-  htonf(force->posX, out.data() + offset);
-  offset += 4;
-  htonf(force->posY, out.data() + offset);
-
-  offset += 4;
-  out[offset++] = force->state;
+namespace {
+
+/**
+ * @brief Encode a fixed-size message as one block, from its schema
+ */
+template <typename S>
+void EncodeFixed(const Action& a, std::vector<uint8_t>& out) {
+  static_assert(std::is_same_v<schema::Types<S, typename S::Sent>,
+                               schema::Types<S, typename S::Received>>,
+                "the sent and received fields must have the same types");
+  const auto* data = std::get_if<typename S::Sent>(&a.data);
+  if (!data) return;
+  out.resize(schema::SIZE<S, const typename S::Sent>);
+  schema::write<S>(out.data(), *data);
 }
 
-void ClientLeaveFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* leave = std::get_if<ClientLeave>(&a.data);
-  if (!leave) return;
-
-  out.clear();
-
-  uint16_t pId = htons(leave->playerId);
-
-  out.resize(sizeof(uint16_t));
-  memcpy(out.data(), &pId, sizeof(uint16_t));
+/**
+ * @brief Register a fixed-size message for actions that the type table
+ * sends as its packet type
+ */
+template <typename S, ActionType... Actions>
+void RegisterFixed(Encoder& encoder) {
+  static_assert(((protocol::packetType(Actions) == S::PACKET) && ...),
+                "action sent with another packet type than its schema");
+  (encoder.registerHandler(Actions, EncodeFixed<S>), ...);
 }
 
-void LevelTransitionFunc(const Action& a, std::vector<uint8_t>& out) {
-  const auto* trans = std::get_if<LevelTransition>(&a.data);
-  if (!trans) return;
-
-  out.clear();
-  out.push_back(trans->levelNumber);
-}
+}  // namespace
 
 void SetupEncoder(Encoder& encoder) {
-  encoder.registerHandler(ActionType::AUTH, Auth);
-  encoder.registerHandler(ActionType::LOBBY_LEAVE, LobbyLeaveFunc);
-  encoder.registerHandler(ActionType::LOBBY_LIST_REQUEST, LobbyListRequestFunc);
-  encoder.registerHandler(ActionType::ERROR_SERVER, ErrorFunc);
-  encoder.registerHandler(ActionType::GAME_START, GameStartFunc);
-  encoder.registerHandler(ActionType::GAME_END, GameEndFunc);
-  encoder.registerHandler(ActionType::UP_PRESS, PlayerInputFunc);
-  encoder.registerHandler(ActionType::UP_RELEASE, PlayerInputFunc);
-  encoder.registerHandler(ActionType::DOWN_PRESS, PlayerInputFunc);
-  encoder.registerHandler(ActionType::DOWN_RELEASE, PlayerInputFunc);
-  encoder.registerHandler(ActionType::LEFT_PRESS, PlayerInputFunc);
-  encoder.registerHandler(ActionType::LEFT_RELEASE, PlayerInputFunc);
-  encoder.registerHandler(ActionType::RIGHT_PRESS, PlayerInputFunc);
-  encoder.registerHandler(ActionType::RIGHT_RELEASE, PlayerInputFunc);
-  encoder.registerHandler(ActionType::FIRE_PRESS, PlayerInputFunc);
-  encoder.registerHandler(ActionType::FIRE_RELEASE, PlayerInputFunc);
+  using namespace protocol;  // NOLINT(build/namespaces)
+
+  // Messages de taille fixe, generes depuis leur schema (Protocol.hpp)
+  RegisterFixed<AuthSchema, ActionType::AUTH>(encoder);
+  RegisterFixed<PlayerInputSchema, ActionType::UP_PRESS,
+                ActionType::UP_RELEASE, ActionType::DOWN_PRESS,
+                ActionType::DOWN_RELEASE, ActionType::LEFT_PRESS,
+                ActionType::LEFT_RELEASE, ActionType::RIGHT_PRESS,
+                ActionType::RIGHT_RELEASE, ActionType::FIRE_PRESS,
+                ActionType::FIRE_RELEASE>(encoder);
+  RegisterFixed<BossSpawnSchema, ActionType::BOSS_SPAWN>(encoder);
+  RegisterFixed<BossUpdateSchema, ActionType::BOSS_UPDATE>(encoder);
+  RegisterFixed<EnemyHitSchema, ActionType::ENEMY_HIT>(encoder);
+  RegisterFixed<ForceStateSchema, ActionType::FORCE_STATE>(encoder);
+  RegisterFixed<GameStartSchema, ActionType::GAME_START>(encoder);
+  RegisterFixed<PlayerReadySchema, ActionType::PLAYER_READY>(encoder);
+  RegisterFixed<LobbyStartSchema, ActionType::LOBBY_START>(encoder);
+  RegisterFixed<LobbyListRequestSchema, ActionType::LOBBY_LIST_REQUEST>(
+      encoder);
+  RegisterFixed<LobbyLeaveSchema, ActionType::LOBBY_LEAVE>(encoder);
+  RegisterFixed<LobbyKickSchema, ActionType::LOBBY_KICK>(encoder);
+  RegisterFixed<ClientLeaveSchema, ActionType::CLIENT_LEAVE>(encoder);
+  RegisterFixed<AssetsReadySchema, ActionType::ASSETS_READY>(encoder);
+  RegisterFixed<LevelTransitionSchema, ActionType::LEVEL_TRANSITION>(encoder);
+
+  // Messages de taille variable
   encoder.registerHandler(ActionType::LOGIN_REQUEST, LoginRequestFunc);
   encoder.registerHandler(ActionType::LOGIN_RESPONSE, LoginResponseFunc);
+  encoder.registerHandler(ActionType::ERROR_SERVER, ErrorFunc);
+  encoder.registerHandler(ActionType::GAME_END, GameEndFunc);
   encoder.registerHandler(ActionType::GAME_STATE, GameStateFunc);
-  encoder.registerHandler(ActionType::BOSS_SPAWN, BossSpawnFunc);
-  encoder.registerHandler(ActionType::BOSS_UPDATE, BossUpdateFunc);
-  encoder.registerHandler(ActionType::ENEMY_HIT, EnemyHitFunc);
+  encoder.registerHandler(ActionType::GAME_STATE_PACKED, GameStatePackedFunc);
   encoder.registerHandler(ActionType::LOBBY_CREATE, LobbyCreateFunc);
-  encoder.registerHandler(ActionType::LOBBY_KICK, LobbyKickFunc);
-  encoder.registerHandler(ActionType::CLIENT_LEAVE, ClientLeaveFunc);
-  encoder.registerHandler(ActionType::FORCE_STATE, ForceStateFunc);
   encoder.registerHandler(ActionType::LOBBY_JOIN_REQUEST, LobbyJoinRequestFunc);
   encoder.registerHandler(ActionType::LOBBY_JOIN_RESPONSE,
                           LobbyJoinResponseFunc);
-  encoder.registerHandler(ActionType::SEND_MAP, MapDataFunc);
-  encoder.registerHandler(ActionType::LOBBY_LIST_REQUEST, LobbyListRequestFunc);
   encoder.registerHandler(ActionType::LOBBY_LIST_RESPONSE,
                           LobbyListResponseFunc);
-  encoder.registerHandler(ActionType::MESSAGE, MessageFunc);
-  encoder.registerHandler(ActionType::PLAYER_READY, PlayerReadyFunc);
   encoder.registerHandler(ActionType::LOBBY_UPDATE, LobbyUpdateFunc);
-  encoder.registerHandler(ActionType::LOBBY_LEAVE, LobbyLeaveFunc);
-  encoder.registerHandler(ActionType::LOBBY_START, LobbyStartFunc);
-  encoder.registerHandler(ActionType::LEVEL_TRANSITION, LevelTransitionFunc);
+  encoder.registerHandler(ActionType::MESSAGE, MessageFunc);
+  encoder.registerHandler(ActionType::SEND_MAP, MapDataFunc);
 }
@@ -32,8 +32,46 @@ class Encoder {
   void registerHandler(ActionType type, EncodePayload f);
   std::vector<uint8_t> encode(const Action& a, size_t useUDP, uint16_t seqNum,
                               uint16_t ack, uint32_t ack_bytes);
+  /**
+   * @brief Encode the data of an action with the handler and packet type of
+   * another, e.g. a GameState as GAME_STATE_PACKED
+   */
+  std::vector<uint8_t> encode(const Action& a, ActionType as, size_t useUDP,
+                              uint16_t seqNum, uint16_t ack,
+                              uint32_t ack_bytes);
+
+  /**
+   * @brief Encode a whole packet in place into a buffer that keeps its
+   * capacity, e.g. from a PacketPool: no allocation once it is big enough
+   * @param packet Replaced by the header followed by the payload
+   * @return false if no handler is registered for as
+   */
+  bool encodeInto(const Action& a, ActionType as, size_t useUDP,
+                  uint16_t seqNum, uint16_t ack, uint32_t ack_bytes,
+                  std::vector<uint8_t>& packet);
+
+  static constexpr size_t UDP_HEADER_SIZE = 14;
+  static constexpr size_t TCP_HEADER_SIZE = 6;
+  using Header = std::array<uint8_t, UDP_HEADER_SIZE>;
+
+  /**
+   * @brief Encode the payload of an action alone, so that the packets of
+   * several clients share it and only differ by their header
+   * @param as Handler and packet type to use, e.g. a.type
+   * @return false if no handler is registered for as
+   */
+  bool encodePayload(const Action& a, ActionType as,
+                     std::vector<uint8_t>& payload);
+
+  /**
+   * @brief Write the header of a packet whose payload is encoded apart
+   * @param length Payload size
+   * @return Header size, UDP_HEADER_SIZE over UDP, TCP_HEADER_SIZE over TCP
+   */
+  static size_t writeHeader(Header& out, ActionType as, size_t useUDP,
+                            uint32_t length, uint16_t seqNum, uint16_t ack,
+                            uint32_t ack_bytes);
 
  private:
   std::array<EncodePayload, 256> handlers;
-  void writeHeader(std::vector<uint8_t>& packet, const PacketHeader& h);
 };
@@ -11,6 +11,7 @@
 struct LOGIN_REQUEST {
   std::string username;
   std::string password;
+  uint8_t features = 0;  ///< LoginFeature bits, 0 for older clients
 };
 
 struct LOGIN_RESPONSE {
@@ -89,6 +90,8 @@ struct GAME_STATE {
     float velY;
     uint8_t damage;
   };
+  uint32_t tick = 0;
+  uint32_t baseTick = 0;  ///< Tick of the delta baseline, tick if full
   std::vector<PlayerState> players;
   std::vector<EnemyState> enemies;
   std::vector<ProjectileState> projectiles;
@@ -209,6 +212,10 @@ struct CLIENT_LEAVE {
   uint16_t playerId;
 };
 
+struct ASSETS_READY {
+  uint16_t playerId;
+};
+
 struct MAP_DATA {
   uint16_t width;
   uint16_t height;
@@ -241,6 +248,7 @@ enum class EventType : uint8_t {
   GAME_END = 0x10,
   CLIENT_LEAVE = 0x11,
   ERROR_TYPE = 0x12,
+  ASSETS_READY = 0x13,
 
   // UDP Messages
   PLAYER_INPUT = 0x20,
@@ -251,6 +259,9 @@ enum class EventType : uint8_t {
   ENEMY_HIT = 0x25,
   FORCE_STATE = 0x26,
   LEVEL_TRANSITION = 0x027,
+  /// Packet type only: GAME_STATE in the format of BitStream.hpp, decoded
+  /// as a GAME_STATE event
+  GAME_STATE_PACKED = 0x28,
 
   UNKNOWN = 0xFF
 };
@@ -270,12 +281,12 @@ using EventData =
                  LOBBY_JOIN_RESPONSE, LOBBY_LIST_RESPONSE, PLAYER_READY,
                  LOBBY_UPDATE, LOBBY_START, LOBBY_LIST_REQUEST, LOBBY_LEAVE,
                  MESSAGE, LOBBY_KICK, BOSS_SPAWN, FORCE_STATE, CLIENT_LEAVE,
-                 MAP_DATA, LEVEL_TRANSITION>;
+                 MAP_DATA, LEVEL_TRANSITION, ASSETS_READY>;
 
 struct Event {
   EventType type;
   EventData data;
-  uint16_t seqNum;
-  uint16_t ack;
-  uint32_t ack_bits;
+  uint16_t seqNum = 0;
+  uint16_t ack = 0;
+  uint32_t ack_bits = 0;
 };
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "network/ByteView.hpp"
+
+/**
+ * @brief Fragmentation of the UDP packets bigger than one datagram
+ *
+ * Each fragment is a UDP packet of its own: the type and ack fields of the
+ * original packet, its own sequence number, and the FLAG_FRAGMENT flag. Its
+ * payload starts with the fragment header (message id, index, count)
+ * followed by a slice of the original payload. Since every fragment has a
+ * sequence number, the fragments of a reliable packet enter the resend
+ * history one by one and the ack bitfield only lets the missing ones be
+ * resent.
+ */
+namespace fragment {
+constexpr uint8_t FLAG_FRAGMENT = 0x10;
+constexpr size_t UDP_HEADER = 14;
+constexpr size_t HEADER = 4;  ///< Message id (u16), index (u8), count (u8)
+/// Largest datagram sent, under the MTU and the receive buffers
+constexpr size_t MAX_DATAGRAM = 1200;
+constexpr size_t MAX_SLICE = MAX_DATAGRAM - UDP_HEADER - HEADER;
+constexpr size_t MAX_FRAGMENTS = 64;  ///< About 75 KB per message
+
+struct Header {
+  uint16_t seq = 0;
+  uint16_t ack = 0;
+  uint32_t ackBits = 0;
+  uint16_t messageId = 0;
+  uint8_t index = 0;
+  uint8_t count = 0;
+};
+
+inline void writeU16(uint8_t* out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value >> 8);
+  out[1] = static_cast<uint8_t>(value);
+}
+
+inline void writeU32(uint8_t* out, uint32_t value) {
+  writeU16(out, static_cast<uint16_t>(value >> 16));
+  writeU16(out + 2, static_cast<uint16_t>(value));
+}
+
+inline uint16_t readU16(const uint8_t* in) {
+  return static_cast<uint16_t>((in[0] << 8) | in[1]);
+}
+
+inline uint32_t readU32(const uint8_t* in) {
+  return (static_cast<uint32_t>(readU16(in)) << 16) | readU16(in + 2);
+}
+
+inline bool isFragment(ByteView packet) {
+  return packet.size() >= 2 && (packet[1] & FLAG_FRAGMENT);
+}
+
+/**
+ * @brief Number of fragments an encoded UDP packet needs, 1 if it fits
+ * in a datagram, 0 if it is too big to be sent
+ */
+inline size_t countFor(const std::vector<uint8_t>& packet) {
+  if (packet.size() <= MAX_DATAGRAM) return 1;
+  size_t count = (packet.size() - UDP_HEADER + MAX_SLICE - 1) / MAX_SLICE;
+  return count <= MAX_FRAGMENTS ? count : 0;
+}
+
+/**
+ * @brief Build one fragment of an encoded UDP packet
+ * @param packet Whole packet, 14 byte header included
+ * @param seq Sequence number of the fragment
+ * @param out Replaced by the fragment
+ */
+inline void make(const std::vector<uint8_t>& packet, uint16_t messageId,
+                 uint8_t index, uint8_t count, uint16_t seq,
+                 std::vector<uint8_t>& out) {
+  size_t begin = UDP_HEADER + index * MAX_SLICE;
+  size_t end = std::min(packet.size(), begin + MAX_SLICE);
+
+  out.resize(UDP_HEADER + HEADER + (end - begin));
+  out[0] = packet[0];
+  out[1] = packet[1] | FLAG_FRAGMENT;
+  writeU32(&out[2], static_cast<uint32_t>(out.size() - UDP_HEADER));
+  writeU16(&out[6], seq);
+  std::copy(packet.begin() + 8, packet.begin() + UDP_HEADER, out.begin() + 8);
+  writeU16(&out[UDP_HEADER], messageId);
+  out[UDP_HEADER + 2] = index;
+  out[UDP_HEADER + 3] = count;
+  std::copy(packet.begin() + begin, packet.begin() + end,
+            out.begin() + UDP_HEADER + HEADER);
+}
+
+inline std::vector<uint8_t> make(const std::vector<uint8_t>& packet,
+                                 uint16_t messageId, uint8_t index,
+                                 uint8_t count, uint16_t seq) {
+  std::vector<uint8_t> out;
+  make(packet, messageId, index, count, seq, out);
+  return out;
+}
+
+/**
+ * @brief Read the header of a fragment, false if it is malformed
+ */
+inline bool parse(ByteView packet, Header& out) {
+  if (packet.size() < UDP_HEADER + HEADER || !isFragment(packet)) {
+    return false;
+  }
+  if (readU32(&packet[2]) != packet.size() - UDP_HEADER) return false;
+  out.seq = readU16(&packet[6]);
+  out.ack = readU16(&packet[8]);
+  out.ackBits = readU32(&packet[10]);
+  out.messageId = readU16(&packet[UDP_HEADER]);
+  out.index = packet[UDP_HEADER + 2];
+  out.count = packet[UDP_HEADER + 3];
+  return out.count > 0 && out.count <= MAX_FRAGMENTS && out.index < out.count;
+}
+}  // namespace fragment
+
+/**
+ * @class FragmentAssembler
+ * @brief Rebuilds the fragmented packets received from one peer
+ *
+ * Fragments may arrive in any order and more than once. A message still
+ * incomplete after TIMEOUT is dropped; with more than MAX_PENDING messages
+ * in progress, the oldest one is.
+ */
+class FragmentAssembler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr size_t MAX_PENDING = 8;
+  static constexpr std::chrono::milliseconds TIMEOUT{2000};
+
+  /**
+   * @brief Store a fragment
+   * @return The whole packet once its last fragment arrives, with the
+   * sequence and ack fields of that fragment
+   */
+  std::optional<std::vector<uint8_t>> add(ByteView packet,
+                                          Clock::time_point now) {
+    fragment::Header header;
+    if (!fragment::parse(packet, header)) return std::nullopt;
+    for (size_t i = 0; i < completedCount; ++i) {
+      if (completed[i] == header.messageId) return std::nullopt;
+    }
+
+    auto it = pending.find(header.messageId);
+    if (it == pending.end()) {
+      if (pending.size() >= MAX_PENDING) dropOldest();
+      Pending message;
+      message.count = header.count;
+      message.slices.resize(header.count);
+      message.have.resize(header.count, false);
+      message.first = now;
+      it = pending.emplace(header.messageId, std::move(message)).first;
+    }
+    Pending& message = it->second;
+    if (message.count != header.count) return std::nullopt;
+
+    if (message.have[header.index]) return std::nullopt;
+    message.have[header.index] = true;
+    message.slices[header.index].assign(
+        packet.begin() + fragment::UDP_HEADER + fragment::HEADER,
+        packet.end());
+    if (++message.received < message.count) return std::nullopt;
+
+    // En-tete du dernier fragment recu, sans le drapeau de fragment
+    std::vector<uint8_t> whole(packet.begin(),
+                               packet.begin() + fragment::UDP_HEADER);
+    whole[1] &= static_cast<uint8_t>(~fragment::FLAG_FRAGMENT);
+    for (const auto& part : message.slices) {
+      whole.insert(whole.end(), part.begin(), part.end());
+    }
+    fragment::writeU32(&whole[2], static_cast<uint32_t>(
+                                      whole.size() - fragment::UDP_HEADER));
+
+    completed[nextCompleted] = header.messageId;
+    nextCompleted = (nextCompleted + 1) % completed.size();
+    completedCount = std::min(completedCount + 1, completed.size());
+    pending.erase(it);
+    return whole;
+  }
+
+  /**
+   * @brief Drop the messages still incomplete after TIMEOUT
+   */
+  void expire(Clock::time_point now) {
+    for (auto it = pending.begin(); it != pending.end();) {
+      if (now - it->second.first > TIMEOUT) {
+        it = pending.erase(it);
+        expired++;
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void clear() {
+    pending.clear();
+    completedCount = 0;
+  }
+
+  uint64_t expired = 0;  ///< Messages dropped incomplete
+
+ private:
+  struct Pending {
+    uint8_t count = 0;
+    uint8_t received = 0;
+    std::vector<std::vector<uint8_t>> slices;
+    std::vector<bool> have;
+    Clock::time_point first;
+  };
+
+  void dropOldest() {
+    auto oldest = pending.begin();
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+      if (it->second.first < oldest->second.first) oldest = it;
+    }
+    pending.erase(oldest);
+    expired++;
+  }
+
+  std::map<uint16_t, Pending> pending;
+  /// Recently rebuilt messages, whose late copies are ignored
+  std::array<uint16_t, MAX_PENDING> completed{};
+  size_t nextCompleted = 0;
+  size_t completedCount = 0;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @class PacketPool
+ * @brief Free list of packet buffers that keep their capacity
+ *
+ * A buffer is acquired, encoded into in place, then moved into the
+ * completion handler of its send; releasing it there puts it back in the
+ * pool. Once the pool is warmed up, encoding and sending a packet does not
+ * touch the heap. The pool state is shared with the buffers in flight, so
+ * the pool may be destroyed before them.
+ */
+class PacketPool {
+  struct State {
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>*> free;
+
+    ~State() {
+      for (auto* buffer : free) delete buffer;
+    }
+  };
+
+ public:
+  static constexpr size_t MAX_FREE = 1024;  ///< Buffers kept for reuse
+  static constexpr size_t CAPACITY = 1500;  ///< Reserved by a new buffer
+
+  /**
+   * @brief Deleter of a pooled buffer, puts it back in its pool
+   */
+  class Release {
+   public:
+    Release() = default;
+    explicit Release(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    void operator()(std::vector<uint8_t>* buffer) const {
+      if (state) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->free.size() < MAX_FREE) {
+          buffer->clear();
+          state->free.push_back(buffer);
+          return;
+        }
+      }
+      delete buffer;
+    }
+
+   private:
+    std::shared_ptr<State> state;
+  };
+
+  using Buffer = std::unique_ptr<std::vector<uint8_t>, Release>;
+
+  PacketPool() : state(std::make_shared<State>()) {
+    state->free.reserve(MAX_FREE);
+  }
+
+  /**
+   * @brief Take an empty buffer, allocated only if the pool is empty
+   */
+  Buffer acquire() {
+    std::vector<uint8_t>* buffer = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (!state->free.empty()) {
+        buffer = state->free.back();
+        state->free.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = new std::vector<uint8_t>();
+      buffer->reserve(CAPACITY);
+    }
+    return Buffer(buffer, Release(state));
+  }
+
+ private:
+  std::shared_ptr<State> state;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network/ByteView.hpp"
+
+/**
+ * @class PacketReader
+ * @brief Cursor over a received packet, every read checked against its end
+ *
+ * A read past the end fails and leaves its output untouched. The reader then
+ * stays failed: later reads fail at once without touching the bytes, so a
+ * decoder reads a whole section straight through and checks ok() once.
+ * Integers are big-endian, floats are sent as the bits of a uint32.
+ */
+class PacketReader {
+ public:
+  explicit PacketReader(ByteView bytes) : bytes(bytes) {}
+
+  bool u8(uint8_t& out) {
+    if (!take(1)) return false;
+    out = at[0];
+    return true;
+  }
+
+  bool i8(int8_t& out) {
+    uint8_t raw;
+    if (!u8(raw)) return false;
+    out = static_cast<int8_t>(raw);
+    return true;
+  }
+
+  bool u16(uint16_t& out) {
+    if (!take(2)) return false;
+    out = static_cast<uint16_t>((at[0] << 8) | at[1]);
+    return true;
+  }
+
+  bool u32(uint32_t& out) {
+    if (!take(4)) return false;
+    out = (static_cast<uint32_t>(at[0]) << 24) |
+          (static_cast<uint32_t>(at[1]) << 16) |
+          (static_cast<uint32_t>(at[2]) << 8) | at[3];
+    return true;
+  }
+
+  bool f32(float& out) {
+    uint32_t raw;
+    if (!u32(raw)) return false;
+    std::memcpy(&out, &raw, sizeof(out));
+    return true;
+  }
+
+  /**
+   * @brief Boolean sent on one byte, true only for 1
+   */
+  bool flag(bool& out) {
+    uint8_t raw;
+    if (!u8(raw)) return false;
+    out = raw == 1;
+    return true;
+  }
+
+  /**
+   * @brief String prefixed by its length on one byte
+   */
+  bool string(std::string& out) {
+    uint8_t length;
+    if (!u8(length) || !take(length)) return false;
+    out.assign(reinterpret_cast<const char*>(at), length);
+    return true;
+  }
+
+  /**
+   * @brief The next count bytes, as they are
+   */
+  bool raw(std::vector<uint8_t>& out, size_t count) {
+    if (!take(count)) return false;
+    out.assign(at, at + count);
+    return true;
+  }
+
+  /**
+   * @brief The next count bytes in one read, for a section decoded as a
+   * block (see Schema.hpp)
+   * @return nullptr if fewer than count bytes remain
+   */
+  const uint8_t* block(size_t count) {
+    return take(count) ? at : nullptr;
+  }
+
+  /**
+   * @brief Bytes not read yet, 0 once the reader failed
+   */
+  size_t remaining() const { return failed ? 0 : bytes.size() - pos; }
+
+  /**
+   * @brief Position of the next read, for a sub-reader (e.g. a BitReader)
+   */
+  const uint8_t* data() const { return bytes.data() + pos; }
+
+  bool ok() const { return !failed; }
+
+  /**
+   * @brief Mark the packet as malformed, for checks made by the caller
+   */
+  void fail() { failed = true; }
+
+ private:
+  bool take(size_t count) {
+    if (failed || count > bytes.size() - pos) {
+      failed = true;
+      return false;
+    }
+    at = bytes.data() + pos;
+    pos += count;
+    return true;
+  }
+
+  ByteView bytes;
+  size_t pos = 0;
+  const uint8_t* at = nullptr;  ///< Start of the last bytes taken
+  bool failed = false;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "network/Event.hpp"
+
+/**
+ * @brief A player input stamped with its client sequence and server tick
+ */
+struct StampedInput {
+  PLAYER_INPUT input;
+  uint16_t seq;   ///< Client UDP sequence number
+  uint32_t tick;  ///< Simulation tick the input is applied at
+};
+
+/**
+ * @brief Fixed-size ring of the pending inputs of one player
+ *
+ * Inputs older than the last accepted sequence (duplicates or reordered
+ * datagrams) are rejected. When full, the oldest input is overwritten.
+ */
+class PlayerInputRing {
+ public:
+  static constexpr size_t CAPACITY = 32;
+
+  bool push(const StampedInput& in) {
+    if (hasSeq && static_cast<int16_t>(in.seq - lastSeq) <= 0) return false;
+    hasSeq = true;
+    lastSeq = in.seq;
+
+    if (count == CAPACITY) {
+      first = (first + 1) % CAPACITY;
+      count--;
+      overwritten++;
+    }
+    buffer[(first + count) % CAPACITY] = in;
+    count++;
+    return true;
+  }
+
+  const StampedInput* front() const {
+    return count == 0 ? nullptr : &buffer[first];
+  }
+
+  void pop() {
+    if (count == 0) return;
+    first = (first + 1) % CAPACITY;
+    count--;
+  }
+
+  size_t size() const { return count; }
+
+  void clear() {
+    first = 0;
+    count = 0;
+    hasSeq = false;
+  }
+
+  uint64_t overwritten = 0;  ///< Inputs lost because the ring was full
+
+ private:
+  std::array<StampedInput, CAPACITY> buffer{};
+  size_t first = 0;
+  size_t count = 0;
+  uint16_t lastSeq = 0;
+  bool hasSeq = false;
+};
+
+/**
+ * @brief Per-player input channel between the server and the game scene
+ *
+ * The server pushes the received inputs stamped with the tick they must be
+ * applied at and sets the tick being simulated before each scene update.
+ * The scene consumes, for every player, the inputs due at that tick in
+ * sequence order. Both sides run on the lobby tick thread.
+ */
+class PlayerInputBuffers {
+ public:
+  void push(uint16_t playerId, const PLAYER_INPUT& input, uint16_t seq,
+            uint32_t tick) {
+    rings[playerId].push(StampedInput{input, seq, tick});
+  }
+
+  /**
+   * @brief Call apply(playerId, input) for every input due at the current
+   * tick, oldest first, and remove them
+   */
+  template <typename F>
+  void consume(F&& apply) {
+    for (auto& [playerId, ring] : rings) {
+      while (const StampedInput* in = ring.front()) {
+        if (static_cast<int32_t>(in->tick - currentTick) > 0) break;
+        apply(playerId, *in);
+        ring.pop();
+      }
+    }
+  }
+
+  void setTick(uint32_t tick) { currentTick = tick; }
+  uint32_t tick() const { return currentTick; }
+
+  void remove(uint16_t playerId) { rings.erase(playerId); }
+  void clear() { rings.clear(); }
+
+ private:
+  std::unordered_map<uint16_t, PlayerInputRing> rings;
+  uint32_t currentTick = 0;
+};
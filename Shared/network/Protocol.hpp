@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include "network/Action.hpp"
+#include "network/Event.hpp"
+
+/**
+ * @brief Description of the protocol shared by the encoder and the decoder
+ *
+ * The packet type of each action and the fields of the fixed-size messages
+ * are written here once; EncodeFunc.cpp and DecodeFunc.cpp both derive from
+ * them, so the two sides cannot disagree on a type number or a field order.
+ * The packet types are the values of EventType.
+ */
+namespace protocol {
+
+struct Route {
+  ActionType action;
+  EventType packet;
+};
+
+/// Packet type sent for each action
+constexpr Route ROUTES[] = {
+    {ActionType::LOGIN_REQUEST, EventType::LOGIN_REQUEST},
+    {ActionType::LOGIN_RESPONSE, EventType::LOGIN_RESPONSE},
+    {ActionType::LOBBY_CREATE, EventType::LOBBY_CREATE},
+    {ActionType::LOBBY_JOIN_REQUEST, EventType::LOBBY_JOIN_REQUEST},
+    {ActionType::LOBBY_JOIN_RESPONSE, EventType::LOBBY_JOIN_RESPONSE},
+    {ActionType::LOBBY_LIST_REQUEST, EventType::LOBBY_LIST_REQUEST},
+    {ActionType::LOBBY_LIST_RESPONSE, EventType::LOBBY_LIST_RESPONSE},
+    {ActionType::PLAYER_READY, EventType::PLAYER_READY},
+    {ActionType::LOBBY_UPDATE, EventType::LOBBY_UPDATE},
+    {ActionType::LOBBY_LEAVE, EventType::LOBBY_LEAVE},
+    {ActionType::LOBBY_START, EventType::LOBBY_START},
+    {ActionType::MESSAGE, EventType::MESSAGE},
+    {ActionType::LOBBY_KICK, EventType::LOBBY_KICK},
+    {ActionType::SEND_MAP, EventType::SEND_MAP},
+    {ActionType::GAME_START, EventType::GAME_START},
+    {ActionType::GAME_END, EventType::GAME_END},
+    {ActionType::CLIENT_LEAVE, EventType::CLIENT_LEAVE},
+    {ActionType::ERROR_SERVER, EventType::ERROR_TYPE},
+    {ActionType::ASSETS_READY, EventType::ASSETS_READY},
+
+    {ActionType::UP_PRESS, EventType::PLAYER_INPUT},
+    {ActionType::UP_RELEASE, EventType::PLAYER_INPUT},
+    {ActionType::DOWN_PRESS, EventType::PLAYER_INPUT},
+    {ActionType::DOWN_RELEASE, EventType::PLAYER_INPUT},
+    {ActionType::LEFT_PRESS, EventType::PLAYER_INPUT},
+    {ActionType::LEFT_RELEASE, EventType::PLAYER_INPUT},
+    {ActionType::RIGHT_PRESS, EventType::PLAYER_INPUT},
+    {ActionType::RIGHT_RELEASE, EventType::PLAYER_INPUT},
+    {ActionType::FIRE_PRESS, EventType::PLAYER_INPUT},
+    {ActionType::FIRE_RELEASE, EventType::PLAYER_INPUT},
+    {ActionType::GAME_STATE, EventType::GAME_STATE},
+    {ActionType::AUTH, EventType::AUTH},
+    {ActionType::BOSS_SPAWN, EventType::BOSS_SPAWN},
+    {ActionType::BOSS_UPDATE, EventType::BOSS_UPDATE},
+    {ActionType::ENEMY_HIT, EventType::ENEMY_HIT},
+    {ActionType::FORCE_STATE, EventType::FORCE_STATE},
+    {ActionType::LEVEL_TRANSITION, EventType::LEVEL_TRANSITION},
+    {ActionType::GAME_STATE_PACKED, EventType::GAME_STATE_PACKED},
+};
+
+constexpr std::array<EventType, 256> BuildPacketTypes() {
+  std::array<EventType, 256> types{};
+  for (auto& type : types) type = EventType::UNKNOWN;
+  for (const Route& route : ROUTES) {
+    types[static_cast<uint8_t>(route.action)] = route.packet;
+  }
+  return types;
+}
+
+constexpr std::array<EventType, 256> PACKET_TYPES = BuildPacketTypes();
+
+/**
+ * @brief Packet type of an action, UNKNOWN if it is never sent
+ */
+constexpr EventType packetType(ActionType action) {
+  return PACKET_TYPES[static_cast<uint8_t>(action)];
+}
+
+static_assert(packetType(ActionType::GAME_STATE_PACKED) ==
+              EventType::GAME_STATE_PACKED);
+
+// Messages de taille fixe : Sent est la donnee de l'Action encodee, Received
+// celle de l'Event decode, fields() la liste des champs dans l'ordre du fil
+
+struct AuthSchema {
+  using Sent = AuthUDP;
+  using Received = AUTH;
+  static constexpr EventType PACKET = EventType::AUTH;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct PlayerInputSchema {
+  using Sent = PlayerInput;
+  using Received = PLAYER_INPUT;
+  static constexpr EventType PACKET = EventType::PLAYER_INPUT;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.up, m.down, m.left, m.right, m.fire);
+  }
+};
+
+struct BossSpawnSchema {
+  using Sent = BossSpawn;
+  using Received = BOSS_SPAWN;
+  static constexpr EventType PACKET = EventType::BOSS_SPAWN;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.bossId, m.bossType, m.maxHp, m.phase);
+  }
+};
+
+struct BossUpdateSchema {
+  using Sent = BossUpdate;
+  using Received = BOSS_UPDATE;
+  static constexpr EventType PACKET = EventType::BOSS_UPDATE;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.bossId, m.posX, m.posY, m.hp, m.phase, m.action);
+  }
+};
+
+struct EnemyHitSchema {
+  using Sent = EnemyHit;
+  using Received = ENEMY_HIT;
+  static constexpr EventType PACKET = EventType::ENEMY_HIT;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.enemyId, m.damage, m.hpRemaining);
+  }
+};
+
+struct ForceStateSchema {
+  using Sent = ForceState;
+  using Received = FORCE_STATE;
+  static constexpr EventType PACKET = EventType::FORCE_STATE;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.forceId, m.ownerId, m.posX, m.posY, m.state);
+  }
+};
+
+struct GameStartSchema {
+  using Sent = GameStart;
+  using Received = GAME_START;
+  static constexpr EventType PACKET = EventType::GAME_START;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerSpawnX, m.playerSpawnY, m.scrollSpeed);
+  }
+};
+
+struct PlayerReadySchema {
+  using Sent = PlayerReady;
+  using Received = PLAYER_READY;
+  static constexpr EventType PACKET = EventType::PLAYER_READY;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.ready);
+  }
+};
+
+struct LobbyStartSchema {
+  using Sent = LobbyStart;
+  using Received = LOBBY_START;
+  static constexpr EventType PACKET = EventType::LOBBY_START;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.countdown);
+  }
+};
+
+struct LobbyListRequestSchema {
+  using Sent = LobbyListRequest;
+  using Received = LOBBY_LIST_REQUEST;
+  static constexpr EventType PACKET = EventType::LOBBY_LIST_REQUEST;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct LobbyLeaveSchema {
+  using Sent = LobbyLeave;
+  using Received = LOBBY_LEAVE;
+  static constexpr EventType PACKET = EventType::LOBBY_LEAVE;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct LobbyKickSchema {
+  using Sent = LobbyKick;
+  using Received = LOBBY_KICK;
+  static constexpr EventType PACKET = EventType::LOBBY_KICK;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct ClientLeaveSchema {
+  using Sent = ClientLeave;
+  using Received = CLIENT_LEAVE;
+  static constexpr EventType PACKET = EventType::CLIENT_LEAVE;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct AssetsReadySchema {
+  using Sent = AssetsReady;
+  using Received = ASSETS_READY;
+  static constexpr EventType PACKET = EventType::ASSETS_READY;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.playerId);
+  }
+};
+
+struct LevelTransitionSchema {
+  using Sent = LevelTransition;
+  using Received = LEVEL_TRANSITION;
+  static constexpr EventType PACKET = EventType::LEVEL_TRANSITION;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.levelNumber);
+  }
+};
+
+/**
+ * @brief Fixed-size header of SEND_MAP, followed by the tiles
+ */
+struct MapHeaderSchema {
+  using Sent = MapData;
+  using Received = MAP_DATA;
+  static constexpr EventType PACKET = EventType::SEND_MAP;
+  template <typename M>
+  static constexpr auto fields(M& m) {
+    return std::tie(m.width, m.height, m.scrollSpeed);
+  }
+};
+
+}  // namespace protocol
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Serialisation of fixed-size sections from their list of fields
+ *
+ * A schema lists the fields of a message once, in wire order:
+ * @code
+ * template <typename M>
+ * static constexpr auto fields(M& m) { return std::tie(m.id, m.posX); }
+ * @endcode
+ * The same list is used on the struct that is sent and on the struct that is
+ * received. The wire size and the offset of each field follow from the C++
+ * types of the fields, so a section is written and read as one block of
+ * stores and loads at constant offsets, without any bounds check in between.
+ * Integers are big-endian, floats are sent as the bits of a uint32 and
+ * booleans as one byte, true only for 1.
+ */
+namespace schema {
+
+template <typename T>
+struct Wire;
+
+template <>
+struct Wire<uint8_t> {
+  static constexpr size_t SIZE = 1;
+  static void write(uint8_t* out, uint8_t value) { out[0] = value; }
+  static void read(const uint8_t* in, uint8_t& value) { value = in[0]; }
+};
+
+template <>
+struct Wire<int8_t> {
+  static constexpr size_t SIZE = 1;
+  static void write(uint8_t* out, int8_t value) {
+    out[0] = static_cast<uint8_t>(value);
+  }
+  static void read(const uint8_t* in, int8_t& value) {
+    value = static_cast<int8_t>(in[0]);
+  }
+};
+
+template <>
+struct Wire<bool> {
+  static constexpr size_t SIZE = 1;
+  static void write(uint8_t* out, bool value) { out[0] = value ? 1 : 0; }
+  static void read(const uint8_t* in, bool& value) { value = in[0] == 1; }
+};
+
+template <>
+struct Wire<uint16_t> {
+  static constexpr size_t SIZE = 2;
+  static void write(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value >> 8);
+    out[1] = static_cast<uint8_t>(value);
+  }
+  static void read(const uint8_t* in, uint16_t& value) {
+    value = static_cast<uint16_t>((in[0] << 8) | in[1]);
+  }
+};
+
+template <>
+struct Wire<uint32_t> {
+  static constexpr size_t SIZE = 4;
+  static void write(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+  }
+  static void read(const uint8_t* in, uint32_t& value) {
+    value = (static_cast<uint32_t>(in[0]) << 24) |
+            (static_cast<uint32_t>(in[1]) << 16) |
+            (static_cast<uint32_t>(in[2]) << 8) | in[3];
+  }
+};
+
+template <>
+struct Wire<float> {
+  static constexpr size_t SIZE = 4;
+  static void write(uint8_t* out, float value) {
+    uint32_t bits;
+    static_assert(sizeof(float) == sizeof(uint32_t));
+    std::memcpy(&bits, &value, sizeof(bits));
+    Wire<uint32_t>::write(out, bits);
+  }
+  static void read(const uint8_t* in, float& value) {
+    uint32_t bits;
+    Wire<uint32_t>::read(in, bits);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+};
+
+/**
+ * @brief Sizes and offsets of a list of field types
+ */
+template <typename... T>
+struct Layout {
+  static constexpr std::array<size_t, sizeof...(T)> SIZES{Wire<T>::SIZE...};
+
+  static constexpr size_t offset(size_t index) {
+    size_t total = 0;
+    for (size_t i = 0; i < index; ++i) total += SIZES[i];
+    return total;
+  }
+
+  static constexpr size_t SIZE = offset(sizeof...(T));
+};
+
+template <typename Fields>
+struct TypesOf;
+
+template <typename... F>
+struct TypesOf<std::tuple<F&...>> {
+  using type = std::tuple<std::remove_const_t<F>...>;
+  using layout = Layout<std::remove_const_t<F>...>;
+};
+
+/**
+ * @brief Field types of schema S applied to message M, to check that the
+ * sent and received structs agree on the wire layout
+ */
+template <typename S, typename M>
+using Types =
+    typename TypesOf<decltype(S::fields(std::declval<M&>()))>::type;
+
+/**
+ * @brief Wire size of schema S applied to message M, known at compile time
+ */
+template <typename S, typename M>
+constexpr size_t SIZE =
+    TypesOf<decltype(S::fields(std::declval<M&>()))>::layout::SIZE;
+
+template <typename... F, size_t... I>
+void writeFields(uint8_t* out, const std::tuple<F&...>& fields,
+                 std::index_sequence<I...>) {
+  using L = Layout<std::remove_const_t<F>...>;
+  (Wire<std::remove_const_t<F>>::write(
+       out + std::integral_constant<size_t, L::offset(I)>::value,
+       std::get<I>(fields)),
+   ...);
+}
+
+template <typename... F, size_t... I>
+void readFields(const uint8_t* in, const std::tuple<F&...>& fields,
+                std::index_sequence<I...>) {
+  using L = Layout<F...>;
+  (Wire<F>::read(in + std::integral_constant<size_t, L::offset(I)>::value,
+                 std::get<I>(fields)),
+   ...);
+}
+
+/**
+ * @brief Write the fields of message m with schema S
+ * @param out At least SIZE<S, M> bytes
+ */
+template <typename S, typename M>
+void write(uint8_t* out, const M& m) {
+  auto fields = S::fields(m);
+  writeFields(out, fields,
+              std::make_index_sequence<std::tuple_size_v<decltype(fields)>>());
+}
+
+/**
+ * @brief Read the fields of message m with schema S
+ * @param in At least SIZE<S, M> bytes
+ */
+template <typename S, typename M>
+void read(const uint8_t* in, M& m) {
+  auto fields = S::fields(m);
+  readFields(in, fields,
+             std::make_index_sequence<std::tuple_size_v<decltype(fields)>>());
+}
+
+}  // namespace schema
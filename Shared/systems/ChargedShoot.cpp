@@ -42,7 +42,7 @@ void charged_shoot_system(Registry& registry, float deltaTime) {
         Vector2 spawnPos = {transform.position.x + 40.f, transform.position.y};
         Vector2 direction = {1.0f, 0.0f};
         float speed = 400.0f + chargeLevel * 100.0f;
-        Uint32 baseDamage = 10 + (chargeLevel * 5);
+        uint32_t baseDamage = 10 + (chargeLevel * 5);
 
         Entity projectile = createProjectile(
             registry, spawnPos, direction, speed, baseDamage,
@@ -1,5 +1,7 @@
 // Copyright 2025 Dalia Guiz
 #pragma once
+#include <utility>
+
 #include "../../components/Collision/CollisionController.hpp"
 #include "Collision/Items.hpp"
 #include "Player/Boss.hpp"
@@ -29,3 +31,35 @@ inline bool check_collision(const Transform& t1, const BoxCollider& c1,
          t1.position.y < t2.position.y + c2.height &&
          t1.position.y + c1.height > t2.position.y;
 }
+
+// Swept AABB : la boite c1 part de `start` et se deplace de `delta` pendant le
+// tick. Renvoie true si elle touche la boite fixe (t2, c2) et ecrit dans `toi`
+// la fraction du deplacement (0..1) au moment de l'impact.
+inline bool swept_collision(const Vector2& start, const BoxCollider& c1,
+                            const Vector2& delta, const Transform& t2,
+                            const BoxCollider& c2, float& toi) {
+  // Boite cible elargie par c1 (Minkowski) : on lance un rayon depuis start
+  const float minX = t2.position.x - c1.width;
+  const float maxX = t2.position.x + c2.width;
+  const float minY = t2.position.y - c1.height;
+  const float maxY = t2.position.y + c2.height;
+
+  float tEnter = 0.0f;
+  float tExit = 1.0f;
+
+  auto clip = [&](float origin, float d, float lo, float hi) -> bool {
+    if (d == 0.0f) return origin > lo && origin < hi;
+    float t0 = (lo - origin) / d;
+    float t1 = (hi - origin) / d;
+    if (t0 > t1) std::swap(t0, t1);
+    if (t0 > tEnter) tEnter = t0;
+    if (t1 < tExit) tExit = t1;
+    return tEnter < tExit;
+  };
+
+  if (!clip(start.x, delta.x, minX, maxX)) return false;
+  if (!clip(start.y, delta.y, minY, maxY)) return false;
+
+  toi = tEnter;
+  return true;
+}
@@ -2,6 +2,7 @@
 
 #include "Player/Enemy.hpp"
 #include "Player/PlayerEntity.hpp"
+#include "Player/Projectile.hpp"
 #include "components/TileMap.hpp"
 #include "ecs/Registry.hpp"
 #include "ecs/SparseArray.hpp"
@@ -9,23 +10,38 @@
 #include "physics/Physics2D.hpp"
 #include"Collision/MapCollisionSystem.hpp"
 
-// Système de collision tilemap pour les joueurs
-void tilemap_collision_system(Registry& registry) {
+TileMap* resolve_active_tilemap(Registry& registry, ActiveTileMap& handle) {
   auto& tilemaps = registry.get_components<TileMap>();
-  auto& transforms = registry.get_components<Transform>();
-  auto& players = registry.get_components<PlayerEntity>();
-  auto& colliders = registry.get_components<BoxCollider>();
+
+  // Handle encore valide : pas de parcours du pool
+  if (handle.entity < tilemaps.size() && tilemaps[handle.entity].has_value() &&
+      tilemaps[handle.entity]->tiles.size() > 0) {
+    return &tilemaps[handle.entity].value();
+  }
 
   // Trouver la tilemap active
-  TileMap* activeTilemap = nullptr;
-  for (auto& tm : tilemaps) {
+  for (size_t i = 0; i < tilemaps.size(); ++i) {
+    auto& tm = tilemaps[i];
     if (tm.has_value() && tm->tiles.size() > 0) {
-      activeTilemap = &tm.value();
-      break;
+      if (!tm->solidMasksReady) tm->rebuildSolidMasks();
+      handle.entity = i;
+      return &tm.value();
     }
   }
+  handle.entity = static_cast<size_t>(-1);
+  return nullptr;
+}
 
+// Système de collision tilemap pour les joueurs
+void tilemap_collision_system(Registry& registry, ActiveTileMap& handle) {
+  auto& transforms = registry.get_components<Transform>();
+  auto& players = registry.get_components<PlayerEntity>();
+  auto& colliders = registry.get_components<BoxCollider>();
+
+  TileMap* activeTilemap = resolve_active_tilemap(registry, handle);
   if (!activeTilemap) return;
+  const float tileSize = activeTilemap->tileSize;
+  const float scroll = activeTilemap->scrollOffset;
 
   // Vérifier collisions pour chaque joueur
   for (auto&& [idx, player, transform, collider] :
@@ -36,77 +52,59 @@ void tilemap_collision_system(Registry& registry) {
     float halfW = collider.width / 2.0f;
     float halfH = collider.height / 2.0f;
 
-    // Points de collision (coins de la hitbox)
-    float left = transform.position.x - halfW;
-    float right = transform.position.x + halfW;
-    float top = transform.position.y - halfH;
-    float bottom = transform.position.y + halfH;
-
-    // Collision avec le SOL (bas)
-    if (activeTilemap->isSolidAtPixel(transform.position.x, bottom)) {
-      // Repousser vers le haut
-      int tileY = static_cast<int>(bottom / activeTilemap->tileSize);
-      float tileTop = static_cast<float>(tileY * activeTilemap->tileSize);
-      transform.position.y = tileTop - halfH;
+    // Tuiles sous les sondes (centre et bords de la hitbox)
+    int centerX = activeTilemap->pixelToTileX(transform.position.x);
+    int centerY = activeTilemap->pixelToTileY(transform.position.y);
+    int bottomY = activeTilemap->pixelToTileY(transform.position.y + halfH);
+    int topY = activeTilemap->pixelToTileY(transform.position.y - halfH);
+    int leftX = activeTilemap->pixelToTileX(transform.position.x - halfW);
+    int rightX = activeTilemap->pixelToTileX(transform.position.x + halfW);
+
+    // Collision avec le SOL (bas) : repousser vers le haut
+    if (activeTilemap->isSolid(centerX, bottomY)) {
+      transform.position.y = bottomY * tileSize - halfH;
     }
 
-    // Collision avec le PLAFOND (haut)
-    if (activeTilemap->isSolidAtPixel(transform.position.x, top)) {
-      // Repousser vers le bas
-      int tileY = static_cast<int>(top / activeTilemap->tileSize);
-      float tileBottom =
-          static_cast<float>((tileY + 1) * activeTilemap->tileSize);
-      transform.position.y = tileBottom + halfH;
+    // Collision avec le PLAFOND (haut) : repousser vers le bas
+    if (activeTilemap->isSolid(centerX, topY)) {
+      transform.position.y = (topY + 1) * tileSize + halfH;
     }
 
     // Collision avec MUR GAUCHE
-    if (activeTilemap->isSolidAtPixel(left, transform.position.y)) {
-      int tileX = static_cast<int>(left / activeTilemap->tileSize);
-      float tileRight =
-          static_cast<float>((tileX + 1) * activeTilemap->tileSize);
-      transform.position.x = tileRight + halfW;
+    if (activeTilemap->isSolid(leftX, centerY)) {
+      transform.position.x = (leftX + 1) * tileSize - scroll + halfW;
     }
 
     // Collision avec MUR DROIT
-    if (activeTilemap->isSolidAtPixel(right, transform.position.y)) {
-      int tileX = static_cast<int>(right / activeTilemap->tileSize);
-      float tileLeft = static_cast<float>(tileX * activeTilemap->tileSize);
-      transform.position.x = tileLeft - halfW;
+    if (activeTilemap->isSolid(rightX, centerY)) {
+      transform.position.x = rightX * tileSize - scroll - halfW;
     }
   }
 }
-void tilemap_enemy_collision_system(Registry& registry) {
-  auto& tilemaps = registry.get_components<TileMap>();
+
+void tilemap_enemy_collision_system(Registry& registry, ActiveTileMap& handle) {
   auto& transforms = registry.get_components<Transform>();
   auto& enemies = registry.get_components<Enemy>();
   auto& colliders = registry.get_components<BoxCollider>();
 
-  // Trouver la tilemap active
-  TileMap* activeTilemap = nullptr;
-  for (auto& tm : tilemaps) {
-    if (tm.has_value() && tm->tiles.size() > 0) {
-      activeTilemap = &tm.value();
-      break;
-    }
-  }
+  TileMap* activeTilemap = resolve_active_tilemap(registry, handle);
   if (!activeTilemap) return;
+  const float tileSize = activeTilemap->tileSize;
+  const float scroll = activeTilemap->scrollOffset;
 
   // Parcourir tous les ennemis
   for (auto&& [idx, enemy, transform, collider] :
        IndexedZipper(enemies, transforms, colliders)) {
     float halfH = collider.height / 2.0f;
     float halfW = collider.width / 2.0f;
-    float bottom = transform.position.y + halfH;
-    float top = transform.position.y - halfH;
-    float left = transform.position.x - halfW;
-    float right = transform.position.x + halfW;
-
-    // --- Collision SOL ---
-    if (activeTilemap->isSolidAtPixel(left, bottom) ||
-        activeTilemap->isSolidAtPixel(right, bottom)) {
-      int tileY = static_cast<int>(bottom / activeTilemap->tileSize);
-      float tileTop = static_cast<float>(tileY * activeTilemap->tileSize);
-      transform.position.y = tileTop - halfH;
+    int bottomY = activeTilemap->pixelToTileY(transform.position.y + halfH);
+    int topY = activeTilemap->pixelToTileY(transform.position.y - halfH);
+    int leftX = activeTilemap->pixelToTileX(transform.position.x - halfW);
+    int rightX = activeTilemap->pixelToTileX(transform.position.x + halfW);
+
+    // --- Collision SOL : une tuile solide sur la ligne du bas ---
+    if (activeTilemap->firstSolidInSpan(bottomY, leftX, rightX) >= 0) {
+      transform.position.y = bottomY * tileSize - halfH;
 
       // Pour mini_Green : rebond ou saut
       if (enemy.type == EnemyType::mini_Green) {
@@ -117,32 +115,59 @@ void tilemap_enemy_collision_system(Registry& registry) {
     }
 
     // --- Collision PLAFOND ---
-    if (activeTilemap->isSolidAtPixel(left, top) ||
-        activeTilemap->isSolidAtPixel(right, top)) {
-      int tileY = static_cast<int>(top / activeTilemap->tileSize);
-      float tileBottom =
-          static_cast<float>((tileY + 1) * activeTilemap->tileSize);
-      transform.position.y = tileBottom + halfH;
+    if (activeTilemap->firstSolidInSpan(topY, leftX, rightX) >= 0) {
+      transform.position.y = (topY + 1) * tileSize + halfH;
       enemy.direction.y = 0.f;
     }
 
-    // --- Collision MUR GAUCHE ---
-    if (activeTilemap->isSolidAtPixel(left, top) ||
-        activeTilemap->isSolidAtPixel(left, bottom)) {
-      int tileX = static_cast<int>(left / activeTilemap->tileSize);
-      float tileRight =
-          static_cast<float>((tileX + 1) * activeTilemap->tileSize);
-      transform.position.x = tileRight + halfW;
+    // --- Collision MUR GAUCHE : une tuile solide sur la colonne de gauche ---
+    if (activeTilemap->firstSolidInColumnSpan(leftX, topY, bottomY) >= 0) {
+      transform.position.x = (leftX + 1) * tileSize - scroll + halfW;
       enemy.direction.x = 0.f;
     }
 
     // --- Collision MUR DROIT ---
-    if (activeTilemap->isSolidAtPixel(right, top) ||
-        activeTilemap->isSolidAtPixel(right, bottom)) {
-      int tileX = static_cast<int>(right / activeTilemap->tileSize);
-      float tileLeft = static_cast<float>(tileX * activeTilemap->tileSize);
-      transform.position.x = tileLeft - halfW;
+    if (activeTilemap->firstSolidInColumnSpan(rightX, topY, bottomY) >= 0) {
+      transform.position.x = rightX * tileSize - scroll - halfW;
       enemy.direction.x = 0.f;
     }
   }
 }
+
+// Projectiles contre le decor : les projectiles rapides balaient leur trajet
+// du tick pour ne pas traverser une tuile de 32 px entre deux ticks
+void tilemap_projectile_collision_system(Registry& registry,
+                                         ActiveTileMap& handle,
+                                         float deltaTime) {
+  auto& transforms = registry.get_components<Transform>();
+  auto& projectiles = registry.get_components<Projectile>();
+  auto& colliders = registry.get_components<BoxCollider>();
+  auto& rigidbodies = registry.get_components<RigidBody>();
+
+  TileMap* activeTilemap = resolve_active_tilemap(registry, handle);
+  if (!activeTilemap) return;
+
+  for (auto&& [idx, projectile, transform, collider] :
+       IndexedZipper(projectiles, transforms, colliders)) {
+    if (!projectile.isActive) continue;
+
+    // Au tick du tir, le debut du balayage serait derriere le canon : un
+    // vaisseau colle a un mur detruirait ses propres tirs
+    bool hit = false;
+    if (projectile.fastMover && projectile.hasTravelled() &&
+        idx < rigidbodies.size() && rigidbodies[idx].has_value()) {
+      Vector2 start =
+          transform.position - rigidbodies[idx]->velocity * deltaTime;
+      float toi = 0.0f;
+      hit = activeTilemap->sweepCollision(start, transform.position, collider,
+                                          toi);
+    } else {
+      hit = activeTilemap->checkCollision(transform.position, collider);
+    }
+
+    if (hit) {
+      projectile.isActive = false;
+      registry.kill_entity(Entity(idx));
+    }
+  }
+}
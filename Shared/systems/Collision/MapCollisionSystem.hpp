@@ -1,7 +1,20 @@
 #pragma once
 
+#include <cstddef>
+
 #include "components/TileMap.hpp"
 #include "ecs/Registry.hpp"
 
-void tilemap_collision_system(Registry& registry);
-void tilemap_enemy_collision_system(Registry& registry);
+// Handle vers la tilemap active, garde par la scene pour ne pas parcourir tout
+// le pool TileMap a chaque appel. Re-resolu si l'entite n'a plus de map.
+struct ActiveTileMap {
+  size_t entity = static_cast<size_t>(-1);
+};
+
+TileMap* resolve_active_tilemap(Registry& registry, ActiveTileMap& handle);
+
+void tilemap_collision_system(Registry& registry, ActiveTileMap& handle);
+void tilemap_enemy_collision_system(Registry& registry, ActiveTileMap& handle);
+void tilemap_projectile_collision_system(Registry& registry,
+                                         ActiveTileMap& handle,
+                                         float deltaTime);
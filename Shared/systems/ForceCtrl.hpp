@@ -10,7 +10,7 @@
 #include "ecs/Registry.hpp"
 #include "ecs/SparseArray.hpp"
 #include "ecs/Zipper.hpp"
-#include "input/InputSubsystem.hpp"
+#include "input/InputState.hpp"
 
 void force_control_system(Registry& registry, SparseArray<Force>& forces,
                           SparseArray<InputState>& states,
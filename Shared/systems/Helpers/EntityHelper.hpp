@@ -14,9 +14,12 @@
 #include "components/Levels.hpp"
 #include "components/TileMap.hpp"
 #include "ecs/Registry.hpp"
-#include "input/InputSubsystem.hpp"
+#include "input/InputState.hpp"
 #include "physics/Physics2D.hpp"
+#ifndef ENGINE_HEADLESS
+#include "input/InputSubsystem.hpp"
 #include "rendering/RenderingSubsystem.hpp"
+#endif
 #include "stdlib.h"
 
 static const Vector2 PLAYER_SIZE{32.f, 32.f};
@@ -135,7 +138,7 @@ inline Entity createBoss(Registry& registry, BossType type,
 
 inline Entity createProjectile(Registry& registry, const Vector2& startPos,
                                const Vector2& direction, float speed,
-                               Uint32 damage, bool fromPlayer,
+                               uint32_t damage, bool fromPlayer,
                                int chargeLevel = 0) {
   Entity projectile = registry.spawn_entity();
 
@@ -233,6 +236,7 @@ inline Entity createMapEntity(Registry& registry, uint16_t mapWidth,
   tileMap.scrollSpeed = scrollSpeed;
   tileMap.scrollOffset = 0.0f;
   tileMap.tiles = tiles;
+  tileMap.rebuildSolidMasks();
 
   registry.add_component<TileMap>(mapEntity, std::move(tileMap));
 
@@ -297,6 +301,9 @@ inline TileMap generateSimpleMap(int levelIndex, uint16_t screenWidth = 800,
 
   return map;
 }
+
+#ifndef ENGINE_HEADLESS
+// Helpers de rendu, absents du build serveur headless
 /**
  * @brief Creates a sprite
  *
@@ -377,3 +384,4 @@ inline Entity CreatePlayer(Registry& registry, const AnimationClip* clip,
 
   return player;
 }
+#endif  // ENGINE_HEADLESS
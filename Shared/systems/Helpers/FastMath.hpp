@@ -0,0 +1,31 @@
+#pragma once
+#include <cmath>
+
+// Approximations de sin/cos pour les boucles de comportement ennemi.
+// Reduction a [-pi, pi] puis parabole corrigee : erreur max ~1e-3, en
+// quelques multiplications au lieu d'un appel a la libm par ennemi. Les
+// boucles restent scalaires : elles lisent les composants a travers les
+// SparseArray et branchent selon l'etat de chaque ennemi.
+
+constexpr float FAST_PI = 3.14159265358979f;
+constexpr float FAST_TWO_PI = 6.28318530717959f;
+constexpr float FAST_INV_TWO_PI = 0.159154943091895f;
+
+inline float fast_sin(float x) {
+  // x ramene dans [-pi, pi]
+  x -= FAST_TWO_PI * std::floor(x * FAST_INV_TWO_PI + 0.5f);
+
+  constexpr float B = 4.0f / FAST_PI;
+  constexpr float C = -4.0f / (FAST_PI * FAST_PI);
+  float y = B * x + C * x * std::fabs(x);
+
+  constexpr float P = 0.225f;
+  return P * (y * std::fabs(y) - y) + y;
+}
+
+inline float fast_cos(float x) { return fast_sin(x + FAST_PI * 0.5f); }
+
+// Equivalent de fmod pour t >= 0 et une periode positive
+inline float wrap_period(float t, float period) {
+  return t - period * std::floor(t / period);
+}
@@ -4,8 +4,10 @@
 #include <algorithm>
 #include <iostream>
 #include <random>
+#include <vector>
 
 #include "Helpers/EntityHelper.hpp"
+#include "Helpers/FastMath.hpp"
 #include "Movement/Movement.hpp"
 #include "Player/Boss.hpp"
 #include "Player/Enemy.hpp"
@@ -29,150 +31,253 @@ void player_movement_system(Registry& registry) {
   }
 }
 
-void enemy_movement_system(Registry& registry,
-                           SparseArray<Transform>& transforms,
-                           SparseArray<RigidBody>& rigidbodies,
-                           SparseArray<Enemy>& enemies,
-                           SparseArray<PlayerEntity>& players,
-                           float deltaTime) {
-  std::optional<Vector2> closestPlayerPos = std::nullopt;
+namespace {
+
+// Tir emis pendant le tick, cree apres le parcours des ennemis pour ne pas
+// faire grossir les SparseArray pendant qu'on les itere
+struct PendingShot {
+  Vector2 position;
+  Vector2 direction;
+  float speed;
+  size_t ownerId;
+};
+
+// Ennemis regroupes par EnemyType, reutilises d'un tick a l'autre
+struct EnemyBuckets {
+  std::vector<size_t> basic;
+  std::vector<size_t> zigzag;
+  std::vector<size_t> chase;
+  std::vector<size_t> miniGreen;
+  std::vector<size_t> spinner;
+
+  void clear() {
+    basic.clear();
+    zigzag.clear();
+    chase.clear();
+    miniGreen.clear();
+    spinner.clear();
+  }
 
-  for (auto&& [entityId, p_transform, p_player] :
-       IndexedZipper(transforms, players)) {
-    if (p_player.isAlive) {
-      closestPlayerPos = p_transform.position;
-      break;
+  std::vector<size_t>& of(EnemyType type) {
+    switch (type) {
+      case EnemyType::Basic:
+        return basic;
+      case EnemyType::Zigzag:
+        return zigzag;
+      case EnemyType::Chase:
+        return chase;
+      case EnemyType::mini_Green:
+        return miniGreen;
+      case EnemyType::Spinner:
+        break;
     }
+    return spinner;
   }
+};
 
-  for (auto&& [entityId, transform, rigidbody, enemy] :
-       IndexedZipper(transforms, rigidbodies, enemies)) {
-    enemy.timer += deltaTime;
-    enemy.timeSinceLastShot += deltaTime;
+std::optional<Vector2> nearest_player(const SpatialGrid& playerGrid,
+                                      const Vector2& from) {
+  auto hit = playerGrid.Nearest(from);
+  if (!hit) return std::nullopt;
+  return hit->position;
+}
 
-    switch (enemy.type) {
-      case EnemyType::Basic: {
-        float t = enemy.timer;
-
-        // Zigzag vertical : va en haut puis en bas, oscillation sinusoïdale
-        rigidbody.velocity.x = 0.0f;
-        rigidbody.velocity.y = std::sin(t * 2.0f) * enemy.amplitude * 2.5f;
-
-        // Tir (inchangé)
-        if (enemy.timeSinceLastShot >= 1.5f) {
-          Vector2 pos = transform.position + Vector2{-30.f, 0.f};
-          spawn_projectile(registry, pos, {-1.f, 0.f}, 300.f, entityId);
-          spawn_projectile(registry, pos, {-1.f, -0.3f}, 280.f, entityId);
-          spawn_projectile(registry, pos, {-1.f, 0.3f}, 280.f, entityId);
-          enemy.timeSinceLastShot = 0.f;
-        }
-        break;
+void basic_enemy_kernel(const std::vector<size_t>& bucket,
+                        SparseArray<Transform>& transforms,
+                        SparseArray<RigidBody>& rigidbodies,
+                        SparseArray<Enemy>& enemies,
+                        std::vector<PendingShot>& shots) {
+  for (size_t idx : bucket) {
+    auto& transform = *transforms[idx];
+    auto& rigidbody = *rigidbodies[idx];
+    auto& enemy = *enemies[idx];
+
+    // Zigzag vertical : va en haut puis en bas, oscillation sinusoïdale
+    rigidbody.velocity.x = 0.0f;
+    rigidbody.velocity.y =
+        fast_sin(enemy.timer * 2.0f) * enemy.amplitude * 2.5f;
+
+    // Tir (inchangé)
+    if (enemy.timeSinceLastShot >= 1.5f) {
+      Vector2 pos = transform.position + Vector2{-30.f, 0.f};
+      shots.push_back({pos, {-1.f, 0.f}, 300.f, idx});
+      shots.push_back({pos, {-1.f, -0.3f}, 280.f, idx});
+      shots.push_back({pos, {-1.f, 0.3f}, 280.f, idx});
+      enemy.timeSinceLastShot = 0.f;
+    }
+  }
+}
+
+void zigzag_enemy_kernel(const std::vector<size_t>& bucket,
+                         SparseArray<Transform>& transforms,
+                         SparseArray<RigidBody>& rigidbodies,
+                         SparseArray<Enemy>& enemies,
+                         const SpatialGrid& playerGrid) {
+  static thread_local std::mt19937 gen(std::random_device{}());
+  std::uniform_real_distribution<float> yDist(50.f, 550.f);
+
+  for (size_t idx : bucket) {
+    auto& transform = *transforms[idx];
+    auto& rigidbody = *rigidbodies[idx];
+    auto& enemy = *enemies[idx];
+
+    float speedBoost = 1.f + std::fabs(fast_sin(enemy.timer * 2.f)) * 0.8f;
+    rigidbody.velocity.x = -enemy.speed * speedBoost;
+
+    float zigzag =
+        fast_sin(enemy.timer * 8.f) + fast_sin(enemy.timer * 3.f) * 0.5f;
+    rigidbody.velocity.y = zigzag * enemy.amplitude * 1.5f;
+
+    if (wrap_period(enemy.timer, 3.f) < 0.5f) {
+      auto target = nearest_player(playerGrid, transform.position);
+      if (target.has_value()) {
+        float diff = target->y - transform.position.y;
+        rigidbody.velocity.y += diff * 2.f;
       }
+    }
 
-      case EnemyType::Zigzag: {
-        float speedBoost = 1.f + std::abs(std::sin(enemy.timer * 2.f)) * 0.8f;
-        rigidbody.velocity.x = -enemy.speed * speedBoost;
+    if (transform.position.x <= -50.f) {
+      transform.position.x = 850.f;
+      transform.position.y = yDist(gen);
+      enemy.timer = 0.f;
+    }
+  }
+}
 
-        float zigzag =
-            std::sin(enemy.timer * 8.f) + std::sin(enemy.timer * 3.f) * 0.5f;
-        rigidbody.velocity.y = zigzag * enemy.amplitude * 1.5f;
+void chase_enemy_kernel(const std::vector<size_t>& bucket,
+                        SparseArray<Transform>& transforms,
+                        SparseArray<RigidBody>& rigidbodies,
+                        SparseArray<Enemy>& enemies,
+                        const SpatialGrid& playerGrid) {
+  for (size_t idx : bucket) {
+    auto& transform = *transforms[idx];
+    auto& rigidbody = *rigidbodies[idx];
+    auto& enemy = *enemies[idx];
+
+    auto target = nearest_player(playerGrid, transform.position);
+    if (!target.has_value()) {
+      rigidbody.velocity.x = fast_cos(enemy.timer * 2.f) * enemy.speed;
+      rigidbody.velocity.y = fast_sin(enemy.timer * 2.f) * enemy.speed;
+      continue;
+    }
 
-        if (closestPlayerPos.has_value() && fmod(enemy.timer, 3.f) < 0.5f) {
-          float playerY = closestPlayerPos.value().y;
-          float diff = playerY - transform.position.y;
-          rigidbody.velocity.y += diff * 2.f;
-        }
+    Vector2 toPlayer = target.value() - transform.position;
+    float distance = toPlayer.Length();
+    if (distance <= 0) continue;
+
+    Vector2 dir = toPlayer * (1.f / distance);
+    if (distance > 300.f) {
+      float spiral = enemy.timer * 4.f;
+      rigidbody.velocity.x = dir.x * enemy.speed + fast_cos(spiral) * 80.f;
+      rigidbody.velocity.y = dir.y * enemy.speed + fast_sin(spiral) * 80.f;
+    } else if (distance > 100.f) {
+      rigidbody.velocity.x = dir.x * enemy.speed * 1.8f;
+      rigidbody.velocity.y = dir.y * enemy.speed * 1.8f;
+    } else if (wrap_period(enemy.timer, 2.f) < 0.8f) {
+      rigidbody.velocity.x = -dir.x * enemy.speed * 0.5f;
+      rigidbody.velocity.y = -dir.y * enemy.speed * 0.5f;
+    } else {
+      rigidbody.velocity.x = dir.x * enemy.speed * 2.5f;
+      rigidbody.velocity.y = dir.y * enemy.speed * 2.5f;
+    }
+  }
+}
 
-        if (transform.position.x <= -50.f) {
-          transform.position.x = 850.f;
-          static std::random_device rd;
-          static std::mt19937 gen(rd());
-          std::uniform_real_distribution<float> yDist(50.f, 550.f);
-          transform.position.y = yDist(gen);
-          enemy.timer = 0.f;
-        }
-        break;
-      }
+void mini_green_enemy_kernel(const std::vector<size_t>& bucket,
+                             SparseArray<Transform>& transforms,
+                             SparseArray<RigidBody>& rigidbodies,
+                             SparseArray<Enemy>& enemies,
+                             std::vector<PendingShot>& shots,
+                             float deltaTime) {
+  for (size_t idx : bucket) {
+    auto& transform = *transforms[idx];
+    auto& rigidbody = *rigidbodies[idx];
+    auto& enemy = *enemies[idx];
+
+    float cycle = wrap_period(enemy.timer, 4.f);
+    if (cycle < 2.f) {
+      rigidbody.velocity.x = 0.f;
+      rigidbody.velocity.y = fast_sin(enemy.timer * 3.f) * enemy.amplitude;
+    } else if (cycle < 2.8f) {
+      rigidbody.velocity.x = -enemy.speed * 3.f;
+      rigidbody.velocity.y = 0.f;
+    } else {
+      rigidbody.velocity.x = enemy.speed;
+      rigidbody.velocity.y = 0.f;
+    }
 
-      case EnemyType::Chase: {
-        if (closestPlayerPos.has_value()) {
-          Vector2 toPlayer = closestPlayerPos.value() - transform.position;
-          float distance = toPlayer.Length();
-
-          if (distance > 0) {
-            Vector2 dir = toPlayer.Normalized();
-
-            if (distance > 300.f) {
-              float spiral = enemy.timer * 4.f;
-              rigidbody.velocity.x =
-                  dir.x * enemy.speed + std::cos(spiral) * 80.f;
-              rigidbody.velocity.y =
-                  dir.y * enemy.speed + std::sin(spiral) * 80.f;
-            } else if (distance > 100.f) {
-              rigidbody.velocity.x = dir.x * enemy.speed * 1.8f;
-              rigidbody.velocity.y = dir.y * enemy.speed * 1.8f;
-            } else {
-              if (fmod(enemy.timer, 2.f) < 0.8f) {
-                rigidbody.velocity.x = -dir.x * enemy.speed * 0.5f;
-                rigidbody.velocity.y = -dir.y * enemy.speed * 0.5f;
-              } else {
-                rigidbody.velocity.x = dir.x * enemy.speed * 2.5f;
-                rigidbody.velocity.y = dir.y * enemy.speed * 2.5f;
-              }
-            }
-          }
-        } else {
-          rigidbody.velocity.x = std::cos(enemy.timer * 2.f) * enemy.speed;
-          rigidbody.velocity.y = std::sin(enemy.timer * 2.f) * enemy.speed;
-        }
-        break;
-      }
-      case EnemyType::mini_Green: {
-        float cycle = fmod(enemy.timer, 4.f);
-
-        if (cycle < 2.f) {
-          rigidbody.velocity.x = 0.f;
-          rigidbody.velocity.y = std::sin(enemy.timer * 3.f) * enemy.amplitude;
-        } else if (cycle < 2.8f) {
-          rigidbody.velocity.x = -enemy.speed * 3.f;
-          rigidbody.velocity.y = 0.f;
-        } else {
-          rigidbody.velocity.x = enemy.speed;
-          rigidbody.velocity.y = 0.f;
-        }
+    transform.position.x = std::clamp(transform.position.x, 150.f, 750.f);
 
-        transform.position.x = std::clamp(transform.position.x, 150.f, 750.f);
+    enemy.timeSinceLastShot += deltaTime;
+    if (enemy.timeSinceLastShot >= 2.0f) {  // cooldown 2 secondes
+      // offset devant lui, tir vers la gauche
+      shots.push_back(
+          {transform.position + Vector2{-20.f, 0.f}, {-1.f, 0.f}, 300.f, idx});
+      enemy.timeSinceLastShot = 0.f;
+    }
+  }
+}
 
-        enemy.timeSinceLastShot += deltaTime;
-        if (enemy.timeSinceLastShot >= 2.0f) {  // cooldown 2 secondes
-          Vector2 pos =
-              transform.position + Vector2{-20.f, 0.f};  // offset devant lui
-          Vector2 dir = {-1.f, 0.f};                     // tirer vers la gauche
-          float speed = 300.f;
-          spawn_projectile(registry, pos, dir, speed, entityId);
-          enemy.timeSinceLastShot = 0.f;
-        }
-        break;
-      }
+void spinner_enemy_kernel(const std::vector<size_t>& bucket,
+                          SparseArray<Transform>& transforms,
+                          SparseArray<RigidBody>& rigidbodies,
+                          SparseArray<Enemy>& enemies, float deltaTime) {
+  static thread_local std::mt19937 gen(std::random_device{}());
+  std::uniform_real_distribution<float> yDist(-1.f, 1.f);
+  std::uniform_real_distribution<float> yPosDist(50.f, 250.f);
+
+  for (size_t idx : bucket) {
+    auto& transform = *transforms[idx];
+    auto& rigidbody = *rigidbodies[idx];
+    auto& enemy = *enemies[idx];
+
+    if (wrap_period(enemy.timer, 0.3f) < deltaTime) {
+      enemy.direction.y = yDist(gen);
+    }
 
-      case EnemyType::Spinner: {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+    rigidbody.velocity.x = -enemy.speed * 2.f;
+    rigidbody.velocity.y = enemy.direction.y * enemy.amplitude * 3.f;
+    if (transform.position.x <= -50.f) {
+      transform.position.x = 250.f;
+      transform.position.y = yPosDist(gen);
+    }
+  }
+}
 
-        if (fmod(enemy.timer, 0.3f) < deltaTime) {
-          std::uniform_real_distribution<float> yDist(-1.f, 1.f);
-          enemy.direction.y = yDist(gen);
-        }
+}  // namespace
 
-        rigidbody.velocity.x = -enemy.speed * 2.f;
-        rigidbody.velocity.y = enemy.direction.y * enemy.amplitude * 3.f;
-        if (transform.position.x <= -50.f) {
-          transform.position.x = 250.f;
-          std::uniform_real_distribution<float> yPosDist(50.f, 250.f);
-          transform.position.y = yPosDist(gen);
-        }
-      } break;
-    }
+void enemy_movement_system(Registry& registry,
+                           SparseArray<Transform>& transforms,
+                           SparseArray<RigidBody>& rigidbodies,
+                           SparseArray<Enemy>& enemies,
+                           const SpatialGrid& playerGrid, float deltaTime) {
+  static thread_local EnemyBuckets buckets;
+  static thread_local std::vector<PendingShot> shots;
+  buckets.clear();
+  shots.clear();
+
+  // Une passe pour les timers et le tri par type, puis une boucle serree
+  // par comportement
+  for (auto&& [entityId, transform, rigidbody, enemy] :
+       IndexedZipper(transforms, rigidbodies, enemies)) {
+    enemy.timer += deltaTime;
+    enemy.timeSinceLastShot += deltaTime;
+    buckets.of(enemy.type).push_back(entityId);
+  }
+
+  basic_enemy_kernel(buckets.basic, transforms, rigidbodies, enemies, shots);
+  zigzag_enemy_kernel(buckets.zigzag, transforms, rigidbodies, enemies,
+                      playerGrid);
+  chase_enemy_kernel(buckets.chase, transforms, rigidbodies, enemies,
+                     playerGrid);
+  mini_green_enemy_kernel(buckets.miniGreen, transforms, rigidbodies, enemies,
+                          shots, deltaTime);
+  spinner_enemy_kernel(buckets.spinner, transforms, rigidbodies, enemies,
+                       deltaTime);
+
+  for (const auto& shot : shots) {
+    spawn_projectile(registry, shot.position, shot.direction, shot.speed,
+                     shot.ownerId);
   }
 }
 
@@ -8,6 +8,7 @@
 #include "components/Player/Projectile.hpp"
 #include "ecs/Registry.hpp"
 #include "ecs/Zipper.hpp"
+#include "systems/SpatialQuery.hpp"
 
 void player_movement_system(Registry& registry);
 
@@ -15,7 +16,7 @@ void enemy_movement_system(Registry& registry,
                            SparseArray<Transform>& transforms,
                            SparseArray<RigidBody>& rigidbodies,
                            SparseArray<Enemy>& enemies,
-                           SparseArray<PlayerEntity>& players, float deltaTime);
+                           const SpatialGrid& playerGrid, float deltaTime);
 
 void Projectile_movement_system(SparseArray<Transform>& transforms,
                                 SparseArray<RigidBody>& rigidbodies,
@@ -1,7 +1,5 @@
 #include "systems/ProjectileSystem.hpp"
 
-#include <SDL2/SDL.h>
-
 #include <algorithm>
 #include <iostream>
 #include <string>
@@ -11,7 +9,6 @@
 #include "Player/Enemy.hpp"
 #include "components/BossPart.hpp"
 #include "ecs/Zipper.hpp"
-#include "rendering/RenderingSubsystem.hpp"
 #include "systems/Collision/Collision.hpp"
 #include "systems/PhysicsSystem.hpp"
 
@@ -124,11 +121,13 @@ void apply_projectile_damage(Registry& registry, size_t targetId, float damage,
 void projectile_collision_system(Registry& registry,
                                  const SparseArray<Transform>& transforms,
                                  const SparseArray<BoxCollider>& colliders,
-                                 SparseArray<Projectile>& projectiles) {
+                                 SparseArray<Projectile>& projectiles,
+                                 float deltaTime) {
   auto& enemies = registry.get_components<Enemy>();
   auto& players = registry.get_components<PlayerEntity>();
   auto& bosses = registry.get_components<Boss>();
   auto& bossParts = registry.get_components<BossPart>();
+  auto& rigidbodies = registry.get_components<RigidBody>();
   std::vector<size_t> toKill;
 
   auto get_owner_type = [&](size_t ownerId) -> std::string {
@@ -144,6 +143,14 @@ void projectile_collision_system(Registry& registry,
     return "Unknown";
   };
 
+  // Deplacement d'une entite pendant ce tick (0 si pas de RigidBody)
+  auto get_displacement = [&](size_t idx) -> Vector2 {
+    if (idx < rigidbodies.size() && rigidbodies[idx].has_value()) {
+      return rigidbodies[idx]->velocity * deltaTime;
+    }
+    return Vector2(0.0f, 0.0f);
+  };
+
   for (auto&& [projIdx, projectile, projTransform, projCollider] :
        IndexedZipper(projectiles, transforms, colliders)) {
     if (!projectile.isActive) continue;
@@ -153,6 +160,16 @@ void projectile_collision_system(Registry& registry,
       continue;
     }
 
+    // Pour les projectiles rapides on garde l'impact le plus proche sur la
+    // trajectoire du tick, sinon le premier contact suffit
+    Vector2 projDelta = projectile.fastMover && projectile.hasTravelled()
+                            ? get_displacement(projIdx)
+                            : Vector2(0, 0);
+    Vector2 projStart = projTransform.position - projDelta;
+    bool hit = false;
+    size_t hitIdx = 0;
+    float bestToi = 1.0f;
+
     for (auto&& [targetIdx, targetTransform, targetCollider] :
          IndexedZipper(transforms, colliders)) {
       if (projIdx == targetIdx) continue;
@@ -183,15 +200,37 @@ void projectile_collision_system(Registry& registry,
 
       if (!validCollision) continue;
 
-      if (check_collision(projTransform, projCollider, targetTransform,
-                          targetCollider)) {
-        apply_projectile_damage(registry, targetIdx, projectile.damage,
-                                projectile.ownerId);
-        projectile.isActive = false;
-        registry.kill_entity(Entity(projIdx));
-        break;
+      if (!projectile.fastMover) {
+        if (check_collision(projTransform, projCollider, targetTransform,
+                            targetCollider)) {
+          hit = true;
+          hitIdx = targetIdx;
+          break;
+        }
+        continue;
+      }
+
+      // Mouvement relatif : la cible est ramenee a sa position de debut de
+      // tick et le projectile balaie le deplacement relatif
+      Vector2 targetDelta = get_displacement(targetIdx);
+      Transform targetStart = targetTransform;
+      targetStart.position = targetTransform.position - targetDelta;
+      float toi = 0.0f;
+      if (swept_collision(projStart, projCollider, projDelta - targetDelta,
+                          targetStart, targetCollider, toi) &&
+          (!hit || toi < bestToi)) {
+        hit = true;
+        hitIdx = targetIdx;
+        bestToi = toi;
       }
     }
+
+    if (hit) {
+      apply_projectile_damage(registry, hitIdx, projectile.damage,
+                              projectile.ownerId);
+      projectile.isActive = false;
+      registry.kill_entity(Entity(projIdx));
+    }
   }
 }
 
@@ -222,7 +261,7 @@ Entity spawn_projectile(Registry& registry, Vector2 position, Vector2 direction,
 
   // Projectile component
   registry.emplace_component<Projectile>(projectile, 10.0f, speed, direction,
-                                         3.0f, ownerId);
+                                         3.0f, ownerId, 0, true);
 
   return projectile;
 }
@@ -240,7 +279,7 @@ Entity spawn_player_projectile(Registry& registry, Vector2 position,
   registry.emplace_component<BoxCollider>(projectile, 19.0f, 19.0f);
 
   registry.emplace_component<Projectile>(projectile, 10.0f, speed, direction,
-                                         3.0f, ownerId);
+                                         3.0f, ownerId, 0, true);
 
   return projectile;
 }
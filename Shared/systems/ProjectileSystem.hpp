@@ -10,7 +10,8 @@ void projectile_lifetime_system(Registry& registry,
 void projectile_collision_system(Registry& registry,
                                  const SparseArray<Transform>& transforms,
                                  const SparseArray<BoxCollider>& colliders,
-                                 SparseArray<Projectile>& projectiles);
+                                 SparseArray<Projectile>& projectiles,
+                                 float deltaTime);
 
 Entity spawn_projectile(Registry& registry, Vector2 position, Vector2 direction,
                         float speed, size_t ownerId);
@@ -0,0 +1,110 @@
+#include "systems/SpatialQuery.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize) : m_cellSize(cellSize) {}
+
+void SpatialGrid::Clear() {
+  m_entries.clear();
+  m_minX = m_minY = 0;
+  m_maxX = m_maxY = -1;
+}
+
+void SpatialGrid::Insert(size_t entity, const Vector2& position) {
+  int cx = CellCoord(position.x);
+  int cy = CellCoord(position.y);
+  if (m_entries.empty()) {
+    m_minX = m_maxX = cx;
+    m_minY = m_maxY = cy;
+  } else {
+    m_minX = std::min(m_minX, cx);
+    m_maxX = std::max(m_maxX, cx);
+    m_minY = std::min(m_minY, cy);
+    m_maxY = std::max(m_maxY, cy);
+  }
+  m_entries.push_back({CellKey(cx, cy), entity, position});
+}
+
+void SpatialGrid::Build() {
+  std::sort(m_entries.begin(), m_entries.end(),
+            [](const Entry& a, const Entry& b) { return a.cell < b.cell; });
+}
+
+int SpatialGrid::CellCoord(float v) const {
+  return static_cast<int>(std::floor(v / m_cellSize));
+}
+
+int64_t SpatialGrid::CellKey(int cx, int cy) {
+  return (static_cast<int64_t>(cx) << 32) |
+         static_cast<int64_t>(static_cast<uint32_t>(cy));
+}
+
+size_t SpatialGrid::QueryNearest(const Vector2& from, float radius, size_t k,
+                                 std::vector<SpatialHit>& out) const {
+  out.clear();
+  if (m_entries.empty() || k == 0 || radius < 0.0f) return 0;
+
+  const float radiusSq = radius * radius;
+  const int cx = CellCoord(from.x);
+  const int cy = CellCoord(from.y);
+
+  // Nombre d'anneaux necessaires pour couvrir toute la grille
+  int maxRing = std::max({std::abs(cx - m_minX), std::abs(cx - m_maxX),
+                          std::abs(cy - m_minY), std::abs(cy - m_maxY)});
+  if (std::isfinite(radius)) {
+    maxRing =
+        std::min(maxRing, static_cast<int>(std::ceil(radius / m_cellSize)));
+  }
+
+  auto visitCell = [&](int x, int y) {
+    if (x < m_minX || x > m_maxX || y < m_minY || y > m_maxY) return;
+    int64_t key = CellKey(x, y);
+    auto range = std::equal_range(
+        m_entries.begin(), m_entries.end(), Entry{key, 0, {}},
+        [](const Entry& a, const Entry& b) { return a.cell < b.cell; });
+    for (auto it = range.first; it != range.second; ++it) {
+      Vector2 d = it->position - from;
+      float distSq = d.x * d.x + d.y * d.y;
+      if (distSq > radiusSq) continue;
+      if (out.size() == k && distSq >= out.back().distanceSq) continue;
+
+      SpatialHit hit{it->entity, it->position, distSq};
+      auto pos = std::upper_bound(
+          out.begin(), out.end(), hit,
+          [](const SpatialHit& a, const SpatialHit& b) {
+            return a.distanceSq < b.distanceSq;
+          });
+      out.insert(pos, hit);
+      if (out.size() > k) out.pop_back();
+    }
+  };
+
+  for (int ring = 0; ring <= maxRing; ++ring) {
+    // Tout point de l'anneau `ring` est a au moins (ring - 1) cellules
+    if (ring > 0 && out.size() == k) {
+      float minDist = (ring - 1) * m_cellSize;
+      if (out.back().distanceSq <= minDist * minDist) break;
+    }
+    if (ring == 0) {
+      visitCell(cx, cy);
+      continue;
+    }
+    for (int x = cx - ring; x <= cx + ring; ++x) {
+      visitCell(x, cy - ring);
+      visitCell(x, cy + ring);
+    }
+    for (int y = cy - ring + 1; y <= cy + ring - 1; ++y) {
+      visitCell(cx - ring, y);
+      visitCell(cx + ring, y);
+    }
+  }
+  return out.size();
+}
+
+std::optional<SpatialHit> SpatialGrid::Nearest(const Vector2& from,
+                                               float radius) const {
+  thread_local std::vector<SpatialHit> hits;
+  if (QueryNearest(from, radius, 1, hits) == 0) return std::nullopt;
+  return hits.front();
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "ecs/Registry.hpp"
+#include "ecs/Zipper.hpp"
+#include "physics/Physics2D.hpp"
+
+struct SpatialHit {
+  size_t entity;
+  Vector2 position;
+  float distanceSq;
+};
+
+/**
+ * @brief Grille uniforme sur les Transform, reconstruite une fois par tick
+ *
+ * Les entrees sont triees par cellule : une cellule se retrouve par
+ * recherche binaire et les requetes parcourent les cellules en anneaux
+ * autour du point, en s'arretant des que les k meilleurs sont trouves.
+ */
+class SpatialGrid {
+ public:
+  explicit SpatialGrid(float cellSize = 128.0f);
+
+  void Clear();
+  void Insert(size_t entity, const Vector2& position);
+  void Build();
+
+  // Remplit la grille avec les entites ayant Transform + Component
+  // pour lesquelles keep(component) est vrai
+  template <typename Component, typename Filter>
+  void Rebuild(SparseArray<Transform>& transforms,
+               SparseArray<Component>& components, Filter keep) {
+    Clear();
+    for (auto&& [idx, transform, component] :
+         IndexedZipper(transforms, components)) {
+      if (keep(component)) Insert(idx, transform.position);
+    }
+    Build();
+  }
+
+  // Les k entites les plus proches de `from` dans `radius`, triees par
+  // distance. Renvoie le nombre de resultats ecrits dans `out`.
+  size_t QueryNearest(const Vector2& from, float radius, size_t k,
+                      std::vector<SpatialHit>& out) const;
+
+  std::optional<SpatialHit> Nearest(
+      const Vector2& from,
+      float radius = std::numeric_limits<float>::infinity()) const;
+
+  size_t Size() const { return m_entries.size(); }
+
+ private:
+  struct Entry {
+    int64_t cell;
+    size_t entity;
+    Vector2 position;
+  };
+
+  int CellCoord(float v) const;
+  static int64_t CellKey(int cx, int cy);
+
+  float m_cellSize;
+  std::vector<Entry> m_entries;
+  int m_minX = 0, m_maxX = -1, m_minY = 0, m_maxY = -1;
+};
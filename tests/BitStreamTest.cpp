@@ -0,0 +1,156 @@
+#include "network/BitStream.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace {
+
+void TestWidths() {
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.write(1, 1);
+  writer.write(0x55, 7);
+  writer.write(0xDEADBEEF, 32);
+  writer.write(0, 1);
+  writer.write(0x7F, 7);
+  writer.write(0xFFFFFFFF, 32);
+  writer.write(0x12345678, 32);
+  writer.flush();
+  CHECK_EQ(buffer.size(), 14u);  // 112 bits, alignes sur l'octet
+  CHECK_EQ(buffer[0], 0xD5);
+
+  BitReader reader(buffer.data(), buffer.size());
+  uint32_t value = 0;
+  CHECK(reader.read(1, value) && value == 1);
+  CHECK(reader.read(7, value) && value == 0x55);
+  CHECK(reader.read(32, value) && value == 0xDEADBEEF);
+  CHECK(reader.read(1, value) && value == 0);
+  CHECK(reader.read(7, value) && value == 0x7F);
+  CHECK(reader.read(32, value) && value == 0xFFFFFFFF);
+  CHECK(reader.read(32, value) && value == 0x12345678);
+  CHECK(!reader.read(1, value));
+}
+
+void TestValueMaskedToWidth() {
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.write(0xFF, 1);  // Seul le bit de poids faible est ecrit
+  writer.write(0, 7);
+  CHECK_EQ(buffer.size(), 1u);
+  CHECK_EQ(buffer[0], 0x80);
+}
+
+void TestFlushPadding() {
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.flush();
+  CHECK(buffer.empty());
+
+  writer.write(0b101, 3);
+  writer.flush();
+  CHECK_EQ(buffer.size(), 1u);
+  CHECK_EQ(buffer[0], 0xA0);
+  writer.flush();
+  CHECK_EQ(buffer.size(), 1u);
+}
+
+void TestVarints() {
+  const uint32_t values[] = {0, 1, 127, 128, 300, 16383, 16384, 0xFFFFFFFF};
+  const int32_t signedValues[] = {0, -1, 1, -64, 64, INT32_MIN, INT32_MAX};
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.write(1, 3);  // Les varints ne sont pas forcement alignes
+  for (uint32_t v : values) writer.writeVarint(v);
+  for (int32_t v : signedValues) writer.writeSigned(v);
+  writer.flush();
+
+  BitReader reader(buffer.data(), buffer.size());
+  uint32_t skip = 0;
+  CHECK(reader.read(3, skip));
+  for (uint32_t v : values) {
+    uint32_t read = 0;
+    CHECK(reader.readVarint(read) && read == v);
+  }
+  for (int32_t v : signedValues) {
+    int32_t read = 0;
+    CHECK(reader.readSigned(read) && read == v);
+  }
+}
+
+void TestVarintSizes() {
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.writeVarint(127);
+  CHECK_EQ(buffer.size(), 1u);
+  writer.writeVarint(128);
+  CHECK_EQ(buffer.size(), 3u);
+  writer.writeSigned(-1);  // zigzag : 1
+  CHECK_EQ(buffer.size(), 4u);
+  CHECK_EQ(buffer[3], 0x01);
+}
+
+void TestTruncatedRead() {
+  std::vector<uint8_t> buffer;
+  BitWriter writer(buffer);
+  writer.write(0xABCDEF, 24);
+  writer.writeVarint(1u << 20);
+
+  // Le varint est coupe : la lecture echoue au lieu de lire hors du buffer
+  BitReader reader(buffer.data(), buffer.size() - 1);
+  uint32_t value = 0;
+  CHECK(reader.read(24, value) && value == 0xABCDEF);
+  CHECK(!reader.readVarint(value));
+
+  BitReader partial(buffer.data(), 2);
+  CHECK(!partial.read(32, value));
+  CHECK(partial.read(12, value) && value == 0xABC);
+  CHECK(!partial.read(5, value));
+  CHECK(partial.read(4, value) && value == 0xD);
+  CHECK(!partial.read(1, value));
+
+  BitReader empty(nullptr, 0);
+  CHECK(!empty.read(1, value));
+  int32_t signedValue = 0;
+  CHECK(!empty.readSigned(signedValue));
+  CHECK(empty.read(0, value));
+}
+
+void TestQuantize() {
+  using namespace quant;
+  const uint32_t steps = (1u << POS_X_BITS) - 1;
+  CHECK_EQ(quantize(POS_X_MIN, POS_X_MIN, POS_X_RANGE, POS_X_BITS), 0u);
+  CHECK_EQ(quantize(-1000.0f, POS_X_MIN, POS_X_RANGE, POS_X_BITS), 0u);
+  CHECK_EQ(quantize(NAN, POS_X_MIN, POS_X_RANGE, POS_X_BITS), 0u);
+  CHECK_EQ(quantize(POS_X_MIN + POS_X_RANGE, POS_X_MIN, POS_X_RANGE,
+                    POS_X_BITS),
+           steps);
+  CHECK_EQ(quantize(1e9f, POS_X_MIN, POS_X_RANGE, POS_X_BITS), steps);
+
+  // Aller-retour a un demi-pas pres sur toute la plage
+  const float step = POS_X_RANGE / steps;
+  for (float x = POS_X_MIN; x <= POS_X_MIN + POS_X_RANGE; x += 7.3f) {
+    uint32_t q = quantize(x, POS_X_MIN, POS_X_RANGE, POS_X_BITS);
+    CHECK(q <= steps);
+    float back = dequantize(q, POS_X_MIN, POS_X_RANGE, POS_X_BITS);
+    CHECK(std::fabs(back - x) <= step / 2 + 1e-3f);
+  }
+  CHECK_EQ(dequantize(0, VEL_MIN, VEL_RANGE, VEL_BITS), VEL_MIN);
+  CHECK_EQ(dequantize((1u << VEL_BITS) - 1, VEL_MIN, VEL_RANGE, VEL_BITS),
+           VEL_MIN + VEL_RANGE);
+}
+
+}  // namespace
+
+int main() {
+  TestWidths();
+  TestValueMaskedToWidth();
+  TestFlushPadding();
+  TestVarints();
+  TestVarintSizes();
+  TestTruncatedRead();
+  TestQuantize();
+  return check::Result();
+}
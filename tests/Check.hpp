@@ -0,0 +1,31 @@
+#pragma once
+
+#include <iostream>
+
+/**
+ * @brief Minimal checks for the unit tests, without a test framework
+ *
+ * A failed check prints its file, line and expression and the test keeps
+ * going; main() returns check::Result(), non zero if anything failed, which
+ * is what ctest looks at.
+ */
+namespace check {
+inline int failures = 0;
+
+inline void Fail(const char* file, int line, const char* expr) {
+  std::cerr << file << ":" << line << ": check failed: " << expr << std::endl;
+  failures++;
+}
+
+inline int Result() {
+  if (failures > 0) std::cerr << failures << " check(s) failed" << std::endl;
+  return failures > 0 ? 1 : 0;
+}
+}  // namespace check
+
+#define CHECK(expr)                                     \
+  do {                                                  \
+    if (!(expr)) check::Fail(__FILE__, __LINE__, #expr); \
+  } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
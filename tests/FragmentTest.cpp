@@ -0,0 +1,209 @@
+#include "network/Fragment.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace {
+
+using Clock = FragmentAssembler::Clock;
+using std::chrono::milliseconds;
+
+/**
+ * @brief Encoded UDP packet: type, flags, length, seq, ack, ack bits
+ */
+std::vector<uint8_t> Packet(size_t payload, uint8_t seed) {
+  std::vector<uint8_t> packet(fragment::UDP_HEADER + payload);
+  packet[0] = 0x21;
+  packet[1] = 0x02;
+  fragment::writeU32(&packet[2], static_cast<uint32_t>(payload));
+  fragment::writeU16(&packet[6], 100);
+  fragment::writeU16(&packet[8], 55);
+  fragment::writeU32(&packet[10], 0xF0F0F0F0);
+  for (size_t i = 0; i < payload; ++i) {
+    packet[fragment::UDP_HEADER + i] = static_cast<uint8_t>(i * 31 + seed);
+  }
+  return packet;
+}
+
+std::vector<std::vector<uint8_t>> Split(const std::vector<uint8_t>& packet,
+                                        uint16_t messageId) {
+  size_t count = fragment::countFor(packet);
+  std::vector<std::vector<uint8_t>> fragments;
+  for (size_t i = 0; i < count; ++i) {
+    fragments.push_back(fragment::make(packet, messageId,
+                                       static_cast<uint8_t>(i),
+                                       static_cast<uint8_t>(count),
+                                       static_cast<uint16_t>(200 + i)));
+  }
+  return fragments;
+}
+
+void TestCountFor() {
+  CHECK_EQ(fragment::countFor(Packet(0, 0)), 1u);
+  CHECK_EQ(fragment::countFor(Packet(fragment::MAX_DATAGRAM -
+                                         fragment::UDP_HEADER, 0)),
+           1u);
+  CHECK_EQ(fragment::countFor(Packet(fragment::MAX_SLICE * 3, 0)), 3u);
+  CHECK_EQ(fragment::countFor(Packet(fragment::MAX_SLICE * 3 + 1, 0)), 4u);
+  CHECK_EQ(fragment::countFor(
+               Packet(fragment::MAX_SLICE * fragment::MAX_FRAGMENTS, 0)),
+           fragment::MAX_FRAGMENTS);
+  CHECK_EQ(fragment::countFor(
+               Packet(fragment::MAX_SLICE * fragment::MAX_FRAGMENTS + 1, 0)),
+           0u);
+}
+
+void TestMakeAndParse() {
+  std::vector<uint8_t> packet = Packet(3000, 1);
+  std::vector<std::vector<uint8_t>> fragments = Split(packet, 7);
+  CHECK_EQ(fragments.size(), 3u);
+
+  size_t payload = 0;
+  for (size_t i = 0; i < fragments.size(); ++i) {
+    const auto& f = fragments[i];
+    CHECK(f.size() <= fragment::MAX_DATAGRAM);
+    CHECK(fragment::isFragment(f));
+    fragment::Header header;
+    CHECK(fragment::parse(f, header));
+    CHECK_EQ(header.seq, 200 + i);
+    CHECK_EQ(header.ack, 55);
+    CHECK_EQ(header.ackBits, 0xF0F0F0F0u);
+    CHECK_EQ(header.messageId, 7);
+    CHECK_EQ(header.index, i);
+    CHECK_EQ(header.count, 3);
+    payload += f.size() - fragment::UDP_HEADER - fragment::HEADER;
+  }
+  CHECK_EQ(payload, 3000u);
+}
+
+void TestParseRejectsMalformed() {
+  std::vector<uint8_t> good = Split(Packet(3000, 2), 1)[0];
+  fragment::Header header;
+
+  std::vector<uint8_t> shortPacket(good.begin(),
+                                   good.begin() + fragment::UDP_HEADER + 3);
+  CHECK(!fragment::parse(shortPacket, header));
+
+  std::vector<uint8_t> noFlag = good;
+  noFlag[1] &= static_cast<uint8_t>(~fragment::FLAG_FRAGMENT);
+  CHECK(!fragment::parse(noFlag, header));
+
+  std::vector<uint8_t> badLength = good;
+  badLength.pop_back();
+  CHECK(!fragment::parse(badLength, header));
+
+  std::vector<uint8_t> zeroCount = good;
+  zeroCount[fragment::UDP_HEADER + 3] = 0;
+  CHECK(!fragment::parse(zeroCount, header));
+
+  std::vector<uint8_t> tooMany = good;
+  tooMany[fragment::UDP_HEADER + 3] = fragment::MAX_FRAGMENTS + 1;
+  CHECK(!fragment::parse(tooMany, header));
+
+  std::vector<uint8_t> badIndex = good;
+  badIndex[fragment::UDP_HEADER + 2] = 3;
+  CHECK(!fragment::parse(badIndex, header));
+}
+
+void TestReverseOrderWithDuplicate() {
+  std::vector<uint8_t> packet = Packet(3000, 3);
+  std::vector<std::vector<uint8_t>> fragments = Split(packet, 9);
+  FragmentAssembler assembler;
+  Clock::time_point now = Clock::now();
+
+  CHECK(!assembler.add(fragments[2], now));
+  CHECK(!assembler.add(fragments[2], now));  // Doublon
+  CHECK(!assembler.add(fragments[1], now));
+  std::optional<std::vector<uint8_t>> whole =
+      assembler.add(fragments[0], now);
+  CHECK(whole.has_value());
+  if (whole) {
+    // Paquet d'origine, avec le seq et les acks du dernier fragment recu
+    std::vector<uint8_t> expected = packet;
+    fragment::writeU16(&expected[6], 200);
+    CHECK(*whole == expected);
+    CHECK(!fragment::isFragment(*whole));
+  }
+
+  // Copie tardive d'un message deja reconstruit
+  CHECK(!assembler.add(fragments[1], now));
+  CHECK_EQ(assembler.expired, 0u);
+}
+
+void TestTimeout() {
+  std::vector<std::vector<uint8_t>> fragments = Split(Packet(3000, 4), 11);
+  FragmentAssembler assembler;
+  Clock::time_point now = Clock::now();
+
+  CHECK(!assembler.add(fragments[0], now));
+  CHECK(!assembler.add(fragments[1], now));
+  assembler.expire(now + FragmentAssembler::TIMEOUT);
+  CHECK_EQ(assembler.expired, 0u);
+  assembler.expire(now + FragmentAssembler::TIMEOUT + milliseconds(1));
+  CHECK_EQ(assembler.expired, 1u);
+
+  // Les fragments recus avant l'expiration sont perdus
+  Clock::time_point later = now + milliseconds(3000);
+  CHECK(!assembler.add(fragments[2], later));
+  CHECK(!assembler.add(fragments[0], later));
+  CHECK(assembler.add(fragments[1], later).has_value());
+}
+
+void TestMaxPendingEviction() {
+  FragmentAssembler assembler;
+  Clock::time_point now = Clock::now();
+  std::vector<std::vector<std::vector<uint8_t>>> messages;
+  for (uint16_t id = 0; id <= FragmentAssembler::MAX_PENDING; ++id) {
+    messages.push_back(Split(Packet(3000, static_cast<uint8_t>(id)), id));
+  }
+
+  for (uint16_t id = 0; id < FragmentAssembler::MAX_PENDING; ++id) {
+    CHECK(!assembler.add(messages[id][0], now + milliseconds(id)));
+  }
+  CHECK_EQ(assembler.expired, 0u);
+
+  // Un message de plus : le plus ancien (0) est abandonne
+  const uint16_t extra = FragmentAssembler::MAX_PENDING;
+  CHECK(!assembler.add(messages[extra][0], now + milliseconds(extra)));
+  CHECK_EQ(assembler.expired, 1u);
+
+  for (uint16_t id = 1; id <= extra; ++id) {
+    CHECK(!assembler.add(messages[id][1], now + milliseconds(20)));
+    CHECK(assembler.add(messages[id][2], now + milliseconds(20)).has_value());
+  }
+  // Le message 0 repart de zero
+  CHECK(!assembler.add(messages[0][1], now + milliseconds(30)));
+  CHECK(!assembler.add(messages[0][2], now + milliseconds(30)));
+  CHECK(assembler.add(messages[0][0], now + milliseconds(30)).has_value());
+}
+
+void TestCountMismatch() {
+  std::vector<std::vector<uint8_t>> fragments = Split(Packet(3000, 5), 13);
+  FragmentAssembler assembler;
+  Clock::time_point now = Clock::now();
+  CHECK(!assembler.add(fragments[0], now));
+
+  // Meme id mais un autre nombre de fragments : ignore
+  std::vector<uint8_t> other = fragments[1];
+  other[fragment::UDP_HEADER + 3] = 4;
+  CHECK(!assembler.add(other, now));
+  CHECK(!assembler.add(fragments[1], now));
+  CHECK(assembler.add(fragments[2], now).has_value());
+}
+
+}  // namespace
+
+int main() {
+  TestCountFor();
+  TestMakeAndParse();
+  TestParseRejectsMalformed();
+  TestReverseOrderWithDuplicate();
+  TestTimeout();
+  TestMaxPendingEviction();
+  TestCountMismatch();
+  return check::Result();
+}
@@ -0,0 +1,81 @@
+#include "IdIndex.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace {
+
+struct Item {
+  uint16_t id;
+};
+
+uint16_t IdOf(const Item& item) { return item.id; }
+
+void TestEmpty() {
+  IdIndex index;
+  CHECK_EQ(index.Find(0), IdIndex::NONE);  // Jamais construit
+
+  std::vector<Item> none;
+  index.Build(none, IdOf);
+  CHECK_EQ(index.Find(0), IdIndex::NONE);
+  CHECK_EQ(index.Find(42), IdIndex::NONE);
+}
+
+void TestFindsEveryPosition() {
+  std::vector<Item> items;
+  for (uint16_t i = 0; i < 300; ++i) items.push_back({uint16_t(i * 7 + 3)});
+  IdIndex index;
+  index.Build(items, IdOf);
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    CHECK_EQ(index.Find(items[i].id), static_cast<int32_t>(i));
+  }
+  CHECK_EQ(index.Find(4), IdIndex::NONE);
+  CHECK_EQ(index.Find(0xFFFF), IdIndex::NONE);
+}
+
+void TestCollidingIds() {
+  // Ids egaux modulo la taille de la table : toutes les sondes se suivent
+  std::vector<Item> items = {{5}, {5 + 16}, {5 + 32}, {5 + 48}, {6}};
+  IdIndex index;
+  index.Build(items, IdOf);
+  CHECK_EQ(index.Find(5), 0);
+  CHECK_EQ(index.Find(5 + 16), 1);
+  CHECK_EQ(index.Find(5 + 32), 2);
+  CHECK_EQ(index.Find(5 + 48), 3);
+  CHECK_EQ(index.Find(6), 4);
+  CHECK_EQ(index.Find(5 + 64), IdIndex::NONE);
+}
+
+void TestDuplicateKeepsFirst() {
+  std::vector<Item> items = {{9}, {1}, {9}};
+  IdIndex index;
+  index.Build(items, IdOf);
+  CHECK_EQ(index.Find(9), 0);
+  CHECK_EQ(index.Find(1), 1);
+}
+
+void TestRebuildForgetsOldIds() {
+  IdIndex index;
+  std::vector<Item> first = {{1}, {2}, {3}};
+  index.Build(first, IdOf);
+  std::vector<Item> second = {{3}, {4}};
+  index.Build(second, IdOf);
+  CHECK_EQ(index.Find(1), IdIndex::NONE);
+  CHECK_EQ(index.Find(2), IdIndex::NONE);
+  CHECK_EQ(index.Find(3), 0);
+  CHECK_EQ(index.Find(4), 1);
+}
+
+}  // namespace
+
+int main() {
+  TestEmpty();
+  TestFindsEveryPosition();
+  TestCollidingIds();
+  TestDuplicateKeepsFirst();
+  TestRebuildForgetsOldIds();
+  return check::Result();
+}
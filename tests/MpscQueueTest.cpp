@@ -0,0 +1,118 @@
+#include "MpscQueue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Check.hpp"
+
+namespace {
+
+void TestCapacityRoundsUp() {
+  CHECK_EQ(MpscQueue<int>(3).Capacity(), 4u);
+  CHECK_EQ(MpscQueue<int>(4).Capacity(), 4u);
+  CHECK_EQ(MpscQueue<int>(1).Capacity(), 2u);
+}
+
+void TestFifoAndFull() {
+  MpscQueue<int> queue(4);
+  CHECK(queue.Empty());
+  CHECK(!queue.TryPop().has_value());
+
+  for (int i = 0; i < 4; ++i) CHECK(queue.TryPush(i));
+  CHECK(!queue.TryPush(99));  // Plein : rejete, pas bloque
+  CHECK_EQ(queue.Size(), 4u);
+
+  QueueStats stats = queue.Stats();
+  CHECK_EQ(stats.pushed, 4u);
+  CHECK_EQ(stats.dropped, 1u);
+  CHECK_EQ(stats.highWater, 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    auto item = queue.TryPop();
+    CHECK(item.has_value() && *item == i);
+  }
+  CHECK(!queue.TryPop().has_value());
+}
+
+void TestWrapAround() {
+  // Les positions depassent plusieurs fois la capacite
+  MpscQueue<int> queue(4);
+  int next = 0;
+  for (int round = 0; round < 100; ++round) {
+    CHECK(queue.TryPush(round * 3));
+    CHECK(queue.TryPush(round * 3 + 1));
+    CHECK(queue.TryPush(round * 3 + 2));
+    for (int i = 0; i < 3; ++i) {
+      auto item = queue.TryPop();
+      CHECK(item.has_value() && *item == next);
+      next++;
+    }
+  }
+  CHECK(queue.Empty());
+  CHECK_EQ(queue.Stats().dropped, 0u);
+}
+
+void TestMoveOnlyItems() {
+  MpscQueue<std::unique_ptr<int>> queue(2);
+  CHECK(queue.TryPush(std::make_unique<int>(7)));
+  auto item = queue.TryPop();
+  CHECK(item.has_value() && *item && **item == 7);
+}
+
+void TestConcurrentProducers() {
+  // Chaque producteur pousse ses valeurs dans l'ordre : le consommateur doit
+  // toutes les recevoir, dans l'ordre de chaque producteur
+  constexpr int PRODUCERS = 4;
+  constexpr int PER_PRODUCER = 20000;
+  MpscQueue<std::pair<int, int>> queue(64);
+  std::atomic<bool> start{false};
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; ++p) {
+    producers.emplace_back([&queue, &start, p] {
+      while (!start.load()) std::this_thread::yield();
+      for (int i = 0; i < PER_PRODUCER; ++i) {
+        while (!queue.TryPush(std::make_pair(p, i))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<int> expected(PRODUCERS, 0);
+  int received = 0;
+  bool ordered = true;
+  start.store(true);
+  while (received < PRODUCERS * PER_PRODUCER) {
+    auto item = queue.TryPop();
+    if (!item) {
+      std::this_thread::yield();
+      continue;
+    }
+    auto [p, i] = *item;
+    if (p < 0 || p >= PRODUCERS || expected[p] != i) ordered = false;
+    if (p >= 0 && p < PRODUCERS) expected[p] = i + 1;
+    received++;
+  }
+  for (auto& t : producers) t.join();
+
+  CHECK(ordered);
+  CHECK(!queue.TryPop().has_value());
+  for (int p = 0; p < PRODUCERS; ++p) CHECK_EQ(expected[p], PER_PRODUCER);
+  CHECK_EQ(queue.Stats().pushed,
+           static_cast<uint64_t>(PRODUCERS * PER_PRODUCER));
+}
+
+}  // namespace
+
+int main() {
+  TestCapacityRoundsUp();
+  TestFifoAndFull();
+  TestWrapAround();
+  TestMoveOnlyItems();
+  TestConcurrentProducers();
+  return check::Result();
+}
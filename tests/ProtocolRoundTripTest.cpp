@@ -0,0 +1,561 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "Check.hpp"
+#include "network/Action.hpp"
+#include "network/BitStream.hpp"
+#include "network/DataMask.hpp"
+#include "network/DecodeFunc.hpp"
+#include "network/Decoder.hpp"
+#include "network/EncodeFunc.hpp"
+#include "network/Encoder.hpp"
+#include "network/Protocol.hpp"
+
+namespace {
+
+constexpr uint16_t SEQ = 0x1234;
+constexpr uint16_t ACK = 0xBEEF;
+constexpr uint32_t ACK_BITS = 0x80000001;
+
+constexpr uint16_t PLAYER_MASK = M_POS_X | M_POS_Y | M_HP | M_STATE |
+                                 M_SHIELD | M_WEAPON | M_SPRITE | M_SCORE;
+constexpr uint16_t ENEMY_MASK =
+    M_POS_X | M_POS_Y | M_HP | M_STATE | M_TYPE | M_DIR;
+constexpr uint16_t PROJECTILE_MASK =
+    M_POS_X | M_POS_Y | M_TYPE | M_OWNER | M_DAMAGE;
+
+GameState MakeGameState() {
+  GameState state;
+  state.tick = 5000;
+  state.baseTick = 4990;
+  for (uint16_t i = 0; i < 3; ++i) {
+    PlayerState p{};
+    p.playerId = static_cast<uint16_t>(i + 1);
+    p.mask = i == 2 ? static_cast<uint16_t>(M_POS_X) : PLAYER_MASK;
+    p.posX = 100.0f + i;
+    p.posY = 200.0f;
+    p.hp = 3;
+    p.shield = 1;
+    p.weapon = 2;
+    p.state = 4;
+    p.sprite = 5;
+    p.score = 123456;
+    state.players.push_back(p);
+  }
+  EnemyState e{};
+  e.enemyId = 300;
+  e.mask = ENEMY_MASK;
+  e.enemyType = 7;
+  e.posX = 640.0f;
+  e.posY = 120.0f;
+  e.hp = 50;
+  e.state = 1;
+  e.direction = -1;
+  state.enemies.push_back(e);
+  e.enemyId = 301;
+  e.mask = M_DELETE;
+  state.enemies.push_back(e);
+  ProjectileState pr{};
+  pr.projectileId = 900;
+  pr.mask = PROJECTILE_MASK;
+  pr.ownerId = 2;
+  pr.type = 3;
+  pr.posX = 50.0f;
+  pr.posY = 60.0f;
+  pr.damage = 10;
+  state.projectiles.push_back(pr);
+  return state;
+}
+
+/**
+ * @brief Action of every type with distinctive field values
+ */
+Action Make(ActionType type) {
+  Action a;
+  a.type = type;
+  switch (type) {
+    case ActionType::AUTH:
+      a.data = AuthUDP{4242};
+      break;
+    case ActionType::UP_PRESS:
+    case ActionType::UP_RELEASE:
+    case ActionType::DOWN_PRESS:
+    case ActionType::DOWN_RELEASE:
+    case ActionType::LEFT_PRESS:
+    case ActionType::LEFT_RELEASE:
+    case ActionType::RIGHT_PRESS:
+    case ActionType::RIGHT_RELEASE:
+    case ActionType::FIRE_PRESS:
+    case ActionType::FIRE_RELEASE: {
+      PlayerInput input;
+      input.up = true;
+      input.right = true;
+      input.fire = 2;
+      a.data = input;
+      break;
+    }
+    case ActionType::LOGIN_REQUEST:
+      a.data = LoginReq{"alice", "hash", F_PACKED_STATE};
+      break;
+    case ActionType::LOBBY_CREATE:
+      a.data = LobbyCreate{"room", "alice", "secret", 4, 2};
+      break;
+    case ActionType::LOBBY_JOIN_REQUEST:
+      a.data = LobbyJoinRequest{17, "bob", "secret"};
+      break;
+    case ActionType::LOBBY_LIST_REQUEST:
+      a.data = LobbyListRequest{21};
+      break;
+    case ActionType::PLAYER_READY:
+      a.data = PlayerReady{true};
+      break;
+    case ActionType::LOBBY_LEAVE:
+      a.data = LobbyLeave{22};
+      break;
+    case ActionType::MESSAGE:
+      a.data = Message{17, "alice", "hello"};
+      break;
+    case ActionType::LOBBY_KICK:
+      a.data = LobbyKick{23};
+      break;
+    case ActionType::CLIENT_LEAVE:
+      a.data = ClientLeave{24};
+      break;
+    case ActionType::ASSETS_READY:
+      a.data = AssetsReady{25};
+      break;
+    case ActionType::LEVEL_TRANSITION:
+      a.data = LevelTransition{3};
+      break;
+    case ActionType::FORCE_STATE:
+      a.data = ForceState{8, 2, 150.5f, -20.25f, 2};
+      break;
+    case ActionType::LOGIN_RESPONSE:
+      a.data = LoginResponse{true, 2, 4243, 0, "welcome"};
+      break;
+    case ActionType::LOBBY_JOIN_RESPONSE:
+      a.data = LobbyJoinResponse{
+          true, 17, 2, {{1, true, "alice"}, {2, false, "bob"}}, 0, ""};
+      break;
+    case ActionType::LOBBY_LIST_RESPONSE:
+      a.data = LobbyListResponse{
+          {{17, "room", 2, 4, 1, false, true}, {18, "other", 4, 4, 3, true,
+                                                false}}};
+      break;
+    case ActionType::LOBBY_UPDATE:
+      a.data = LobbyUpdate{"room", 1, false, 4, 2, {{1, true, "alice"}}};
+      break;
+    case ActionType::LOBBY_START:
+      a.data = LobbyStart{5};
+      break;
+    case ActionType::GAME_START:
+      a.data = GameStart{100.0f, 300.0f, 60.5f};
+      break;
+    case ActionType::GAME_END:
+      a.data = GameEnd{true, {{1, "alice", 9000, 1}, {2, "bob", 800, 2}}};
+      break;
+    case ActionType::ERROR_SERVER:
+      a.data = ErrorMsg{404, "lobby not found"};
+      break;
+    case ActionType::GAME_STATE:
+    case ActionType::GAME_STATE_PACKED:
+      a.data = MakeGameState();
+      break;
+    case ActionType::BOSS_SPAWN:
+      a.data = BossSpawn{77, 2, 5000, 1};
+      break;
+    case ActionType::BOSS_UPDATE:
+      a.data = BossUpdate{77, 600.0f, 250.0f, 4200, 2, 3};
+      break;
+    case ActionType::ENEMY_HIT:
+      a.data = EnemyHit{300, 15, 35};
+      break;
+    case ActionType::SEND_MAP: {
+      MapData map{4, 3, 42.0f, {}};
+      for (uint8_t i = 0; i < 12; ++i) map.tiles.push_back(i * 20);
+      a.data = map;
+      break;
+    }
+  }
+  return a;
+}
+
+template <typename T>
+const T* Data(const Event& event) {
+  const T* data = std::get_if<T>(&event.data);
+  CHECK(data != nullptr);
+  return data;
+}
+
+bool Near(float a, float b, float step) { return std::fabs(a - b) <= step; }
+
+void CheckGameState(const GameState& sent, const GAME_STATE& got,
+                    bool packed) {
+  const float posStep = packed ? quant::POS_X_RANGE / 8191 : 0.0f;
+  CHECK_EQ(got.tick, sent.tick);
+  CHECK_EQ(got.baseTick, sent.baseTick);
+  CHECK_EQ(got.players.size(), sent.players.size());
+  for (size_t i = 0; i < got.players.size() && i < sent.players.size(); ++i) {
+    const auto& s = sent.players[i];
+    const auto& g = got.players[i];
+    CHECK_EQ(g.playerId, s.playerId);
+    CHECK_EQ(g.mask, s.mask);
+    CHECK(Near(g.posX, s.posX, posStep));
+    if (s.mask & M_POS_Y) CHECK(Near(g.posY, s.posY, posStep));
+    if (s.mask & M_HP) CHECK_EQ(g.hp, s.hp);
+    if (s.mask & M_SHIELD) CHECK_EQ(g.shield, s.shield);
+    if (s.mask & M_WEAPON) CHECK_EQ(g.weapon, s.weapon);
+    if (s.mask & M_STATE) CHECK_EQ(g.state, s.state);
+    if (s.mask & M_SPRITE) CHECK_EQ(g.sprite, s.sprite);
+    if (s.mask & M_SCORE) CHECK_EQ(g.score, s.score);
+  }
+  CHECK_EQ(got.enemies.size(), sent.enemies.size());
+  for (size_t i = 0; i < got.enemies.size() && i < sent.enemies.size(); ++i) {
+    const auto& s = sent.enemies[i];
+    const auto& g = got.enemies[i];
+    CHECK_EQ(g.enemyId, s.enemyId);
+    CHECK_EQ(g.mask, s.mask);
+    if (s.mask & M_DELETE) continue;
+    CHECK(Near(g.posX, s.posX, posStep));
+    CHECK(Near(g.posY, s.posY, posStep));
+    CHECK_EQ(g.hp, s.hp);
+    CHECK_EQ(g.state, s.state);
+    CHECK_EQ(g.enemyType, s.enemyType);
+    CHECK_EQ(g.direction, s.direction);
+  }
+  CHECK_EQ(got.projectiles.size(), sent.projectiles.size());
+  for (size_t i = 0;
+       i < got.projectiles.size() && i < sent.projectiles.size(); ++i) {
+    const auto& s = sent.projectiles[i];
+    const auto& g = got.projectiles[i];
+    CHECK_EQ(g.projectileId, s.projectileId);
+    CHECK_EQ(g.mask, s.mask);
+    CHECK(Near(g.posX, s.posX, posStep));
+    CHECK(Near(g.posY, s.posY, posStep));
+    CHECK_EQ(g.type, s.type);
+    CHECK_EQ(g.ownerId, s.ownerId);
+    CHECK_EQ(g.damage, s.damage);
+  }
+}
+
+/**
+ * @brief Compare the decoded event with the action it was encoded from
+ */
+void CheckFields(const Action& a, const Event& event) {
+  switch (a.type) {
+    case ActionType::AUTH:
+      if (auto* d = Data<AUTH>(event)) CHECK_EQ(d->playerId, 4242);
+      break;
+    case ActionType::UP_PRESS:
+    case ActionType::UP_RELEASE:
+    case ActionType::DOWN_PRESS:
+    case ActionType::DOWN_RELEASE:
+    case ActionType::LEFT_PRESS:
+    case ActionType::LEFT_RELEASE:
+    case ActionType::RIGHT_PRESS:
+    case ActionType::RIGHT_RELEASE:
+    case ActionType::FIRE_PRESS:
+    case ActionType::FIRE_RELEASE:
+      if (auto* d = Data<PLAYER_INPUT>(event)) {
+        CHECK(d->up && !d->down && !d->left && d->right);
+        CHECK_EQ(d->fire, 2);
+      }
+      break;
+    case ActionType::LOGIN_REQUEST:
+      if (auto* d = Data<LOGIN_REQUEST>(event)) {
+        CHECK_EQ(d->username, "alice");
+        CHECK_EQ(d->password, "hash");
+        CHECK_EQ(d->features, F_PACKED_STATE);
+      }
+      break;
+    case ActionType::LOBBY_CREATE:
+      if (auto* d = Data<LOBBY_CREATE>(event)) {
+        CHECK_EQ(d->lobbyName, "room");
+        CHECK_EQ(d->playerName, "alice");
+        CHECK_EQ(d->password, "secret");
+        CHECK_EQ(d->Maxplayer, 4);
+        CHECK_EQ(d->difficulty, 2);
+      }
+      break;
+    case ActionType::LOBBY_JOIN_REQUEST:
+      if (auto* d = Data<LOBBY_JOIN_REQUEST>(event)) {
+        CHECK_EQ(d->lobbyId, 17);
+        CHECK_EQ(d->name, "bob");
+        CHECK_EQ(d->password, "secret");
+      }
+      break;
+    case ActionType::LOBBY_LIST_REQUEST:
+      if (auto* d = Data<LOBBY_LIST_REQUEST>(event)) {
+        CHECK_EQ(d->playerId, 21);
+      }
+      break;
+    case ActionType::PLAYER_READY:
+      if (auto* d = Data<PLAYER_READY>(event)) CHECK(d->ready);
+      break;
+    case ActionType::LOBBY_LEAVE:
+      if (auto* d = Data<LOBBY_LEAVE>(event)) CHECK_EQ(d->playerId, 22);
+      break;
+    case ActionType::MESSAGE:
+      if (auto* d = Data<MESSAGE>(event)) {
+        CHECK_EQ(d->lobbyId, 17);
+        CHECK_EQ(d->playerName, "alice");
+        CHECK_EQ(d->message, "hello");
+      }
+      break;
+    case ActionType::LOBBY_KICK:
+      if (auto* d = Data<LOBBY_KICK>(event)) CHECK_EQ(d->playerId, 23);
+      break;
+    case ActionType::CLIENT_LEAVE:
+      if (auto* d = Data<CLIENT_LEAVE>(event)) CHECK_EQ(d->playerId, 24);
+      break;
+    case ActionType::ASSETS_READY:
+      if (auto* d = Data<ASSETS_READY>(event)) CHECK_EQ(d->playerId, 25);
+      break;
+    case ActionType::LEVEL_TRANSITION:
+      if (auto* d = Data<LEVEL_TRANSITION>(event)) {
+        CHECK_EQ(d->levelNumber, 3);
+      }
+      break;
+    case ActionType::FORCE_STATE:
+      if (auto* d = Data<FORCE_STATE>(event)) {
+        CHECK_EQ(d->forceId, 8);
+        CHECK_EQ(d->ownerId, 2);
+        CHECK_EQ(d->posX, 150.5f);
+        CHECK_EQ(d->posY, -20.25f);
+        CHECK_EQ(d->state, 2);
+      }
+      break;
+    case ActionType::LOGIN_RESPONSE:
+      if (auto* d = Data<LOGIN_RESPONSE>(event)) {
+        CHECK_EQ(d->success, 1);
+        CHECK_EQ(d->playerId, 2);
+        CHECK_EQ(d->udpPort, 4243);
+        CHECK_EQ(d->errorCode, 0);
+        CHECK_EQ(d->message, "");  // Envoye seulement en cas d'echec
+      }
+      break;
+    case ActionType::LOBBY_JOIN_RESPONSE:
+      if (auto* d = Data<LOBBY_JOIN_RESPONSE>(event)) {
+        CHECK_EQ(d->success, 1);
+        CHECK_EQ(d->lobbyId, 17);
+        CHECK_EQ(d->playerId, 2);
+        CHECK_EQ(d->players.size(), 2u);
+        if (d->players.size() == 2) {
+          CHECK_EQ(d->players[0].playerId, 1);
+          CHECK(d->players[0].ready);
+          CHECK_EQ(d->players[0].username, "alice");
+          CHECK_EQ(d->players[1].playerId, 2);
+          CHECK(!d->players[1].ready);
+          CHECK_EQ(d->players[1].username, "bob");
+        }
+        CHECK_EQ(d->errorCode, 0);
+        CHECK_EQ(d->errorMessage, "");
+      }
+      break;
+    case ActionType::LOBBY_LIST_RESPONSE:
+      if (auto* d = Data<LOBBY_LIST_RESPONSE>(event)) {
+        CHECK_EQ(d->lobbies.size(), 2u);
+        if (d->lobbies.size() == 2) {
+          const Lobbies& l = d->lobbies[1];
+          CHECK_EQ(l.lobbyId, 18);
+          CHECK_EQ(l.name, "other");
+          CHECK_EQ(l.playerCount, 4);
+          CHECK_EQ(l.maxPlayers, 4);
+          CHECK_EQ(l.difficulty, 3);
+          CHECK(l.isStarted);
+          CHECK(!l.hasPassword);
+          CHECK(d->lobbies[0].hasPassword);
+        }
+      }
+      break;
+    case ActionType::LOBBY_UPDATE:
+      if (auto* d = Data<LOBBY_UPDATE>(event)) {
+        CHECK_EQ(d->name, "room");
+        CHECK_EQ(d->hostId, 1);
+        CHECK(!d->asStarted);
+        CHECK_EQ(d->maxPlayers, 4);
+        CHECK_EQ(d->difficulty, 2);
+        CHECK_EQ(d->playerInfo.size(), 1u);
+        if (!d->playerInfo.empty()) {
+          CHECK_EQ(d->playerInfo[0].username, "alice");
+        }
+      }
+      break;
+    case ActionType::LOBBY_START:
+      if (auto* d = Data<LOBBY_START>(event)) CHECK_EQ(d->countdown, 5);
+      break;
+    case ActionType::GAME_START:
+      if (auto* d = Data<GAME_START>(event)) {
+        CHECK_EQ(d->playerSpawnX, 100.0f);
+        CHECK_EQ(d->playerSpawnY, 300.0f);
+        CHECK_EQ(d->scrollSpeed, 60.5f);
+      }
+      break;
+    case ActionType::GAME_END:
+      if (auto* d = Data<GAME_END>(event)) {
+        CHECK_EQ(d->victory, 1);
+        CHECK_EQ(d->scores.size(), 2u);
+        if (d->scores.size() == 2) {
+          CHECK_EQ(d->scores[1].playerId, 2);
+          CHECK_EQ(d->scores[1].playerName, "bob");
+          CHECK_EQ(d->scores[1].score, 800u);
+          CHECK_EQ(d->scores[1].rank, 2);
+        }
+      }
+      break;
+    case ActionType::ERROR_SERVER:
+      if (auto* d = Data<ERROR_EVNT>(event)) {
+        CHECK_EQ(d->errorCode, 404);
+        CHECK_EQ(d->message, "lobby not found");
+      }
+      break;
+    case ActionType::GAME_STATE:
+    case ActionType::GAME_STATE_PACKED:
+      if (auto* d = Data<GAME_STATE>(event)) {
+        CheckGameState(std::get<GameState>(a.data), *d,
+                       a.type == ActionType::GAME_STATE_PACKED);
+      }
+      break;
+    case ActionType::BOSS_SPAWN:
+      if (auto* d = Data<BOSS_SPAWN>(event)) {
+        CHECK_EQ(d->bossId, 77);
+        CHECK_EQ(d->bossType, 2);
+        CHECK_EQ(d->maxHp, 5000);
+        CHECK_EQ(d->phase, 1);
+      }
+      break;
+    case ActionType::BOSS_UPDATE:
+      if (auto* d = Data<BOSS_UPDATE>(event)) {
+        CHECK_EQ(d->bossId, 77);
+        CHECK_EQ(d->posX, 600.0f);
+        CHECK_EQ(d->posY, 250.0f);
+        CHECK_EQ(d->hp, 4200);
+        CHECK_EQ(d->phase, 2);
+        CHECK_EQ(d->action, 3);
+      }
+      break;
+    case ActionType::ENEMY_HIT:
+      if (auto* d = Data<ENEMY_HIT>(event)) {
+        CHECK_EQ(d->enemyId, 300);
+        CHECK_EQ(d->damage, 15);
+        CHECK_EQ(d->hpRemaining, 35);
+      }
+      break;
+    case ActionType::SEND_MAP:
+      if (auto* d = Data<MAP_DATA>(event)) {
+        CHECK_EQ(d->width, 4);
+        CHECK_EQ(d->height, 3);
+        CHECK_EQ(d->scrollSpeed, 42.0f);
+        CHECK(d->tiles == std::get<MapData>(a.data).tiles);
+      }
+      break;
+  }
+}
+
+bool IsUdp(size_t transport) { return transport == 0 || transport == 1; }
+
+/**
+ * @brief Formats whose end is not delimited: a shorter payload is still a
+ * valid message (optional features byte, lists absent at the end, tiles up
+ * to the end of the payload)
+ */
+bool EndsFreely(ActionType type) {
+  return type == ActionType::LOGIN_REQUEST ||
+         type == ActionType::GAME_STATE || type == ActionType::SEND_MAP;
+}
+
+void TestEveryActionRoundTrips() {
+  Encoder encoder;
+  SetupEncoder(encoder);
+  Decoder decoder;
+  SetupDecoder(decoder);
+
+  for (int t = 0; t <= static_cast<int>(ActionType::GAME_STATE_PACKED); ++t) {
+    ActionType type = static_cast<ActionType>(t);
+    Action a = Make(type);
+    size_t transport = UseUdp(type);
+    std::vector<uint8_t> packet =
+        encoder.encode(a, transport, SEQ, ACK, ACK_BITS);
+    CHECK(!packet.empty());
+    if (packet.empty()) continue;
+
+    // GAME_STATE_PACKED est decode en GAME_STATE
+    EventType expected = protocol::packetType(type);
+    CHECK_EQ(packet[0], static_cast<uint8_t>(expected));
+    Event event = decoder.decode(packet);
+    if (expected == EventType::GAME_STATE_PACKED) {
+      expected = EventType::GAME_STATE;
+    }
+    CHECK(event.type == expected);
+    if (event.type != expected) continue;
+    if (IsUdp(transport)) {
+      CHECK_EQ(event.seqNum, SEQ);
+      CHECK_EQ(event.ack, ACK);
+      CHECK_EQ(event.ack_bits, ACK_BITS);
+    }
+    CheckFields(a, event);
+  }
+}
+
+void TestFailedLoginResponse() {
+  Encoder encoder;
+  SetupEncoder(encoder);
+  Decoder decoder;
+  SetupDecoder(decoder);
+
+  Action a;
+  a.type = ActionType::LOGIN_RESPONSE;
+  a.data = LoginResponse{false, 0, 0, 401, "wrong password"};
+  Event event = decoder.decode(encoder.encode(a, 2, 0, 0, 0));
+  if (auto* d = Data<LOGIN_RESPONSE>(event)) {
+    CHECK_EQ(d->success, 0);
+    CHECK_EQ(d->errorCode, 401);
+    CHECK_EQ(d->message, "wrong password");
+  }
+}
+
+void TestTruncatedPacketsAreRejected() {
+  Encoder encoder;
+  SetupEncoder(encoder);
+  Decoder decoder;
+  SetupDecoder(decoder);
+
+  for (int t = 0; t <= static_cast<int>(ActionType::GAME_STATE_PACKED); ++t) {
+    ActionType type = static_cast<ActionType>(t);
+    size_t transport = UseUdp(type);
+    std::vector<uint8_t> packet =
+        encoder.encode(Make(type), transport, SEQ, ACK, ACK_BITS);
+    const size_t header = IsUdp(transport) ? Encoder::UDP_HEADER_SIZE
+                                           : Encoder::TCP_HEADER_SIZE;
+
+    // Longueur d'en-tete corrigee : seul le contenu manque
+    for (size_t size = header; size < packet.size(); ++size) {
+      std::vector<uint8_t> cut(packet.begin(), packet.begin() + size);
+      uint32_t length = static_cast<uint32_t>(size - header);
+      cut[2] = static_cast<uint8_t>(length >> 24);
+      cut[3] = static_cast<uint8_t>(length >> 16);
+      cut[4] = static_cast<uint8_t>(length >> 8);
+      cut[5] = static_cast<uint8_t>(length);
+      if (EndsFreely(type)) continue;
+      CHECK(std::holds_alternative<std::monostate>(decoder.decode(cut).data));
+    }
+
+    // Longueur d'en-tete intacte : toujours rejete
+    for (size_t size = 0; size < packet.size(); ++size) {
+      std::vector<uint8_t> cut(packet.begin(), packet.begin() + size);
+      CHECK(std::holds_alternative<std::monostate>(decoder.decode(cut).data));
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  TestEveryActionRoundTrips();
+  TestFailedLoginResponse();
+  TestTruncatedPacketsAreRejected();
+  return check::Result();
+}
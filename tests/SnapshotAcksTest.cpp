@@ -0,0 +1,162 @@
+#include "SnapshotHistory.hpp"
+
+#include <cstdint>
+#include <memory>
+
+#include "Check.hpp"
+
+namespace {
+
+std::shared_ptr<const GameState> Snapshot(uint32_t tick) {
+  auto state = std::make_shared<GameState>();
+  state->tick = tick;
+  state->baseTick = tick;
+  return state;
+}
+
+void TestHistory() {
+  SnapshotHistory history;
+  CHECK(history.Find(0) == nullptr);
+  auto first = Snapshot(3);
+  history.Push(3, first);
+  CHECK(history.Find(3) == first);
+  CHECK(history.Find(3 + SnapshotHistory::CAPACITY) == nullptr);
+
+  // Meme case du ring : le tick le plus recent remplace l'ancien
+  history.Push(3 + SnapshotHistory::CAPACITY,
+               Snapshot(3 + SnapshotHistory::CAPACITY));
+  CHECK(history.Find(3) == nullptr);
+  CHECK(history.Find(3 + SnapshotHistory::CAPACITY) != nullptr);
+
+  history.Clear();
+  CHECK(history.Find(3 + SnapshotHistory::CAPACITY) == nullptr);
+}
+
+void TestNoBaseline() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  CHECK(!acks.HasBaseline());
+  CHECK(acks.Baseline(history) == nullptr);
+
+  // Ack d'un numero jamais envoye
+  acks.RecordSent(1, 10);
+  acks.Acknowledge(5, 0);
+  CHECK(!acks.HasBaseline());
+}
+
+void TestNewestAckedTick() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  for (uint16_t seq = 1; seq <= 3; ++seq) {
+    uint32_t tick = 9 + seq;
+    history.Push(tick, Snapshot(tick));
+    acks.RecordSent(seq, tick);
+  }
+
+  // 3 et 1 recus, 2 perdu
+  acks.Acknowledge(3, 0b10);
+  CHECK(acks.HasBaseline());
+  CHECK_EQ(acks.BaselineTick(), 12u);
+  CHECK(acks.Baseline(history) == history.Find(12));
+}
+
+void TestLostAckFallsBackToOlderBaseline() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  for (uint16_t seq = 1; seq <= 3; ++seq) {
+    uint32_t tick = 9 + seq;
+    history.Push(tick, Snapshot(tick));
+    acks.RecordSent(seq, tick);
+  }
+
+  // Le datagramme 3 est perdu : le client n'acquitte que 2 et 1
+  acks.Acknowledge(2, 0b1);
+  CHECK_EQ(acks.BaselineTick(), 11u);
+  CHECK(acks.Baseline(history) == history.Find(11));
+
+  // Un ack en retard ne fait pas reculer la reference
+  acks.Acknowledge(1, 0);
+  CHECK_EQ(acks.BaselineTick(), 11u);
+}
+
+void TestBaselineLeftHistory() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  history.Push(10, Snapshot(10));
+  acks.RecordSent(1, 10);
+  acks.Acknowledge(1, 0);
+  CHECK(acks.Baseline(history) != nullptr);
+
+  // Le snapshot du tick acquitte est ecrase : retour a un etat complet
+  uint32_t later = 10 + SnapshotHistory::CAPACITY;
+  history.Push(later, Snapshot(later));
+  CHECK(acks.HasBaseline());
+  CHECK(acks.Baseline(history) == nullptr);
+}
+
+void TestCutDownView() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  auto snapshot = Snapshot(10);
+  auto view = Snapshot(10);
+  history.Push(10, snapshot);
+  acks.RecordSent(1, 10, view);
+  acks.Acknowledge(1, 0);
+  CHECK(acks.Baseline(history) == view);
+
+  history.Clear();
+  CHECK(acks.Baseline(history) == nullptr);
+}
+
+void TestRecordDelivered() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  history.Push(20, Snapshot(20));
+  history.Push(21, Snapshot(21));
+  acks.RecordDelivered(21);
+  CHECK_EQ(acks.BaselineTick(), 21u);
+  acks.RecordDelivered(20);
+  CHECK_EQ(acks.BaselineTick(), 21u);
+  CHECK(acks.Baseline(history) == history.Find(21));
+}
+
+void TestAckOutsideBitfield() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  history.Push(10, Snapshot(10));
+  acks.RecordSent(100, 10);
+
+  // 33 numeros plus loin : hors des 32 bits de l'ack
+  acks.Acknowledge(133, 0xFFFFFFFF);
+  CHECK(!acks.HasBaseline());
+  acks.Acknowledge(132, 0x80000000);
+  CHECK_EQ(acks.BaselineTick(), 10u);
+}
+
+void TestSequenceWrapAround() {
+  SnapshotHistory history;
+  SnapshotAcks acks;
+  history.Push(70, Snapshot(70));
+  history.Push(71, Snapshot(71));
+  acks.RecordSent(0xFFFF, 70);
+  acks.RecordSent(0, 71);
+
+  acks.Acknowledge(0, 0b1);
+  CHECK_EQ(acks.BaselineTick(), 71u);
+  CHECK(acks.Baseline(history) == history.Find(71));
+}
+
+}  // namespace
+
+int main() {
+  TestHistory();
+  TestNoBaseline();
+  TestNewestAckedTick();
+  TestLostAckFallsBackToOlderBaseline();
+  TestBaselineLeftHistory();
+  TestCutDownView();
+  TestRecordDelivered();
+  TestAckOutsideBitfield();
+  TestSequenceWrapAround();
+  return check::Result();
+}
@@ -0,0 +1,192 @@
+#include "network/SnapshotReceiver.hpp"
+
+#include <cstdint>
+
+#include "Check.hpp"
+#include "network/DataMask.hpp"
+
+namespace {
+
+GAME_STATE::PlayerState Player(uint16_t id, uint16_t mask, float x, float y,
+                               uint8_t hp) {
+  GAME_STATE::PlayerState p{};
+  p.playerId = id;
+  p.mask = mask;
+  p.posX = x;
+  p.posY = y;
+  p.hp = hp;
+  return p;
+}
+
+GAME_STATE::EnemyState Enemy(uint16_t id, uint16_t mask, float x) {
+  GAME_STATE::EnemyState e{};
+  e.enemyId = id;
+  e.mask = mask;
+  e.posX = x;
+  return e;
+}
+
+constexpr uint16_t ALL = M_POS_X | M_POS_Y | M_HP;
+
+GAME_STATE Full(uint32_t tick) {
+  GAME_STATE state;
+  state.tick = tick;
+  state.baseTick = tick;
+  state.players = {Player(1, ALL, 10.0f, 20.0f, 3),
+                   Player(2, ALL, 30.0f, 40.0f, 2)};
+  state.enemies = {Enemy(7, M_POS_X, 500.0f), Enemy(8, M_POS_X, 600.0f)};
+  return state;
+}
+
+const GAME_STATE::PlayerState* FindPlayer(const GAME_STATE& state,
+                                          uint16_t id) {
+  for (const auto& p : state.players) {
+    if (p.playerId == id) return &p;
+  }
+  return nullptr;
+}
+
+const GAME_STATE::EnemyState* FindEnemy(const GAME_STATE& state,
+                                        uint16_t id) {
+  for (const auto& e : state.enemies) {
+    if (e.enemyId == id) return &e;
+  }
+  return nullptr;
+}
+
+void TestFullState() {
+  SnapshotReceiver receiver;
+  GAME_STATE state = Full(10);
+  CHECK(receiver.Receive(state) == SnapshotReceiver::Result::DISPLAY);
+  CHECK_EQ(state.players.size(), 2u);
+  CHECK_EQ(state.enemies.size(), 2u);
+  CHECK_EQ(state.baseTick, 10u);
+}
+
+void TestDeltaAgainstKnownBaseline() {
+  SnapshotReceiver receiver;
+  GAME_STATE full = Full(10);
+  receiver.Receive(full);
+
+  // Joueur 1 bouge en X, ennemi 8 detruit, ennemi 9 apparait
+  GAME_STATE delta;
+  delta.tick = 11;
+  delta.baseTick = 10;
+  delta.players = {Player(1, M_POS_X, 15.0f, 0.0f, 0)};
+  delta.enemies = {Enemy(8, M_DELETE, 0.0f), Enemy(9, M_POS_X, 700.0f)};
+  CHECK(receiver.Receive(delta) == SnapshotReceiver::Result::DISPLAY);
+  CHECK_EQ(delta.baseTick, 11u);
+
+  const auto* p1 = FindPlayer(delta, 1);
+  CHECK(p1 != nullptr);
+  if (p1) {
+    CHECK_EQ(p1->posX, 15.0f);
+    CHECK_EQ(p1->posY, 20.0f);
+    CHECK_EQ(p1->hp, 3);
+    CHECK_EQ(p1->mask, ALL);
+  }
+  const auto* p2 = FindPlayer(delta, 2);
+  CHECK(p2 != nullptr && p2->posX == 30.0f);
+
+  CHECK(FindEnemy(delta, 7) != nullptr);
+  CHECK(FindEnemy(delta, 9) != nullptr);
+  const auto* e8 = FindEnemy(delta, 8);
+  CHECK(e8 != nullptr && e8->mask == M_DELETE);
+}
+
+void TestDeltaAgainstOlderBaseline() {
+  SnapshotReceiver receiver;
+  GAME_STATE full = Full(10);
+  receiver.Receive(full);
+  GAME_STATE next = Full(11);
+  next.baseTick = 10;
+  next.players = {Player(2, M_DELETE, 0.0f, 0.0f, 0)};
+  next.enemies.clear();
+  CHECK(receiver.Receive(next) == SnapshotReceiver::Result::DISPLAY);
+
+  // L'ack de 11 s'est perdu : le serveur diffe encore contre 10, ou le
+  // joueur 2 existe, et repete donc sa suppression
+  GAME_STATE delta;
+  delta.tick = 12;
+  delta.baseTick = 10;
+  delta.players = {Player(2, M_DELETE, 0.0f, 0.0f, 0),
+                   Player(1, M_HP, 0.0f, 0.0f, 1)};
+  CHECK(receiver.Receive(delta) == SnapshotReceiver::Result::DISPLAY);
+  CHECK(FindPlayer(delta, 2) == nullptr);
+  const auto* p1 = FindPlayer(delta, 1);
+  CHECK(p1 != nullptr && p1->hp == 1 && p1->posX == 10.0f);
+}
+
+void TestUnknownBaseline() {
+  SnapshotReceiver receiver;
+  GAME_STATE full = Full(10);
+  receiver.Receive(full);
+
+  GAME_STATE delta;
+  delta.tick = 12;
+  delta.baseTick = 11;
+  delta.players = {Player(1, M_POS_X, 99.0f, 0.0f, 0)};
+  CHECK(receiver.Receive(delta) ==
+        SnapshotReceiver::Result::MISSING_BASELINE);
+  CHECK_EQ(delta.tick, 12u);
+  CHECK_EQ(delta.baseTick, 11u);
+
+  // Rien n'a ete stocke : un delta suivant contre 10 s'affiche
+  GAME_STATE next;
+  next.tick = 13;
+  next.baseTick = 10;
+  CHECK(receiver.Receive(next) == SnapshotReceiver::Result::DISPLAY);
+  CHECK_EQ(next.players.size(), 2u);
+}
+
+void TestStale() {
+  SnapshotReceiver receiver;
+  GAME_STATE newer = Full(20);
+  receiver.Receive(newer);
+
+  GAME_STATE duplicate = Full(20);
+  CHECK(receiver.Receive(duplicate) == SnapshotReceiver::Result::STALE);
+
+  // Arrive en retard : pas affiche, mais utilisable comme reference
+  GAME_STATE older = Full(19);
+  older.players = {Player(5, ALL, 1.0f, 2.0f, 3)};
+  CHECK(receiver.Receive(older) == SnapshotReceiver::Result::STALE);
+
+  GAME_STATE delta;
+  delta.tick = 21;
+  delta.baseTick = 19;
+  CHECK(receiver.Receive(delta) == SnapshotReceiver::Result::DISPLAY);
+  CHECK(FindPlayer(delta, 5) != nullptr);
+  const auto* p1 = FindPlayer(delta, 1);
+  CHECK(p1 != nullptr && p1->mask == M_DELETE);
+}
+
+void TestReset() {
+  SnapshotReceiver receiver;
+  GAME_STATE full = Full(30);
+  receiver.Receive(full);
+  receiver.Reset();
+
+  GAME_STATE delta;
+  delta.tick = 31;
+  delta.baseTick = 30;
+  CHECK(receiver.Receive(delta) ==
+        SnapshotReceiver::Result::MISSING_BASELINE);
+
+  // Une nouvelle partie peut repartir d'un tick plus petit
+  GAME_STATE restart = Full(1);
+  CHECK(receiver.Receive(restart) == SnapshotReceiver::Result::DISPLAY);
+  CHECK_EQ(restart.players.size(), 2u);
+}
+
+}  // namespace
+
+int main() {
+  TestFullState();
+  TestDeltaAgainstKnownBaseline();
+  TestDeltaAgainstOlderBaseline();
+  TestUnknownBaseline();
+  TestStale();
+  TestReset();
+  return check::Result();
+}
@@ -0,0 +1,387 @@
+/**
+ * @file DecodeBench.cpp
+ * @brief Decoder throughput and robustness over a corpus of packets
+ *
+ * decode_bench <corpus> [iterations]
+ *   Checks that every packet of the corpus decodes, feeds the decoder every
+ *   truncation and random mutations of each packet, then measures the decode
+ *   throughput. Build with -fsanitize=address,undefined to fuzz for real.
+ * decode_bench --generate <corpus> [reps]
+ *   Writes a corpus of random actions of every type with the real encoder.
+ *
+ * A corpus is a sequence of packets, each prefixed by its size as a
+ * little-endian uint32.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "network/Action.hpp"
+#include "network/DecodeFunc.hpp"
+#include "network/Decoder.hpp"
+#include "network/EncodeFunc.hpp"
+#include "network/Encoder.hpp"
+
+namespace {
+
+using Packet = std::vector<uint8_t>;
+
+bool ReadCorpus(const std::string& path, std::vector<Packet>& packets) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  uint8_t size[4];
+  while (in.read(reinterpret_cast<char*>(size), 4)) {
+    uint32_t n = size[0] | (size[1] << 8) | (size[2] << 16) |
+                 (static_cast<uint32_t>(size[3]) << 24);
+    Packet packet(n);
+    if (!in.read(reinterpret_cast<char*>(packet.data()), n)) return false;
+    packets.push_back(std::move(packet));
+  }
+  return in.eof();
+}
+
+bool WriteCorpus(const std::string& path, const std::vector<Packet>& packets) {
+  std::ofstream out(path, std::ios::binary);
+  for (const Packet& packet : packets) {
+    uint32_t n = static_cast<uint32_t>(packet.size());
+    const char size[4] = {static_cast<char>(n), static_cast<char>(n >> 8),
+                          static_cast<char>(n >> 16),
+                          static_cast<char>(n >> 24)};
+    out.write(size, 4);
+    out.write(reinterpret_cast<const char*>(packet.data()), packet.size());
+  }
+  return static_cast<bool>(out);
+}
+
+// Generateur deterministe : mt19937 est le meme partout, pas les
+// distributions de <random>
+class Random {
+ public:
+  explicit Random(uint32_t seed) : rng(seed) {}
+  uint32_t Next() { return static_cast<uint32_t>(rng()); }
+  uint32_t Below(uint32_t n) { return Next() % n; }
+  float Coord() { return static_cast<float>(Below(12000)) / 10.0f - 200.0f; }
+  std::string Text() {
+    std::string s(Below(20), 'a');
+    for (char& c : s) c = static_cast<char>('a' + Below(26));
+    return s;
+  }
+
+ private:
+  std::mt19937 rng;
+};
+
+GameState RandomGameState(Random& r) {
+  GameState g;
+  g.tick = r.Below(100000);
+  g.baseTick = g.tick - r.Below(50);
+  for (uint32_t n = r.Below(5); n > 0; --n) {
+    PlayerState p{};
+    p.playerId = static_cast<uint16_t>(r.Below(999));
+    p.mask = static_cast<uint16_t>(r.Next() & 0x0FFF);
+    p.posX = r.Coord();
+    p.posY = r.Coord();
+    p.hp = static_cast<uint8_t>(r.Below(256));
+    p.shield = static_cast<uint8_t>(r.Below(9));
+    p.weapon = static_cast<uint8_t>(r.Below(9));
+    p.state = static_cast<uint8_t>(r.Below(9));
+    p.sprite = static_cast<uint8_t>(r.Below(9));
+    p.score = r.Below(99999);
+    g.players.push_back(p);
+  }
+  for (uint32_t n = r.Below(30); n > 0; --n) {
+    EnemyState e{};
+    e.enemyId = static_cast<uint16_t>(r.Below(999));
+    e.mask = static_cast<uint16_t>(r.Next() & 0x0FFF);
+    e.posX = r.Coord();
+    e.posY = r.Coord();
+    e.hp = static_cast<uint8_t>(r.Below(256));
+    e.state = static_cast<uint8_t>(r.Below(9));
+    e.enemyType = static_cast<uint8_t>(r.Below(99));
+    e.direction = static_cast<int8_t>(static_cast<int>(r.Below(3)) - 1);
+    g.enemies.push_back(e);
+  }
+  for (uint32_t n = r.Below(30); n > 0; --n) {
+    ProjectileState pr{};
+    pr.projectileId = static_cast<uint16_t>(r.Below(999));
+    pr.mask = static_cast<uint16_t>(r.Next() & 0x0FFF);
+    pr.posX = r.Coord();
+    pr.posY = r.Coord();
+    pr.velX = r.Coord();
+    pr.velY = r.Coord();
+    pr.type = static_cast<uint8_t>(r.Below(9));
+    pr.ownerId = static_cast<uint16_t>(r.Below(999));
+    pr.damage = static_cast<uint8_t>(r.Below(9));
+    g.projectiles.push_back(pr);
+  }
+  return g;
+}
+
+std::vector<LobbyPlayer> RandomPlayers(Random& r) {
+  std::vector<LobbyPlayer> players(r.Below(5));
+  for (auto& p : players) {
+    p = {static_cast<uint16_t>(r.Below(999)), r.Below(2) == 1, r.Text()};
+  }
+  return players;
+}
+
+Action RandomAction(ActionType type, Random& r) {
+  auto u8 = [&](uint32_t n) { return static_cast<uint8_t>(r.Below(n)); };
+  auto u16 = [&](uint32_t n) { return static_cast<uint16_t>(r.Below(n)); };
+  auto flag = [&]() { return r.Below(2) == 1; };
+
+  Action a;
+  a.type = type;
+  switch (type) {
+    case ActionType::AUTH:
+      a.data = AuthUDP{u16(65535)};
+      break;
+    case ActionType::UP_PRESS:
+    case ActionType::UP_RELEASE:
+    case ActionType::DOWN_PRESS:
+    case ActionType::DOWN_RELEASE:
+    case ActionType::LEFT_PRESS:
+    case ActionType::LEFT_RELEASE:
+    case ActionType::RIGHT_PRESS:
+    case ActionType::RIGHT_RELEASE:
+    case ActionType::FIRE_PRESS:
+    case ActionType::FIRE_RELEASE: {
+      PlayerInput input;
+      input.up = flag();
+      input.down = flag();
+      input.left = flag();
+      input.right = flag();
+      input.fire = u8(3);
+      a.data = input;
+      break;
+    }
+    case ActionType::LOGIN_REQUEST:
+      a.data = LoginReq{r.Text(), r.Text(), u8(2)};
+      break;
+    case ActionType::LOBBY_CREATE:
+      a.data = LobbyCreate{r.Text(), r.Text(), r.Text(), u8(5), u8(4)};
+      break;
+    case ActionType::LOBBY_JOIN_REQUEST:
+      a.data = LobbyJoinRequest{u16(999), r.Text(), r.Text()};
+      break;
+    case ActionType::LOBBY_LIST_REQUEST:
+      a.data = LobbyListRequest{u16(999)};
+      break;
+    case ActionType::PLAYER_READY:
+      a.data = PlayerReady{flag()};
+      break;
+    case ActionType::LOBBY_LEAVE:
+      a.data = LobbyLeave{u16(999)};
+      break;
+    case ActionType::MESSAGE:
+      a.data = Message{u16(999), r.Text(), r.Text()};
+      break;
+    case ActionType::LOBBY_KICK:
+      a.data = LobbyKick{u16(999)};
+      break;
+    case ActionType::CLIENT_LEAVE:
+      a.data = ClientLeave{u16(999)};
+      break;
+    case ActionType::ASSETS_READY:
+      a.data = AssetsReady{u16(999)};
+      break;
+    case ActionType::LEVEL_TRANSITION:
+      a.data = LevelTransition{u8(9)};
+      break;
+    case ActionType::FORCE_STATE:
+      a.data = ForceState{u16(999), u16(999), r.Coord(), r.Coord(), u8(3)};
+      break;
+    case ActionType::LOGIN_RESPONSE:
+      a.data = LoginResponse{flag(), u16(999), u16(9999), u16(99), r.Text()};
+      break;
+    case ActionType::LOBBY_JOIN_RESPONSE:
+      a.data = LobbyJoinResponse{flag(),          u16(999), u16(999),
+                                 RandomPlayers(r), u16(99),  r.Text()};
+      break;
+    case ActionType::LOBBY_LIST_RESPONSE: {
+      LobbyListResponse list;
+      for (uint32_t n = r.Below(6); n > 0; --n) {
+        list.lobbies.push_back({u16(999), r.Text(), u8(4), u8(4), u8(3),
+                                flag(), flag()});
+      }
+      a.data = list;
+      break;
+    }
+    case ActionType::LOBBY_UPDATE:
+      a.data = LobbyUpdate{r.Text(), u16(999), flag(),
+                           u8(4),    u8(3),    RandomPlayers(r)};
+      break;
+    case ActionType::LOBBY_START:
+      a.data = LobbyStart{u8(9)};
+      break;
+    case ActionType::GAME_START:
+      a.data = GameStart{r.Coord(), r.Coord(), r.Coord()};
+      break;
+    case ActionType::GAME_END: {
+      GameEnd end{flag(), {}};
+      for (uint32_t n = r.Below(5); n > 0; --n) {
+        end.scores.push_back({u16(999), r.Text(), r.Next(), u8(4)});
+      }
+      a.data = end;
+      break;
+    }
+    case ActionType::ERROR_SERVER:
+      a.data = ErrorMsg{u16(999), r.Text()};
+      break;
+    case ActionType::GAME_STATE:
+    case ActionType::GAME_STATE_PACKED:
+      a.data = RandomGameState(r);
+      break;
+    case ActionType::BOSS_SPAWN:
+      a.data = BossSpawn{u16(999), u8(9), u16(9999), u8(4)};
+      break;
+    case ActionType::BOSS_UPDATE:
+      a.data = BossUpdate{u16(999), r.Coord(), r.Coord(),
+                          u16(9999), u8(4),    u8(4)};
+      break;
+    case ActionType::ENEMY_HIT:
+      a.data = EnemyHit{u16(999), u8(99), u16(999)};
+      break;
+    case ActionType::SEND_MAP: {
+      MapData map{u16(99), u16(99), r.Coord(), {}};
+      for (uint32_t n = r.Below(300); n > 0; --n) map.tiles.push_back(u8(256));
+      a.data = map;
+      break;
+    }
+  }
+  return a;
+}
+
+int Generate(const std::string& path, int reps) {
+  Encoder encoder;
+  SetupEncoder(encoder);
+  Random r(42);
+  std::vector<Packet> packets;
+  for (int rep = 0; rep < reps; ++rep) {
+    for (int t = 0; t <= static_cast<int>(ActionType::GAME_STATE_PACKED);
+         ++t) {
+      ActionType type = static_cast<ActionType>(t);
+      Action a = RandomAction(type, r);
+      uint16_t seq = static_cast<uint16_t>(r.Next());
+      uint16_t ack = static_cast<uint16_t>(r.Next());
+      Packet packet = encoder.encode(a, UseUdp(type), seq, ack, r.Next());
+      if (!packet.empty()) packets.push_back(std::move(packet));
+    }
+  }
+  if (!WriteCorpus(path, packets)) {
+    std::cerr << "cannot write " << path << std::endl;
+    return 1;
+  }
+  std::cout << packets.size() << " packets written to " << path << std::endl;
+  return 0;
+}
+
+bool Decoded(const Event& event) {
+  return !std::holds_alternative<std::monostate>(event.data);
+}
+
+/**
+ * @brief Decode every truncation and random mutations of each packet; the
+ * decoder must reject or decode them without reading out of bounds
+ */
+size_t Fuzz(Decoder& decoder, const std::vector<Packet>& packets) {
+  Random r(1);
+  size_t inputs = 0;
+  for (const Packet& packet : packets) {
+    const size_t header = packet.size() >= 2 && (packet[1] & 0x0A)
+                              ? Encoder::UDP_HEADER_SIZE
+                              : Encoder::TCP_HEADER_SIZE;
+
+    // Troncatures, avec la longueur d'en-tete corrigee ou non
+    for (size_t size = 0; size < packet.size(); ++size) {
+      Packet cut(packet.begin(), packet.begin() + size);
+      decoder.decode(cut);
+      if (size >= header) {
+        uint32_t length = static_cast<uint32_t>(size - header);
+        cut[2] = static_cast<uint8_t>(length >> 24);
+        cut[3] = static_cast<uint8_t>(length >> 16);
+        cut[4] = static_cast<uint8_t>(length >> 8);
+        cut[5] = static_cast<uint8_t>(length);
+        decoder.decode(cut);
+      }
+      inputs += 2;
+    }
+
+    // Octets de la charge utile remplaces au hasard
+    size_t begin = packet.size() > Encoder::UDP_HEADER_SIZE
+                       ? Encoder::UDP_HEADER_SIZE
+                       : 0;
+    if (packet.size() == begin) continue;
+    for (int m = 0; m < 50; ++m) {
+      Packet mutated = packet;
+      for (uint32_t flips = 1 + r.Below(4); flips > 0; --flips) {
+        size_t at = begin + r.Below(static_cast<uint32_t>(packet.size() -
+                                                          begin));
+        mutated[at] = static_cast<uint8_t>(r.Next());
+      }
+      decoder.decode(mutated);
+      inputs++;
+    }
+  }
+  return inputs;
+}
+
+int Run(const std::string& path, int iterations) {
+  std::vector<Packet> packets;
+  if (!ReadCorpus(path, packets) || packets.empty()) {
+    std::cerr << "cannot read corpus " << path << std::endl;
+    return 1;
+  }
+  Decoder decoder;
+  SetupDecoder(decoder);
+
+  size_t bytes = 0;
+  size_t rejected = 0;
+  for (const Packet& packet : packets) {
+    bytes += packet.size();
+    if (!Decoded(decoder.decode(packet))) rejected++;
+  }
+  std::cout << packets.size() << " packets, " << bytes << " bytes, "
+            << rejected << " rejected" << std::endl;
+
+  std::cout << Fuzz(decoder, packets) << " fuzzed inputs decoded"
+            << std::endl;
+
+  using Clock = std::chrono::steady_clock;
+  uint64_t checksum = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (const Packet& packet : packets) {
+      checksum += decoder.decode(packet).seqNum;
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  if (iterations > 0 && seconds > 0) {
+    double total = static_cast<double>(iterations);
+    std::cout << total * packets.size() / seconds / 1e6 << " Mpackets/s, "
+              << total * bytes / seconds / 1e6 << " MB/s (checksum "
+              << checksum % 1000 << ")" << std::endl;
+  }
+  return rejected == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && std::string(argv[1]) == "--generate") {
+    return Generate(argv[2], argc >= 4 ? std::atoi(argv[3]) : 8);
+  }
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <corpus> [iterations]\n"
+              << "       " << argv[0] << " --generate <corpus> [reps]"
+              << std::endl;
+    return 1;
+  }
+  return Run(argv[1], argc >= 3 ? std::atoi(argv[2]) : 200);
+}